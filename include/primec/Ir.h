@@ -7,7 +7,7 @@
 namespace primec {
 
 constexpr uint32_t IrSchemaMagic = 0x50534952u; // "PSIR"
-constexpr uint32_t IrSchemaVersion = 23u;
+constexpr uint32_t IrSchemaVersion = 26u;
 constexpr uint32_t IrSchemaMinimumSupportedVersion = IrSchemaVersion;
 constexpr uint32_t IrSchemaMaximumSupportedVersion = IrSchemaVersion;
 
@@ -124,8 +124,65 @@ enum class IrOpcode : uint8_t {
   HeapFree,
   HeapRealloc,
   FileWriteStringDynamic,
+  FileReadBytes,
+  FileWriteBytes,
+  FileMapBytes,
+  MathUnaryF32,
+  MathUnaryF64,
+  MathBinaryF32,
+  MathBinaryF64,
 };
 
+// Immediate of the Math* opcodes. MathUnary* applies any function but Pow to
+// the value on top of the stack; MathBinary* only takes Pow (base below
+// exponent).
+enum class IrMathFunction : uint8_t {
+  Sqrt = 0,
+  Sin,
+  Cos,
+  Tan,
+  Exp,
+  Exp2,
+  Log,
+  Log2,
+  Log10,
+  Pow,
+};
+
+inline bool isValidIrMathFunctionImm(IrOpcode op, uint64_t imm) {
+  if (imm > static_cast<uint64_t>(IrMathFunction::Pow)) {
+    return false;
+  }
+  const bool isPow = imm == static_cast<uint64_t>(IrMathFunction::Pow);
+  return (op == IrOpcode::MathBinaryF32 || op == IrOpcode::MathBinaryF64) ? isPow : !isPow;
+}
+
+inline const char *irMathFunctionName(IrMathFunction fn) {
+  switch (fn) {
+    case IrMathFunction::Sqrt:
+      return "sqrt";
+    case IrMathFunction::Sin:
+      return "sin";
+    case IrMathFunction::Cos:
+      return "cos";
+    case IrMathFunction::Tan:
+      return "tan";
+    case IrMathFunction::Exp:
+      return "exp";
+    case IrMathFunction::Exp2:
+      return "exp2";
+    case IrMathFunction::Log:
+      return "log";
+    case IrMathFunction::Log2:
+      return "log2";
+    case IrMathFunction::Log10:
+      return "log10";
+    case IrMathFunction::Pow:
+      return "pow";
+  }
+  return "";
+}
+
 enum class IrStructFieldCategory : uint8_t {
   Default = 0,
   Pod,
@@ -28,6 +28,8 @@ struct IrBackendEmitOptions {
   std::string outputPath;
   std::string inputPath;
   std::vector<std::string> programArgs;
+  VmEngineMode vmEngine = VmEngineMode::Checked;
+  NativeCodegenMode nativeCodegen = NativeCodegenMode::Stack;
 };
 
 struct IrBackendEmitResult {
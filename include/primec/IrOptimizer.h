@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "primec/Ir.h"
+
+namespace primec {
+
+constexpr uint32_t IrOptimizationMaxLevel = 2;
+
+struct IrOptimizationPassStats {
+  std::string_view name;
+  size_t runs = 0;
+  size_t rewrites = 0;
+  size_t instructionsRemoved = 0;
+};
+
+struct IrOptimizationReport {
+  uint32_t level = 0;
+  size_t rounds = 0;
+  size_t instructionsBefore = 0;
+  size_t instructionsAfter = 0;
+  // Set when a function could not be lowered to virtual-register form; the
+  // module keeps whatever the completed passes produced.
+  std::string stoppedReason;
+  std::vector<IrOptimizationPassStats> passes;
+};
+
+// Runs the scalar optimizer over the block virtual-register form of each
+// function and writes the result back to stack IR. Level 0 leaves the module
+// untouched, level 1 runs every pass once, and level 2 repeats the pipeline
+// until it stops shrinking the module. Passes only rewrite locals that no
+// pointer can reach, so pointer-visible state is left alone.
+bool optimizeIrModule(IrModule &module, uint32_t level, IrOptimizationReport &report, std::string &error);
+
+} // namespace primec
@@ -20,6 +20,7 @@ enum class IrPreparationPhaseOwnership {
   IrPreparationLoweredIr,
   IrPreparationValidatedIr,
   IrPreparationInlinedIr,
+  IrPreparationOptimizedIr,
   CompilerAstStorage,
 };
 
@@ -48,6 +49,7 @@ enum class IrPreparationFailureStage {
   Lowering,
   Validation,
   Inlining,
+  Optimization,
 };
 
 struct IrPreparationFailure {
@@ -40,6 +40,7 @@ struct IrVirtualRegisterBlock {
 struct IrVirtualRegisterFunction {
   std::string name;
   IrExecutionMetadata metadata;
+  uint32_t parameterCount = 0;
   std::vector<IrLocalDebugSlot> localDebugSlots;
   std::vector<IrVirtualRegisterBlock> blocks;
   uint32_t nextVirtualRegister = 0;
@@ -54,7 +55,19 @@ struct IrVirtualRegisterModule {
 };
 
 bool lowerIrModuleToBlockVirtualRegisters(const IrModule &module, IrVirtualRegisterModule &out, std::string &error);
+// Lowers a single function; `module` supplies call-target arities. Lets a
+// consumer fall back per function instead of rejecting the whole module.
+// The caller's arguments are already on the stack at entry, so the first
+// block's entry registers hold the function's parameters, first at index 0.
+bool lowerIrFunctionToBlockVirtualRegisters(const IrModule &module,
+                                            size_t functionIndex,
+                                            IrVirtualRegisterFunction &out,
+                                            std::string &error);
 
+// Concatenates block instructions back into stack IR. Jump targets are
+// rewritten from each block's original startInstructionIndex to its lifted
+// position, so passes may drop instructions (or empty whole blocks) without
+// patching branch immediates themselves.
 bool liftBlockVirtualRegistersToIrModule(const IrVirtualRegisterModule &virtualModule, IrModule &out, std::string &error);
 
 } // namespace primec
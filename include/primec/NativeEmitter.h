@@ -16,6 +16,7 @@ struct NativeEmitterFunctionInstrumentation {
   uint64_t valueStackPopCount = 0;
   uint64_t spillCount = 0;
   uint64_t reloadCount = 0;
+  bool registerAllocated = false;
 };
 
 struct NativeEmitterInstrumentation {
@@ -25,6 +26,7 @@ struct NativeEmitterInstrumentation {
   uint64_t totalValueStackPopCount = 0;
   uint64_t totalSpillCount = 0;
   uint64_t totalReloadCount = 0;
+  uint64_t registerAllocatedFunctionCount = 0;
 };
 
 struct NativeEmitterOptimizationInstrumentation {
@@ -43,6 +45,10 @@ struct NativeEmitterOptimizationInstrumentation {
 
 struct NativeEmitterOptions {
   bool enableRegisterCache = true;
+  // Keeps IR values in physical registers across basic blocks using the
+  // linear-scan allocation of the block virtual-register form. Functions
+  // that cannot be lowered to that form keep the stack-machine codegen.
+  bool enableRegisterAllocation = false;
 };
 
 class NativeEmitter {
@@ -9,6 +9,8 @@
 
 namespace primec {
 enum class DebugJsonSnapshotMode { None, Stop, All };
+enum class VmEngineMode { Checked, Fast };
+enum class NativeCodegenMode { Stack, RegisterAllocated };
 
 struct Options {
   std::string emitKind;
@@ -27,6 +29,10 @@ struct Options {
   std::string outDir = ".";
   std::string entryPath = "/main";
   bool inlineIrCalls = false;
+  uint32_t optimizationLevel = 0;
+  bool irOptimizationReport = false;
+  VmEngineMode vmEngine = VmEngineMode::Checked;
+  NativeCodegenMode nativeCodegen = NativeCodegenMode::Stack;
   std::string dumpStage;
   std::vector<std::string> textFilters = {"collections", "operators", "implicit-utf8", "implicit-i32"};
   std::vector<TextTransformRule> textTransformRules;
@@ -9,6 +9,9 @@
 #include <vector>
 
 #include "primec/Ir.h"
+#include "primec/Options.h"
+#include "primec/VmFileBuffers.h"
+#include "primec/VmHeap.h"
 
 namespace primec {
 
@@ -181,11 +184,16 @@ bool resolveSourceBreakpoints(const IrModule &module,
 
 class Vm {
 public:
+  explicit Vm(VmEngineMode engine = VmEngineMode::Checked) : engine_(engine) {}
+
   bool execute(const IrModule &module, uint64_t &result, std::string &error, uint64_t argCount = 0) const;
   bool execute(const IrModule &module,
                uint64_t &result,
                std::string &error,
                const std::vector<std::string_view> &args) const;
+
+private:
+  VmEngineMode engine_ = VmEngineMode::Checked;
 };
 
 class VmDebugSession {
@@ -207,18 +215,16 @@ public:
   void clearHooks();
   VmDebugSnapshot snapshot() const;
   VmDebugSnapshotPayload snapshotPayload() const;
-
-  struct HeapAllocation {
-    size_t baseIndex = 0;
-    size_t slotCount = 0;
-    bool live = false;
-  };
+  const VmHeapStats &heapStats() const { return heap_.stats(); }
 
 private:
+  // Frame locals are the window [localsBase, localsBase + localCount) of
+  // `localSlots_`, the contiguous slot stack shared by every active frame.
   struct Frame {
     const IrFunction *function = nullptr;
     size_t functionIndex = 0;
-    std::vector<uint64_t> locals;
+    size_t localsBase = 0;
+    size_t localCount = 0;
     size_t ip = 0;
     bool returnValueToCaller = false;
   };
@@ -238,8 +244,9 @@ private:
   std::vector<std::string_view> ownedArgViews_;
   std::vector<size_t> localCounts_;
   std::vector<uint64_t> stack_;
-  std::vector<uint64_t> heapSlots_;
-  std::vector<HeapAllocation> heapAllocations_;
+  std::vector<uint64_t> localSlots_;
+  VmHeap heap_;
+  VmFileBuffers files_;
   std::vector<Frame> frames_;
   VmDebugSessionState state_ = VmDebugSessionState::Idle;
   uint64_t result_ = 0;
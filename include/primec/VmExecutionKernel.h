@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -17,10 +18,25 @@ public:
   virtual uint64_t slotBytes() const = 0;
   virtual size_t maxCallDepth() const = 0;
 
+  // `locals` is the active frame's window into the contiguous local-slot
+  // stack; it stays valid only until the next call or return.
   virtual bool resolveIndirectAddress(uint64_t address,
-                                      std::vector<uint64_t> &locals,
+                                      std::span<uint64_t> locals,
                                       uint64_t *&slot,
                                       std::string &error) = 0;
+  // Reads may also target address kinds with no writable slot behind them
+  // (read-only file views), so hosts can serve them without resolving.
+  virtual bool loadIndirectValue(uint64_t address,
+                                 std::span<uint64_t> locals,
+                                 uint64_t &value,
+                                 std::string &error) {
+    uint64_t *slot = nullptr;
+    if (!resolveIndirectAddress(address, locals, slot, error)) {
+      return false;
+    }
+    value = *slot;
+    return true;
+  }
   virtual bool allocateHeapSlots(uint64_t slotCount,
                                  uint64_t &address,
                                  std::string &error) = 0;
@@ -37,7 +53,7 @@ public:
   virtual bool handleFileInstruction(const IrModule &module,
                                      const IrInstruction &inst,
                                      std::vector<uint64_t> &stack,
-                                     std::vector<uint64_t> &locals,
+                                     std::span<uint64_t> locals,
                                      std::string &error) = 0;
 };
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "primec/Ir.h"
+#include "primec/VmExecutionKernel.h"
+
+namespace primec::vm_detail {
+
+// Per-function operand-stack facts proven by `verifyVmFastKernelModule`.
+// Heights are relative to the operand-stack depth at function entry, so a
+// callee that pops caller-pushed arguments reports a negative `minHeight`.
+struct VmFastFunctionSignature {
+  bool returns = false;
+  int64_t minHeight = 0;
+  int64_t maxHeight = 0;
+  int64_t netHeight = 0;
+};
+
+// Verifies every function reachable from the module entry once: operand
+// stack heights agree at every join, locals and jump/call targets stay in
+// range, and no path falls off the end of a function. On success
+// `signatures` holds one entry per module function (unreachable functions
+// keep the default signature).
+bool verifyVmFastKernelModule(const IrModule &module,
+                              std::vector<VmFastFunctionSignature> &signatures,
+                              std::string &reason);
+
+// Runs `module` through the pre-decoded, direct-threaded engine. Verified
+// modules execute without per-instruction stack/local/jump checks; modules
+// that fail verification run through `executeVmKernel`, so results and
+// runtime diagnostics always match the checked kernel.
+bool executeVmFastKernel(const IrModule &module,
+                         VmKernelHost &host,
+                         uint64_t &result,
+                         std::string &error);
+
+} // namespace primec::vm_detail
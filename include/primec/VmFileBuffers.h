@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace primec {
+
+// User-space buffers behind the VM file opcodes. Descriptors opened through
+// `FileOpen*` get a read buffer (read-only opens) or a write buffer; writes
+// are drained on `FileFlush`, `FileClose`, and when the owning host or debug
+// session finishes. Descriptors the VM did not open go straight to the OS, so
+// error codes for stale or forged handles are unchanged.
+//
+// `FileMapBytes` views live here too: each is a read-only `mmap` of a whole
+// file addressed as `1 << 62 | view << MappedViewShift | slotIndex *
+// slotBytes`. Slot 0 reads the byte count and slot `k + 1` byte `k`, the same
+// layout as an array, so indexing and `count` work on a view without copying.
+class VmFileBuffers {
+public:
+  static constexpr size_t BufferBytes = 64 * 1024;
+  static constexpr uint64_t MappedAddressTag = 1ull << 62;
+  static constexpr unsigned MappedViewShift = 44;
+
+  static bool isMappedAddress(uint64_t address) { return (address >> 62) == 1; }
+
+  VmFileBuffers() = default;
+  VmFileBuffers(const VmFileBuffers &) = delete;
+  VmFileBuffers &operator=(const VmFileBuffers &) = delete;
+  VmFileBuffers(VmFileBuffers &&) = default;
+  VmFileBuffers &operator=(VmFileBuffers &&) = default;
+  ~VmFileBuffers();
+
+  void track(int fd, bool writable);
+
+  // The returned code is 0, an errno value, or `FileReadEofCode`, matching
+  // the unbuffered opcode contract.
+  uint32_t readByte(int fd, uint8_t &value);
+  // Reads until `size` bytes arrived or the stream ended; `readOut` counts
+  // the bytes stored, and a short read reports `FileReadEofCode`.
+  uint32_t read(int fd, uint8_t *data, size_t size, size_t &readOut);
+  uint32_t write(int fd, const void *data, size_t size);
+  uint32_t flush(int fd);
+  uint32_t close(int fd);
+
+  // Maps the whole file behind `fd`; independent of any buffered read
+  // position. Returns 0 or an errno value.
+  uint32_t map(int fd, uint64_t slotBytes, uint64_t &addressOut);
+  bool loadMapped(uint64_t address, uint64_t slotBytes, uint64_t &valueOut) const;
+  // Bytes behind `count` element slots starting at `address`, or null when
+  // the range leaves the view.
+  const uint8_t *mappedBytes(uint64_t address, uint64_t slotBytes, uint64_t count) const;
+
+  // Drains every write buffer; descriptors stay open and tracked.
+  void flushAll();
+  // Drains every write buffer, forgets all descriptors, and unmaps views.
+  void clear();
+
+private:
+  struct Buffer {
+    bool tracked = false;
+    bool writable = false;
+    size_t begin = 0;
+    size_t end = 0;
+    std::vector<uint8_t> bytes;
+  };
+
+  struct MappedView {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+  };
+
+  Buffer *find(int fd);
+  uint32_t drain(int fd, Buffer &buffer);
+  const MappedView *findView(uint64_t address, uint64_t &slotIndexOut, uint64_t slotBytes) const;
+  void unmapAll();
+
+  // Indexed by descriptor; descriptors are small and reused by the OS.
+  std::vector<Buffer> buffers_;
+  std::vector<MappedView> views_;
+};
+
+} // namespace primec
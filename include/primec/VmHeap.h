@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace primec {
+
+struct VmHeapStats {
+  uint64_t liveBytes = 0;
+  uint64_t peakBytes = 0;
+  uint64_t allocationCount = 0;
+  // Allocations served from a size-class free list or a coalesced free run
+  // instead of fresh heap pages.
+  uint64_t reusedAllocationCount = 0;
+
+  double reuseRate() const {
+    return allocationCount == 0 ? 0.0
+                                : static_cast<double>(reusedAllocationCount) / static_cast<double>(allocationCount);
+  }
+};
+
+// Slot heap behind the VM `HeapAlloc`/`HeapFree`/`HeapRealloc` opcodes.
+// Addresses are tagged byte offsets (`1 << 63 | slotIndex * slotBytes`) into
+// one growing slot vector carved into fixed-size pages. Small requests are
+// served from power-of-two size classes whose pages hold blocks of a single
+// class; larger requests take whole page runs, and freed runs coalesce with
+// free neighbours. A per-page table maps any slot index to its block in O(1).
+class VmHeap {
+public:
+  static constexpr uint64_t AddressTag = 1ull << 63;
+  static constexpr size_t PageShift = 8;
+  static constexpr size_t PageSlots = size_t{1} << PageShift;
+  static constexpr size_t SizeClassCount = PageShift;
+
+  bool allocate(uint64_t slotCount, uint64_t slotBytes, uint64_t &addressOut, std::string &error);
+  bool free(uint64_t address, uint64_t slotBytes, std::string &error);
+  bool reallocate(uint64_t address,
+                  uint64_t slotCount,
+                  uint64_t slotBytes,
+                  uint64_t &addressOut,
+                  std::string &error);
+  // Returns the slot for a tagged heap address when `slotCount` slots starting
+  // there lie inside one live allocation (bounded by the requested slot count,
+  // not the block size).
+  uint64_t *resolve(uint64_t address, uint64_t slotBytes, uint64_t slotCount = 1);
+  void clear();
+
+  const VmHeapStats &stats() const { return stats_; }
+  size_t reservedSlots() const { return slots_.size(); }
+
+private:
+  struct Page {
+    // 0 for unassigned pages; a power-of-two block size for size-class pages;
+    // the whole run size for large-allocation pages.
+    size_t blockSlots = 0;
+    size_t blockShift = 0;
+    size_t runFirstPage = 0;
+    uint32_t metaIndex = 0;
+    bool large = false;
+  };
+
+  struct BlockRef {
+    size_t baseIndex = 0;
+    size_t capacitySlots = 0;
+    uint32_t metaIndex = 0;
+    bool large = false;
+  };
+
+  bool findBlock(size_t baseIndex, BlockRef &out) const;
+  bool acquirePages(size_t pageCount, size_t &firstPageOut, bool &reusedOut);
+  void releasePages(size_t firstPage, size_t pageCount);
+  uint32_t acquireLargeMeta();
+  void noteAllocated(uint64_t slotCount, uint64_t slotBytes, bool reused);
+
+  std::vector<uint64_t> slots_;
+  std::vector<Page> pages_;
+  // Requested slot count per block; 0 marks a free block.
+  std::vector<uint64_t> blockSlotCounts_;
+  std::vector<uint32_t> freeLargeMetas_;
+  std::array<std::vector<size_t>, SizeClassCount> freeBlocks_;
+  // Blocks at the bottom of each free list that were carved from fresh pages
+  // and never handed out; everything above them is recycled memory.
+  std::array<size_t, SizeClassCount> freshBlockCounts_{};
+  // Free page runs keyed by first page, coalesced on release.
+  std::map<size_t, size_t> freeRuns_;
+  VmHeapStats stats_;
+};
+
+} // namespace primec
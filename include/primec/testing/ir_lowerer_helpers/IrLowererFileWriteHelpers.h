@@ -89,16 +89,25 @@ bool emitFileWriteBytesCall(const Expr &expr,
                             const EmitExprForWriteFn &emitExpr,
                             const AllocTempLocalForWriteFn &allocTempLocal,
                             const EmitInstructionForWriteFn &emitInstruction,
-                            const GetInstructionCountForWriteFn &getInstructionCount,
-                            const PatchInstructionImmForWriteFn &patchInstructionImm,
                             std::string &error);
-bool emitFileWriteBytesLoop(const Expr &bytesExpr,
-                            int32_t handleIndex,
-                            const EmitExprForWriteFn &emitExpr,
-                            const AllocTempLocalForWriteFn &allocTempLocal,
-                            const EmitInstructionForWriteFn &emitInstruction,
-                            const GetInstructionCountForWriteFn &getInstructionCount,
-                            const PatchInstructionImmForWriteFn &patchInstructionImm);
+bool emitFileReadBytesCall(const Expr &expr,
+                           const LocalMap &localsIn,
+                           int32_t handleIndex,
+                           const EmitExprForWriteFn &emitExpr,
+                           const AllocTempLocalForWriteFn &allocTempLocal,
+                           const EmitInstructionForWriteFn &emitInstruction,
+                           std::string &error);
+bool emitFileMapBytesCall(const Expr &expr,
+                          const LocalMap &localsIn,
+                          int32_t handleIndex,
+                          const EmitInstructionForWriteFn &emitInstruction,
+                          std::string &error);
+bool emitFileBytesRange(const Expr &bytesExpr,
+                        int32_t handleIndex,
+                        IrOpcode op,
+                        const EmitExprForWriteFn &emitExpr,
+                        const AllocTempLocalForWriteFn &allocTempLocal,
+                        const EmitInstructionForWriteFn &emitInstruction);
 FileHandleMethodCallEmitResult tryEmitFileHandleMethodCall(
     const Expr &expr,
     const LocalMap &localsIn,
@@ -7,6 +7,8 @@ RUNS="${BENCH_RUNS:-5}"
 BENCH_DIR="${BENCH_DIR:-}"
 COMPILE_RUNS="${BENCH_COMPILE_RUNS:-}"
 COMPILE_LINES="${BENCH_COMPILE_LINES:-100000}"
+FANOUT_HELPERS="${BENCH_FANOUT_HELPERS:-16}"
+FANOUT_CALLS="${BENCH_FANOUT_CALLS:-16}"
 REPORT_JSON="${BENCH_REPORT_JSON:-}"
 BASELINE_JSON="${BENCH_BASELINE_JSON:-}"
 MAX_REGRESSION_RATIO="${BENCH_MAX_REGRESSION_RATIO:-1.25}"
@@ -106,6 +108,9 @@ COMPILE_CPP_EXE="$BENCH_DIR/compile_speed_cpp"
 COMPILE_RS_EXE="$BENCH_DIR/compile_speed_rust"
 COMPILE_CPP="$BENCH_DIR/compile_speed_primestruct.cpp"
 COMPILE_NATIVE="$BENCH_DIR/compile_speed_primestruct_native"
+FANOUT_SRC="$BENCH_DIR/struct_call_fanout.prime"
+FANOUT_CPP="$BENCH_DIR/struct_call_fanout_primestruct.cpp"
+FANOUT_NATIVE="$BENCH_DIR/struct_call_fanout_primestruct_native"
 
 C_SRC="$ROOT_DIR/benchmarks/aggregate.c"
 CPP_SRC="$ROOT_DIR/benchmarks/aggregate.cpp"
@@ -244,6 +249,52 @@ emit_file(
 )
 PY
 
+"$PYTHON" - "$FANOUT_SRC" "$FANOUT_HELPERS" "$FANOUT_CALLS" <<'PY'
+import sys
+
+path = sys.argv[1]
+helpers = int(sys.argv[2])
+calls = int(sys.argv[3])
+
+lines = [
+    "[struct]",
+    "Sample() {",
+    "  [i64] id{0i64}",
+    "  [i32] x{0i32}",
+    "  [i32] y{0i32}",
+    "  [f64] weight{0.0f64}",
+    "}",
+    "",
+]
+for h in range(helpers):
+    lines += [
+        "[return<i32>]",
+        f"score{h}([Sample] s, [i32] bias) {{",
+        f"  [i32] a{{plus(multiply(s.x, {h + 1}i32), s.y)}}",
+        "  [i32] b{plus(a, convert<i32>(s.id))}",
+        "  [i32] c{plus(multiply(b, 3i32), bias)}",
+        "  return(minus(c, a))",
+        "}",
+        "",
+    ]
+lines += [
+    "[return<i32>]",
+    "main() {",
+    "  [Sample] s{Sample(1i64, 2i32, 3i32, 0.5f64)}",
+    "  [i32 mut] total{0i32}",
+]
+for h in range(helpers):
+    for c in range(calls):
+        lines.append(f"  assign(total, plus(total, score{h}(s, {c}i32)))")
+lines += [
+    "  return(0i32)",
+    "}",
+]
+with open(path, "w", newline="\n") as handle:
+    handle.write("\n".join(lines))
+    handle.write("\n")
+PY
+
 "$CC" -O3 -DNDEBUG -std=c11 "$C_SRC" -o "$C_EXE"
 "$CXX" -O3 -DNDEBUG -std=c++23 "$CPP_SRC" -o "$CPP_EXE"
 "$RUSTC" -O "$RS_SRC" -o "$RS_EXE"
@@ -275,7 +326,8 @@ fi
     "$COMPILE_C_SRC" "$COMPILE_CPP_SRC" "$COMPILE_RS_SRC" \
     "$CC" "$CXX" "$RUSTC" "$PRIMEC_BIN" \
     "$COMPILE_C_EXE" "$COMPILE_CPP_EXE" "$COMPILE_RS_EXE" \
-    "$COMPILE_CPP" "$COMPILE_NATIVE" "$REPORT_JSON" <<'PY'
+    "$COMPILE_CPP" "$COMPILE_NATIVE" "$REPORT_JSON" \
+    "$FANOUT_SRC" "$FANOUT_CPP" "$FANOUT_NATIVE" "$FANOUT_HELPERS" "$FANOUT_CALLS" <<'PY'
 import subprocess
 import sys
 import time
@@ -301,6 +353,11 @@ compile_rs_exe = sys.argv[15]
 compile_cpp = sys.argv[16]
 compile_native = sys.argv[17]
 report_json = sys.argv[18]
+fanout_src = sys.argv[19]
+fanout_cpp = sys.argv[20]
+fanout_native = sys.argv[21]
+fanout_helpers = int(sys.argv[22])
+fanout_calls = int(sys.argv[23])
 
 def primestruct_entries(name: str):
     entries = [
@@ -361,7 +418,8 @@ def run_entry(benchmark_name: str, label: str, path: str) -> None:
         "artifact_size_bytes": Path(path).stat().st_size,
     })
 
-def run_compile_entry(label: str, cmd: list[str], outputs: list[str]) -> None:
+def run_compile_entry(label: str, cmd: list[str], outputs: list[str],
+                      benchmark_name: str = "compile_speed") -> None:
     print(f"\n== {label} ==")
     check = subprocess.run(cmd, capture_output=True, text=True)
     if check.returncode != 0:
@@ -391,7 +449,7 @@ def run_compile_entry(label: str, cmd: list[str], outputs: list[str]) -> None:
         if out_path.exists():
             artifact_size += out_path.stat().st_size
     compile_results.append({
-        "benchmark": "compile_speed",
+        "benchmark": benchmark_name,
         "entry": label,
         "mean_seconds": mean,
         "median_seconds": median,
@@ -458,6 +516,39 @@ print("\n=== compile_speed ===")
 for label, cmd, outputs in compile_entries:
     run_compile_entry(label, cmd, outputs)
 
+# Struct-parameter helpers called from many sites: tracks how much IR/binary
+# and compile time real calls save over inlining each helper body per site.
+fanout_entries = [
+    ("primestruct_cpp", [
+        primec_bin,
+        "--emit=cpp",
+        fanout_src,
+        "-o",
+        fanout_cpp,
+        "--entry",
+        "/main",
+    ], [fanout_cpp]),
+]
+if run_native:
+    fanout_entries.append((
+        "primestruct_native",
+        [
+            primec_bin,
+            "--emit=native",
+            fanout_src,
+            "-o",
+            fanout_native,
+            "--entry",
+            "/main",
+        ],
+        [fanout_native],
+    ))
+
+print("\n=== struct_call_fanout ===")
+print(f"helpers: {fanout_helpers}, call sites per helper: {fanout_calls}")
+for label, cmd, outputs in fanout_entries:
+    run_compile_entry(label, cmd, outputs, "struct_call_fanout")
+
 if report_json:
     report_payload = {
         "schema": "primestruct_benchmark_report_v1",
@@ -468,6 +559,8 @@ if report_json:
         "runs": runs,
         "compile_runs": compile_runs,
         "compile_lines": compile_lines,
+        "fanout_helpers": fanout_helpers,
+        "fanout_calls": fanout_calls,
         "runtime_results": runtime_results,
         "compile_results": compile_results,
     }
@@ -206,6 +206,11 @@ CliFailure describeIrPreparationFailure(const IrPreparationFailure &failure, con
       cliFailure.plainPrefix = diagnostics.inliningErrorPrefix;
       cliFailure.notes = makeIrBackendNotes(diagnostics, "ir-inline");
       break;
+    case IrPreparationFailureStage::Optimization:
+      cliFailure.code = diagnostics.validationDiagnosticCode;
+      cliFailure.plainPrefix = diagnostics.validationErrorPrefix;
+      cliFailure.notes = makeIrBackendNotes(diagnostics, "ir-optimize");
+      break;
     case IrPreparationFailureStage::Lowering:
     case IrPreparationFailureStage::None:
     default:
@@ -240,6 +245,11 @@ CliFailure describeIrPreparationFailure(const IrPreparationFailure &failure,
       cliFailure.plainPrefix = diagnostics.inliningErrorPrefix;
       cliFailure.notes = makeIrBackendNotes(diagnostics, "ir-inline");
       break;
+    case IrPreparationFailureStage::Optimization:
+      cliFailure.code = diagnostics.validationDiagnosticCode;
+      cliFailure.plainPrefix = diagnostics.validationErrorPrefix;
+      cliFailure.notes = makeIrBackendNotes(diagnostics, "ir-optimize");
+      break;
     case IrPreparationFailureStage::Lowering:
     case IrPreparationFailureStage::None:
     default:
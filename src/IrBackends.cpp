@@ -141,7 +141,7 @@ public:
             const IrBackendEmitOptions &options,
             IrBackendEmitResult &result,
             std::string &error) const override {
-    Vm vm;
+    Vm vm(options.vmEngine);
     std::vector<std::string_view> args;
     args.reserve(1 + options.programArgs.size());
     args.push_back(options.inputPath);
@@ -191,7 +191,9 @@ public:
             IrBackendEmitResult & /*result*/,
             std::string &error) const override {
     NativeEmitter nativeEmitter;
-    return nativeEmitter.emitExecutable(module, options.outputPath, error);
+    NativeEmitterOptions emitterOptions;
+    emitterOptions.enableRegisterAllocation = options.nativeCodegen == NativeCodegenMode::RegisterAllocated;
+    return nativeEmitter.emitExecutable(module, options.outputPath, error, nullptr, emitterOptions);
   }
 };
 
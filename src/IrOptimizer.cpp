@@ -0,0 +1,979 @@
+#include "primec/IrOptimizer.h"
+
+#include "primec/IrVirtualRegisterLowering.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace primec {
+namespace {
+
+constexpr size_t MaxOptimizationRounds = 8;
+constexpr size_t MaxDeadTreeDepth = 16;
+constexpr size_t NoIndex = std::numeric_limits<size_t>::max();
+
+enum class OptimizationPass : uint8_t {
+  ConstantCopyPropagation,
+  ConstantFolding,
+  UnreachableBlockRemoval,
+  RedundantLoadStoreElimination,
+  DeadStoreElimination,
+};
+
+constexpr std::array<OptimizationPass, 5> PassPipeline = {
+    OptimizationPass::ConstantCopyPropagation,
+    OptimizationPass::ConstantFolding,
+    OptimizationPass::UnreachableBlockRemoval,
+    OptimizationPass::RedundantLoadStoreElimination,
+    OptimizationPass::DeadStoreElimination,
+};
+
+std::string_view passName(OptimizationPass pass) {
+  switch (pass) {
+    case OptimizationPass::ConstantCopyPropagation:
+      return "constant-copy-propagation";
+    case OptimizationPass::ConstantFolding:
+      return "constant-folding";
+    case OptimizationPass::UnreachableBlockRemoval:
+      return "unreachable-block-removal";
+    case OptimizationPass::RedundantLoadStoreElimination:
+      return "redundant-load-store-elimination";
+    case OptimizationPass::DeadStoreElimination:
+      return "dead-store-elimination";
+  }
+  return "unknown";
+}
+
+bool isPushConstantOpcode(IrOpcode op) {
+  return op == IrOpcode::PushI32 || op == IrOpcode::PushI64 || op == IrOpcode::PushF32 || op == IrOpcode::PushF64;
+}
+
+// Opcodes with no side effects and no fault path; a value produced by one of
+// these may be dropped together with its operands when nothing consumes it.
+bool isDiscardableOpcode(IrOpcode op) {
+  switch (op) {
+    case IrOpcode::PushI32:
+    case IrOpcode::PushI64:
+    case IrOpcode::PushF32:
+    case IrOpcode::PushF64:
+    case IrOpcode::PushArgc:
+    case IrOpcode::LoadLocal:
+    case IrOpcode::Dup:
+    case IrOpcode::AddI32:
+    case IrOpcode::SubI32:
+    case IrOpcode::MulI32:
+    case IrOpcode::NegI32:
+    case IrOpcode::AddI64:
+    case IrOpcode::SubI64:
+    case IrOpcode::MulI64:
+    case IrOpcode::NegI64:
+    case IrOpcode::AddF32:
+    case IrOpcode::SubF32:
+    case IrOpcode::MulF32:
+    case IrOpcode::DivF32:
+    case IrOpcode::NegF32:
+    case IrOpcode::AddF64:
+    case IrOpcode::SubF64:
+    case IrOpcode::MulF64:
+    case IrOpcode::DivF64:
+    case IrOpcode::NegF64:
+    case IrOpcode::CmpEqI32:
+    case IrOpcode::CmpNeI32:
+    case IrOpcode::CmpLtI32:
+    case IrOpcode::CmpLeI32:
+    case IrOpcode::CmpGtI32:
+    case IrOpcode::CmpGeI32:
+    case IrOpcode::CmpEqI64:
+    case IrOpcode::CmpNeI64:
+    case IrOpcode::CmpLtI64:
+    case IrOpcode::CmpLeI64:
+    case IrOpcode::CmpGtI64:
+    case IrOpcode::CmpGeI64:
+    case IrOpcode::CmpLtU64:
+    case IrOpcode::CmpLeU64:
+    case IrOpcode::CmpGtU64:
+    case IrOpcode::CmpGeU64:
+    case IrOpcode::CmpEqF32:
+    case IrOpcode::CmpNeF32:
+    case IrOpcode::CmpLtF32:
+    case IrOpcode::CmpLeF32:
+    case IrOpcode::CmpGtF32:
+    case IrOpcode::CmpGeF32:
+    case IrOpcode::CmpEqF64:
+    case IrOpcode::CmpNeF64:
+    case IrOpcode::CmpLtF64:
+    case IrOpcode::CmpLeF64:
+    case IrOpcode::CmpGtF64:
+    case IrOpcode::CmpGeF64:
+    case IrOpcode::ConvertI32ToF32:
+    case IrOpcode::ConvertI32ToF64:
+    case IrOpcode::ConvertI64ToF32:
+    case IrOpcode::ConvertI64ToF64:
+    case IrOpcode::ConvertU64ToF32:
+    case IrOpcode::ConvertU64ToF64:
+    case IrOpcode::ConvertF32ToF64:
+    case IrOpcode::ConvertF64ToF32:
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t countInstructions(const IrModule &module) {
+  size_t count = 0;
+  for (const IrFunction &function : module.functions) {
+    count += function.instructions.size();
+  }
+  return count;
+}
+
+// Per-pass view of one function: who defines each virtual register, how many
+// consumers it has, and which instructions the pass has deleted so far.
+// Deletions are applied in one compaction step so indices stay stable while a
+// pass is still walking the blocks.
+class FunctionRewriter {
+public:
+  explicit FunctionRewriter(IrVirtualRegisterFunction &function) : function_(function) {
+    definingBlock_.assign(function.nextVirtualRegister, NoIndex);
+    definingInstruction_.assign(function.nextVirtualRegister, NoIndex);
+    dupReader_.assign(function.nextVirtualRegister, NoIndex);
+    useCounts_.assign(function.nextVirtualRegister, 0);
+    removed_.resize(function.blocks.size());
+    for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+      const IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+      removed_[blockIndex].assign(block.instructions.size(), 0);
+      if (!block.reachable) {
+        continue;
+      }
+      for (size_t index = 0; index < block.instructions.size(); ++index) {
+        const IrVirtualRegisterInstruction &instruction = block.instructions[index];
+        for (uint32_t reg : instruction.defRegisters) {
+          definingBlock_[reg] = blockIndex;
+          definingInstruction_[reg] = index;
+        }
+        for (uint32_t reg : instruction.useRegisters) {
+          ++useCounts_[reg];
+        }
+        if (instruction.instruction.op == IrOpcode::Dup && !instruction.useRegisters.empty()) {
+          dupReader_[instruction.useRegisters.front()] = index;
+        }
+      }
+      for (uint32_t reg : block.exitRegisters) {
+        ++useCounts_[reg];
+      }
+    }
+  }
+
+  IrVirtualRegisterFunction &function() {
+    return function_;
+  }
+
+  IrVirtualRegisterInstruction &instruction(size_t blockIndex, size_t index) {
+    return function_.blocks[blockIndex].instructions[index];
+  }
+
+  bool isRemoved(size_t blockIndex, size_t index) const {
+    return removed_[blockIndex][index] != 0;
+  }
+
+  void remove(size_t blockIndex, size_t index) {
+    removed_[blockIndex][index] = 1;
+  }
+
+  uint32_t useCount(uint32_t reg) const {
+    return useCounts_[reg];
+  }
+
+  // Index of the live instruction in `blockIndex` that defines `reg`, or
+  // NoIndex when the register is defined elsewhere or by a deleted instruction.
+  size_t definitionInBlock(uint32_t reg, size_t blockIndex) const {
+    if (definingBlock_[reg] != blockIndex) {
+      return NoIndex;
+    }
+    const size_t index = definingInstruction_[reg];
+    return isRemoved(blockIndex, index) ? NoIndex : index;
+  }
+
+  size_t dupReaderInBlock(uint32_t reg, size_t blockIndex) const {
+    if (definingBlock_[reg] != blockIndex || dupReader_[reg] == NoIndex) {
+      return NoIndex;
+    }
+    return isRemoved(blockIndex, dupReader_[reg]) ? NoIndex : dupReader_[reg];
+  }
+
+  void compact() {
+    for (size_t blockIndex = 0; blockIndex < function_.blocks.size(); ++blockIndex) {
+      auto &instructions = function_.blocks[blockIndex].instructions;
+      size_t write = 0;
+      for (size_t read = 0; read < instructions.size(); ++read) {
+        if (removed_[blockIndex][read] != 0) {
+          continue;
+        }
+        if (write != read) {
+          instructions[write] = std::move(instructions[read]);
+        }
+        ++write;
+      }
+      instructions.resize(write);
+    }
+  }
+
+private:
+  IrVirtualRegisterFunction &function_;
+  std::vector<size_t> definingBlock_;
+  std::vector<size_t> definingInstruction_;
+  std::vector<size_t> dupReader_;
+  std::vector<uint32_t> useCounts_;
+  std::vector<std::vector<uint8_t>> removed_;
+};
+
+struct LocalLayout {
+  size_t localCount = 0;
+  // Locals at or above this index may be reached through an AddressOfLocal
+  // pointer (struct fields are laid out after their base slot), so their
+  // loads and stores are never rewritten. Frame addresses are plain slot
+  // offsets, so any function that dereferences memory pins every local.
+  size_t firstPinnedLocal = 0;
+
+  bool isTracked(uint64_t local) const {
+    return local < firstPinnedLocal;
+  }
+};
+
+LocalLayout computeLocalLayout(const IrVirtualRegisterFunction &function) {
+  LocalLayout layout;
+  size_t firstAddressTaken = NoIndex;
+  for (const IrVirtualRegisterBlock &block : function.blocks) {
+    for (const IrVirtualRegisterInstruction &instruction : block.instructions) {
+      const IrInstruction &inst = instruction.instruction;
+      switch (inst.op) {
+        case IrOpcode::LoadIndirect:
+        case IrOpcode::StoreIndirect:
+        case IrOpcode::FileReadBytes:
+        case IrOpcode::FileWriteBytes:
+          firstAddressTaken = 0;
+          break;
+        case IrOpcode::AddressOfLocal:
+          firstAddressTaken = std::min(firstAddressTaken, static_cast<size_t>(inst.imm));
+          [[fallthrough]];
+        case IrOpcode::LoadLocal:
+        case IrOpcode::StoreLocal:
+        case IrOpcode::FileReadByte:
+        case IrOpcode::FileMapBytes:
+          layout.localCount = std::max(layout.localCount, static_cast<size_t>(inst.imm) + 1);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  layout.firstPinnedLocal = std::min(firstAddressTaken, layout.localCount);
+  return layout;
+}
+
+std::optional<uint64_t> foldIntegerBinary(IrOpcode op, uint64_t lhsImm, uint64_t rhsImm) {
+  const int64_t lhs32 = static_cast<int32_t>(lhsImm);
+  const int64_t rhs32 = static_cast<int32_t>(rhsImm);
+  const int64_t lhs64 = static_cast<int64_t>(lhsImm);
+  const int64_t rhs64 = static_cast<int64_t>(rhsImm);
+  const auto fitI32 = [](int64_t value) -> std::optional<uint64_t> {
+    if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+      return std::nullopt;
+    }
+    return static_cast<uint64_t>(value);
+  };
+  const auto flag = [](bool value) -> std::optional<uint64_t> { return value ? 1u : 0u; };
+  int64_t result = 0;
+  switch (op) {
+    case IrOpcode::AddI32:
+      return fitI32(lhs32 + rhs32);
+    case IrOpcode::SubI32:
+      return fitI32(lhs32 - rhs32);
+    case IrOpcode::MulI32:
+      return fitI32(lhs32 * rhs32);
+    case IrOpcode::DivI32:
+      if (rhs32 == 0 || (lhs32 == std::numeric_limits<int32_t>::min() && rhs32 == -1)) {
+        return std::nullopt;
+      }
+      return fitI32(lhs32 / rhs32);
+    case IrOpcode::AddI64:
+      if (__builtin_add_overflow(lhs64, rhs64, &result)) {
+        return std::nullopt;
+      }
+      return static_cast<uint64_t>(result);
+    case IrOpcode::SubI64:
+      if (__builtin_sub_overflow(lhs64, rhs64, &result)) {
+        return std::nullopt;
+      }
+      return static_cast<uint64_t>(result);
+    case IrOpcode::MulI64:
+      if (__builtin_mul_overflow(lhs64, rhs64, &result)) {
+        return std::nullopt;
+      }
+      return static_cast<uint64_t>(result);
+    case IrOpcode::DivI64:
+      if (rhs64 == 0 || (lhs64 == std::numeric_limits<int64_t>::min() && rhs64 == -1)) {
+        return std::nullopt;
+      }
+      return static_cast<uint64_t>(lhs64 / rhs64);
+    case IrOpcode::DivU64:
+      if (rhsImm == 0) {
+        return std::nullopt;
+      }
+      return lhsImm / rhsImm;
+    case IrOpcode::CmpEqI32:
+      return flag(lhs32 == rhs32);
+    case IrOpcode::CmpNeI32:
+      return flag(lhs32 != rhs32);
+    case IrOpcode::CmpLtI32:
+      return flag(lhs32 < rhs32);
+    case IrOpcode::CmpLeI32:
+      return flag(lhs32 <= rhs32);
+    case IrOpcode::CmpGtI32:
+      return flag(lhs32 > rhs32);
+    case IrOpcode::CmpGeI32:
+      return flag(lhs32 >= rhs32);
+    case IrOpcode::CmpEqI64:
+      return flag(lhs64 == rhs64);
+    case IrOpcode::CmpNeI64:
+      return flag(lhs64 != rhs64);
+    case IrOpcode::CmpLtI64:
+      return flag(lhs64 < rhs64);
+    case IrOpcode::CmpLeI64:
+      return flag(lhs64 <= rhs64);
+    case IrOpcode::CmpGtI64:
+      return flag(lhs64 > rhs64);
+    case IrOpcode::CmpGeI64:
+      return flag(lhs64 >= rhs64);
+    case IrOpcode::CmpLtU64:
+      return flag(lhsImm < rhsImm);
+    case IrOpcode::CmpLeU64:
+      return flag(lhsImm <= rhsImm);
+    case IrOpcode::CmpGtU64:
+      return flag(lhsImm > rhsImm);
+    case IrOpcode::CmpGeU64:
+      return flag(lhsImm >= rhsImm);
+    default:
+      return std::nullopt;
+  }
+}
+
+// Operand push opcode an integer op must see for folding to be exact, and the
+// push opcode that carries its result. Mixed-width operands are left alone.
+bool integerFoldShape(IrOpcode op, IrOpcode &operandPush, IrOpcode &resultPush) {
+  switch (op) {
+    case IrOpcode::AddI32:
+    case IrOpcode::SubI32:
+    case IrOpcode::MulI32:
+    case IrOpcode::DivI32:
+    case IrOpcode::NegI32:
+      operandPush = IrOpcode::PushI32;
+      resultPush = IrOpcode::PushI32;
+      return true;
+    case IrOpcode::CmpEqI32:
+    case IrOpcode::CmpNeI32:
+    case IrOpcode::CmpLtI32:
+    case IrOpcode::CmpLeI32:
+    case IrOpcode::CmpGtI32:
+    case IrOpcode::CmpGeI32:
+      operandPush = IrOpcode::PushI32;
+      resultPush = IrOpcode::PushI32;
+      return true;
+    case IrOpcode::AddI64:
+    case IrOpcode::SubI64:
+    case IrOpcode::MulI64:
+    case IrOpcode::DivI64:
+    case IrOpcode::DivU64:
+    case IrOpcode::NegI64:
+      operandPush = IrOpcode::PushI64;
+      resultPush = IrOpcode::PushI64;
+      return true;
+    case IrOpcode::CmpEqI64:
+    case IrOpcode::CmpNeI64:
+    case IrOpcode::CmpLtI64:
+    case IrOpcode::CmpLeI64:
+    case IrOpcode::CmpGtI64:
+    case IrOpcode::CmpGeI64:
+    case IrOpcode::CmpLtU64:
+    case IrOpcode::CmpLeU64:
+    case IrOpcode::CmpGtU64:
+    case IrOpcode::CmpGeU64:
+      operandPush = IrOpcode::PushI64;
+      resultPush = IrOpcode::PushI32;
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t singleUseConstantOperand(const FunctionRewriter &rewriter,
+                                IrVirtualRegisterFunction &function,
+                                size_t blockIndex,
+                                uint32_t reg,
+                                IrOpcode expectedPush) {
+  if (rewriter.useCount(reg) != 1) {
+    return NoIndex;
+  }
+  const size_t index = rewriter.definitionInBlock(reg, blockIndex);
+  if (index == NoIndex || function.blocks[blockIndex].instructions[index].instruction.op != expectedPush) {
+    return NoIndex;
+  }
+  return index;
+}
+
+size_t foldConstants(FunctionRewriter &rewriter) {
+  IrVirtualRegisterFunction &function = rewriter.function();
+  size_t rewrites = 0;
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+    IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+    if (!block.reachable) {
+      continue;
+    }
+    for (size_t index = 0; index < block.instructions.size(); ++index) {
+      IrVirtualRegisterInstruction &current = block.instructions[index];
+      IrInstruction &inst = current.instruction;
+
+      if (inst.op == IrOpcode::JumpIfZero && current.useRegisters.size() == 1) {
+        const uint32_t conditionReg = current.useRegisters.front();
+        size_t conditionIndex = singleUseConstantOperand(rewriter, function, blockIndex, conditionReg, IrOpcode::PushI32);
+        if (conditionIndex == NoIndex) {
+          conditionIndex = singleUseConstantOperand(rewriter, function, blockIndex, conditionReg, IrOpcode::PushI64);
+        }
+        if (conditionIndex == NoIndex) {
+          continue;
+        }
+        const IrInstruction &condition = block.instructions[conditionIndex].instruction;
+        const bool isZero = condition.op == IrOpcode::PushI32 ? static_cast<int32_t>(condition.imm) == 0
+                                                              : condition.imm == 0;
+        rewriter.remove(blockIndex, conditionIndex);
+        if (isZero) {
+          inst.op = IrOpcode::Jump;
+          current.useRegisters.clear();
+        } else {
+          rewriter.remove(blockIndex, index);
+        }
+        ++rewrites;
+        continue;
+      }
+
+      IrOpcode operandPush = IrOpcode::PushI32;
+      IrOpcode resultPush = IrOpcode::PushI32;
+      if (!integerFoldShape(inst.op, operandPush, resultPush)) {
+        continue;
+      }
+      if (inst.op == IrOpcode::NegI32 || inst.op == IrOpcode::NegI64) {
+        if (current.useRegisters.size() != 1) {
+          continue;
+        }
+        const size_t operandIndex =
+            singleUseConstantOperand(rewriter, function, blockIndex, current.useRegisters.front(), operandPush);
+        if (operandIndex == NoIndex) {
+          continue;
+        }
+        const uint64_t operand = block.instructions[operandIndex].instruction.imm;
+        const std::optional<uint64_t> folded = foldIntegerBinary(
+            inst.op == IrOpcode::NegI32 ? IrOpcode::SubI32 : IrOpcode::SubI64, 0, operand);
+        if (!folded.has_value()) {
+          continue;
+        }
+        rewriter.remove(blockIndex, operandIndex);
+        inst.op = resultPush;
+        inst.imm = *folded;
+        current.useRegisters.clear();
+        ++rewrites;
+        continue;
+      }
+      if (current.useRegisters.size() != 2) {
+        continue;
+      }
+      const size_t lhsIndex =
+          singleUseConstantOperand(rewriter, function, blockIndex, current.useRegisters[0], operandPush);
+      const size_t rhsIndex =
+          singleUseConstantOperand(rewriter, function, blockIndex, current.useRegisters[1], operandPush);
+      if (lhsIndex == NoIndex || rhsIndex == NoIndex) {
+        continue;
+      }
+      const std::optional<uint64_t> folded = foldIntegerBinary(
+          inst.op, block.instructions[lhsIndex].instruction.imm, block.instructions[rhsIndex].instruction.imm);
+      if (!folded.has_value()) {
+        continue;
+      }
+      rewriter.remove(blockIndex, lhsIndex);
+      rewriter.remove(blockIndex, rhsIndex);
+      inst.op = resultPush;
+      inst.imm = *folded;
+      current.useRegisters.clear();
+      ++rewrites;
+    }
+  }
+  return rewrites;
+}
+
+size_t findBlockStartingAt(const IrVirtualRegisterFunction &function, uint64_t instructionIndex) {
+  const auto it = std::lower_bound(function.blocks.begin(),
+                                   function.blocks.end(),
+                                   instructionIndex,
+                                   [](const IrVirtualRegisterBlock &block, uint64_t target) {
+                                     return block.startInstructionIndex < target;
+                                   });
+  if (it == function.blocks.end() || it->startInstructionIndex != instructionIndex) {
+    return NoIndex;
+  }
+  return static_cast<size_t>(std::distance(function.blocks.begin(), it));
+}
+
+size_t removeUnreachableBlocks(FunctionRewriter &rewriter) {
+  IrVirtualRegisterFunction &function = rewriter.function();
+  size_t rewrites = 0;
+  std::vector<uint8_t> emptied(function.blocks.size(), 0);
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+    IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+    if (block.reachable) {
+      continue;
+    }
+    for (size_t index = 0; index < block.instructions.size(); ++index) {
+      rewriter.remove(blockIndex, index);
+    }
+    rewrites += block.instructions.empty() ? 0 : 1;
+    emptied[blockIndex] = 1;
+  }
+
+  // A jump whose target is the next block left in layout order is now a
+  // fall-through.
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+    IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+    if (!block.reachable || block.instructions.empty()) {
+      continue;
+    }
+    const size_t lastIndex = block.instructions.size() - 1;
+    const IrInstruction &last = block.instructions[lastIndex].instruction;
+    if (last.op != IrOpcode::Jump) {
+      continue;
+    }
+    const size_t targetBlock = findBlockStartingAt(function, last.imm);
+    if (targetBlock == NoIndex || targetBlock <= blockIndex) {
+      continue;
+    }
+    bool fallsThrough = true;
+    for (size_t between = blockIndex + 1; between < targetBlock; ++between) {
+      fallsThrough = fallsThrough && emptied[between] != 0;
+    }
+    if (fallsThrough) {
+      rewriter.remove(blockIndex, lastIndex);
+      ++rewrites;
+    }
+  }
+  return rewrites;
+}
+
+struct LocalFact {
+  enum class Kind : uint8_t { Unknown, Constant, Copy };
+  Kind kind = Kind::Unknown;
+  IrOpcode constantOp = IrOpcode::PushI32;
+  uint64_t value = 0;
+
+  bool operator==(const LocalFact &other) const = default;
+};
+
+using LocalFacts = std::vector<LocalFact>;
+
+void clobberLocal(LocalFacts &facts, uint64_t local) {
+  for (LocalFact &fact : facts) {
+    if (fact.kind == LocalFact::Kind::Copy && fact.value == local) {
+      fact = {};
+    }
+  }
+  facts[static_cast<size_t>(local)] = {};
+}
+
+// Applies one block's local stores to `facts`. With `rewrite` set, loads of
+// locals with a known constant or copy source are replaced in place.
+size_t transferLocalFacts(FunctionRewriter &rewriter,
+                          const LocalLayout &layout,
+                          size_t blockIndex,
+                          LocalFacts &facts,
+                          bool rewrite) {
+  IrVirtualRegisterBlock &block = rewriter.function().blocks[blockIndex];
+  size_t rewrites = 0;
+  for (size_t index = 0; index < block.instructions.size(); ++index) {
+    IrVirtualRegisterInstruction &current = block.instructions[index];
+    IrInstruction &inst = current.instruction;
+    switch (inst.op) {
+      case IrOpcode::LoadLocal: {
+        if (!rewrite || !layout.isTracked(inst.imm)) {
+          break;
+        }
+        const LocalFact &fact = facts[static_cast<size_t>(inst.imm)];
+        if (fact.kind == LocalFact::Kind::Constant) {
+          inst.op = fact.constantOp;
+          inst.imm = fact.value;
+          ++rewrites;
+        } else if (fact.kind == LocalFact::Kind::Copy) {
+          inst.imm = fact.value;
+          ++rewrites;
+        }
+        break;
+      }
+      case IrOpcode::StoreLocal: {
+        if (!layout.isTracked(inst.imm) || current.useRegisters.size() != 1) {
+          break;
+        }
+        clobberLocal(facts, inst.imm);
+        const size_t sourceIndex = rewriter.definitionInBlock(current.useRegisters.front(), blockIndex);
+        if (sourceIndex == NoIndex) {
+          break;
+        }
+        const IrInstruction &source = block.instructions[sourceIndex].instruction;
+        LocalFact &fact = facts[static_cast<size_t>(inst.imm)];
+        if (isPushConstantOpcode(source.op)) {
+          fact.kind = LocalFact::Kind::Constant;
+          fact.constantOp = source.op;
+          fact.value = source.imm;
+        } else if (source.op == IrOpcode::LoadLocal && sourceIndex + 1 == index && source.imm != inst.imm &&
+                   layout.isTracked(source.imm)) {
+          const LocalFact &sourceFact = facts[static_cast<size_t>(source.imm)];
+          if (sourceFact.kind == LocalFact::Kind::Unknown) {
+            fact.kind = LocalFact::Kind::Copy;
+            fact.value = source.imm;
+          } else {
+            fact = sourceFact;
+          }
+        }
+        break;
+      }
+      case IrOpcode::FileReadByte:
+      case IrOpcode::FileMapBytes:
+        if (layout.isTracked(inst.imm)) {
+          clobberLocal(facts, inst.imm);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return rewrites;
+}
+
+size_t propagateLocalConstantsAndCopies(FunctionRewriter &rewriter) {
+  IrVirtualRegisterFunction &function = rewriter.function();
+  const LocalLayout layout = computeLocalLayout(function);
+  if (function.blocks.empty() || layout.firstPinnedLocal == 0) {
+    return 0;
+  }
+
+  std::vector<std::optional<LocalFacts>> entryFacts(function.blocks.size());
+  entryFacts[0] = LocalFacts(layout.localCount);
+  std::vector<size_t> worklist = {0};
+  while (!worklist.empty()) {
+    const size_t blockIndex = worklist.back();
+    worklist.pop_back();
+    LocalFacts facts = *entryFacts[blockIndex];
+    transferLocalFacts(rewriter, layout, blockIndex, facts, false);
+    for (const IrVirtualRegisterEdge &edge : function.blocks[blockIndex].successorEdges) {
+      std::optional<LocalFacts> &successorFacts = entryFacts[edge.successorBlockIndex];
+      if (!successorFacts.has_value()) {
+        successorFacts = facts;
+        worklist.push_back(edge.successorBlockIndex);
+        continue;
+      }
+      bool changed = false;
+      for (size_t local = 0; local < facts.size(); ++local) {
+        LocalFact &merged = (*successorFacts)[local];
+        if (merged.kind != LocalFact::Kind::Unknown && !(merged == facts[local])) {
+          merged = {};
+          changed = true;
+        }
+      }
+      if (changed) {
+        worklist.push_back(edge.successorBlockIndex);
+      }
+    }
+  }
+
+  size_t rewrites = 0;
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+    if (!function.blocks[blockIndex].reachable || !entryFacts[blockIndex].has_value()) {
+      continue;
+    }
+    LocalFacts facts = *entryFacts[blockIndex];
+    rewrites += transferLocalFacts(rewriter, layout, blockIndex, facts, true);
+  }
+  return rewrites;
+}
+
+using LiveLocals = std::vector<uint8_t>;
+
+void transferLiveLocals(const IrInstruction &inst, const LocalLayout &layout, LiveLocals &live) {
+  if (inst.op == IrOpcode::LoadLocal && layout.isTracked(inst.imm)) {
+    live[static_cast<size_t>(inst.imm)] = 1;
+  } else if (inst.op == IrOpcode::StoreLocal && layout.isTracked(inst.imm)) {
+    live[static_cast<size_t>(inst.imm)] = 0;
+  }
+}
+
+// Backward liveness of tracked locals at each block exit. Returns do not keep
+// anything alive: a frame's locals die with it.
+std::vector<LiveLocals> computeLiveLocalsAtExit(const IrVirtualRegisterFunction &function, const LocalLayout &layout) {
+  const size_t blockCount = function.blocks.size();
+  std::vector<LiveLocals> liveIn(blockCount, LiveLocals(layout.localCount, 0));
+  std::vector<LiveLocals> liveOut(blockCount, LiveLocals(layout.localCount, 0));
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t blockIndex = blockCount; blockIndex-- > 0;) {
+      const IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+      if (!block.reachable) {
+        continue;
+      }
+      LiveLocals live(layout.localCount, 0);
+      for (const IrVirtualRegisterEdge &edge : block.successorEdges) {
+        const LiveLocals &successorLive = liveIn[edge.successorBlockIndex];
+        for (size_t local = 0; local < live.size(); ++local) {
+          live[local] |= successorLive[local];
+        }
+      }
+      liveOut[blockIndex] = live;
+      for (auto it = block.instructions.rbegin(); it != block.instructions.rend(); ++it) {
+        transferLiveLocals(it->instruction, layout, live);
+      }
+      if (live != liveIn[blockIndex]) {
+        liveIn[blockIndex] = std::move(live);
+        changed = true;
+      }
+    }
+  }
+  return liveOut;
+}
+
+size_t eliminateRedundantLoadsAndStores(FunctionRewriter &rewriter) {
+  IrVirtualRegisterFunction &function = rewriter.function();
+  const LocalLayout layout = computeLocalLayout(function);
+  const std::vector<LiveLocals> liveAtExit = computeLiveLocalsAtExit(function, layout);
+  size_t rewrites = 0;
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+    IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+    if (!block.reachable) {
+      continue;
+    }
+    LiveLocals live = liveAtExit[blockIndex];
+    for (size_t index = block.instructions.size(); index-- > 0;) {
+      const IrVirtualRegisterInstruction &current = block.instructions[index];
+      const IrInstruction &inst = current.instruction;
+      if (index > 0) {
+        const IrVirtualRegisterInstruction &previous = block.instructions[index - 1];
+        const IrInstruction &prev = previous.instruction;
+        // `store x; load x` with x dead afterwards: keep the value on the stack.
+        if (inst.op == IrOpcode::LoadLocal && prev.op == IrOpcode::StoreLocal && prev.imm == inst.imm &&
+            layout.isTracked(inst.imm) && live[static_cast<size_t>(inst.imm)] == 0) {
+          rewriter.remove(blockIndex, index - 1);
+          rewriter.remove(blockIndex, index);
+          ++rewrites;
+          --index;
+          continue;
+        }
+        // `load x; store x` writes back the value the local already holds.
+        if (inst.op == IrOpcode::StoreLocal && prev.op == IrOpcode::LoadLocal && prev.imm == inst.imm &&
+            current.useRegisters.size() == 1 && previous.defRegisters.size() == 1 &&
+            current.useRegisters.front() == previous.defRegisters.front()) {
+          rewriter.remove(blockIndex, index - 1);
+          rewriter.remove(blockIndex, index);
+          if (layout.isTracked(inst.imm)) {
+            live[static_cast<size_t>(inst.imm)] = 1;
+          }
+          ++rewrites;
+          --index;
+          continue;
+        }
+      }
+      transferLiveLocals(inst, layout, live);
+    }
+  }
+  return rewrites;
+}
+
+bool canDiscardValue(const FunctionRewriter &rewriter,
+                     const IrVirtualRegisterFunction &function,
+                     size_t blockIndex,
+                     uint32_t reg,
+                     size_t depth) {
+  if (depth > MaxDeadTreeDepth || rewriter.useCount(reg) != 1) {
+    return false;
+  }
+  const size_t index = rewriter.definitionInBlock(reg, blockIndex);
+  if (index == NoIndex) {
+    return false;
+  }
+  const IrVirtualRegisterInstruction &producer = function.blocks[blockIndex].instructions[index];
+  if (!isDiscardableOpcode(producer.instruction.op)) {
+    return false;
+  }
+  if (producer.instruction.op == IrOpcode::Dup) {
+    return true;
+  }
+  for (uint32_t operand : producer.useRegisters) {
+    if (!canDiscardValue(rewriter, function, blockIndex, operand, depth + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void discardValue(FunctionRewriter &rewriter, size_t blockIndex, uint32_t reg) {
+  const size_t index = rewriter.definitionInBlock(reg, blockIndex);
+  const IrVirtualRegisterInstruction &producer = rewriter.instruction(blockIndex, index);
+  rewriter.remove(blockIndex, index);
+  if (producer.instruction.op == IrOpcode::Dup) {
+    return;
+  }
+  for (uint32_t operand : producer.useRegisters) {
+    discardValue(rewriter, blockIndex, operand);
+  }
+}
+
+size_t eliminateDeadStores(FunctionRewriter &rewriter) {
+  IrVirtualRegisterFunction &function = rewriter.function();
+  const LocalLayout layout = computeLocalLayout(function);
+  const std::vector<LiveLocals> liveAtExit = computeLiveLocalsAtExit(function, layout);
+  size_t rewrites = 0;
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+    IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+    if (!block.reachable) {
+      continue;
+    }
+    LiveLocals live = liveAtExit[blockIndex];
+    for (size_t index = block.instructions.size(); index-- > 0;) {
+      IrInstruction &inst = block.instructions[index].instruction;
+      if (inst.op == IrOpcode::StoreLocal && layout.isTracked(inst.imm) &&
+          live[static_cast<size_t>(inst.imm)] == 0) {
+        inst.op = IrOpcode::Pop;
+        inst.imm = 0;
+        ++rewrites;
+        continue;
+      }
+      transferLiveLocals(inst, layout, live);
+    }
+
+    // Drop pops of values nobody else needs, together with the pure
+    // instructions that produced them.
+    for (size_t index = 0; index < block.instructions.size(); ++index) {
+      if (rewriter.isRemoved(blockIndex, index)) {
+        continue;
+      }
+      const IrVirtualRegisterInstruction &current = block.instructions[index];
+      if (current.instruction.op != IrOpcode::Pop || current.useRegisters.size() != 1) {
+        continue;
+      }
+      const uint32_t reg = current.useRegisters.front();
+      if (canDiscardValue(rewriter, function, blockIndex, reg, 0)) {
+        discardValue(rewriter, blockIndex, reg);
+        rewriter.remove(blockIndex, index);
+        ++rewrites;
+        continue;
+      }
+      // `dup; <consume copy>; pop` leaves the original for the pop only.
+      const size_t dupIndex = rewriter.dupReaderInBlock(reg, blockIndex);
+      if (rewriter.useCount(reg) == 2 && dupIndex != NoIndex && dupIndex < index &&
+          rewriter.definitionInBlock(reg, blockIndex) != NoIndex) {
+        rewriter.remove(blockIndex, dupIndex);
+        rewriter.remove(blockIndex, index);
+        ++rewrites;
+      }
+    }
+  }
+  return rewrites;
+}
+
+size_t runFunctionPass(IrVirtualRegisterFunction &function, OptimizationPass pass) {
+  FunctionRewriter rewriter(function);
+  size_t rewrites = 0;
+  switch (pass) {
+    case OptimizationPass::ConstantCopyPropagation:
+      rewrites = propagateLocalConstantsAndCopies(rewriter);
+      break;
+    case OptimizationPass::ConstantFolding:
+      rewrites = foldConstants(rewriter);
+      break;
+    case OptimizationPass::UnreachableBlockRemoval:
+      rewrites = removeUnreachableBlocks(rewriter);
+      break;
+    case OptimizationPass::RedundantLoadStoreElimination:
+      rewrites = eliminateRedundantLoadsAndStores(rewriter);
+      break;
+    case OptimizationPass::DeadStoreElimination:
+      rewrites = eliminateDeadStores(rewriter);
+      break;
+  }
+  rewriter.compact();
+  return rewrites;
+}
+
+} // namespace
+
+bool optimizeIrModule(IrModule &module, uint32_t level, IrOptimizationReport &report, std::string &error) {
+  error.clear();
+  report = {};
+  report.level = std::min(level, IrOptimizationMaxLevel);
+  report.instructionsBefore = countInstructions(module);
+  report.instructionsAfter = report.instructionsBefore;
+  if (report.level == 0) {
+    return true;
+  }
+  report.passes.reserve(PassPipeline.size());
+  for (OptimizationPass pass : PassPipeline) {
+    report.passes.push_back({passName(pass)});
+  }
+
+  const size_t maxRounds = report.level == 1 ? 1 : MaxOptimizationRounds;
+  for (size_t round = 0; round < maxRounds; ++round) {
+    ++report.rounds;
+    size_t roundRewrites = 0;
+    for (size_t passIndex = 0; passIndex < PassPipeline.size(); ++passIndex) {
+      IrOptimizationPassStats &stats = report.passes[passIndex];
+      IrVirtualRegisterModule virtualModule;
+      std::string loweringError;
+      if (!lowerIrModuleToBlockVirtualRegisters(module, virtualModule, loweringError)) {
+        report.stoppedReason = std::move(loweringError);
+        report.instructionsAfter = countInstructions(module);
+        return true;
+      }
+
+      ++stats.runs;
+      size_t passRewrites = 0;
+      for (IrVirtualRegisterFunction &function : virtualModule.functions) {
+        passRewrites += runFunctionPass(function, PassPipeline[passIndex]);
+      }
+      if (passRewrites == 0) {
+        continue;
+      }
+
+      IrModule optimized;
+      if (!liftBlockVirtualRegistersToIrModule(virtualModule, optimized, error)) {
+        error = "IR optimizer " + std::string(stats.name) + " pass failed: " + error;
+        return false;
+      }
+      optimized.schemaVersion = module.schemaVersion;
+      const size_t before = countInstructions(module);
+      const size_t after = countInstructions(optimized);
+      stats.rewrites += passRewrites;
+      stats.instructionsRemoved += before > after ? before - after : 0;
+      roundRewrites += passRewrites;
+      module = std::move(optimized);
+    }
+    if (roundRewrites == 0) {
+      break;
+    }
+  }
+
+  report.instructionsAfter = countInstructions(module);
+  return true;
+}
+
+} // namespace primec
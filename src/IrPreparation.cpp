@@ -4,6 +4,7 @@
 #include "primec/IrBackendProfiles.h"
 #include "primec/IrInliner.h"
 #include "primec/IrLowerer.h"
+#include "primec/IrOptimizer.h"
 #include "primec/IrValidation.h"
 
 #include <cstdlib>
@@ -54,6 +55,28 @@ bool validateRuntimeReflectionBackendSupport(const SemanticProgram &semanticProg
   return false;
 }
 
+void emitIrOptimizationReport(const IrOptimizationReport &report) {
+  std::cerr << "[ir-optimizer] "
+            << "{\"schema\":\"primestruct_ir_optimizer_v1\""
+            << ",\"level\":" << report.level
+            << ",\"rounds\":" << report.rounds
+            << ",\"instructions_before\":" << report.instructionsBefore
+            << ",\"instructions_after\":" << report.instructionsAfter
+            << ",\"stopped\":" << (report.stoppedReason.empty() ? "false" : "true")
+            << ",\"passes\":[";
+  for (size_t i = 0; i < report.passes.size(); ++i) {
+    const IrOptimizationPassStats &pass = report.passes[i];
+    if (i != 0) {
+      std::cerr << ",";
+    }
+    std::cerr << "{\"name\":\"" << pass.name << "\""
+              << ",\"runs\":" << pass.runs
+              << ",\"rewrites\":" << pass.rewrites
+              << ",\"instructions_removed\":" << pass.instructionsRemoved << "}";
+  }
+  std::cerr << "]}\n";
+}
+
 } // namespace
 
 const std::vector<IrPreparationPhaseManifestEntry> &irPreparationPhaseManifest() {
@@ -98,6 +121,22 @@ const std::vector<IrPreparationPhaseManifestEntry> &irPreparationPhaseManifest()
        "inlined IR module and selected IR validation target",
        "failure keeps inlined IR from reaching backend consumers",
        "backend emitters after inline-ir-calls"},
+      {"optimize-ir",
+       IrPreparationPhaseOwnership::IrPreparationValidatedIr,
+       IrPreparationPhaseOwnership::IrPreparationOptimizedIr,
+       IrPreparationPhaseAction::MutatesOutput,
+       true,
+       "validated (optionally inlined) IR module and Options::optimizationLevel",
+       "optimization rewrites instructions and jump targets and invalidates the prior validation result",
+       "validate-optimized-ir"},
+      {"validate-optimized-ir",
+       IrPreparationPhaseOwnership::IrPreparationOptimizedIr,
+       IrPreparationPhaseOwnership::IrPreparationValidatedIr,
+       IrPreparationPhaseAction::ValidatesOnly,
+       true,
+       "optimized IR module and selected IR validation target",
+       "failure keeps optimized IR from reaching backend consumers",
+       "backend emitters after optimize-ir"},
       {"release-lowered-ast-bodies",
        IrPreparationPhaseOwnership::CompilerAstStorage,
        IrPreparationPhaseOwnership::IrPreparationValidatedIr,
@@ -173,6 +212,25 @@ bool prepareIrModule(Program &program,
     }
   }
 
+  if (options.optimizationLevel > 0) {
+    IrOptimizationReport report;
+    if (!optimizeIrModule(ir, options.optimizationLevel, report, error)) {
+      failure.stage = IrPreparationFailureStage::Optimization;
+      failure.message = std::move(error);
+      diagnosticSink.setSummary(failure.message);
+      return false;
+    }
+    if (options.irOptimizationReport) {
+      emitIrOptimizationReport(report);
+    }
+    if (!validateIrModule(ir, validationTarget, error)) {
+      failure.stage = IrPreparationFailureStage::Validation;
+      failure.message = std::move(error);
+      diagnosticSink.setSummary(failure.message);
+      return false;
+    }
+  }
+
   releaseLoweredAstBodies(program);
   emitPostIrPreparationAstHeapEstimate(program);
 
@@ -50,6 +50,7 @@ size_t computeLocalCount(const IrFunction &function) {
       case IrOpcode::StoreLocal:
       case IrOpcode::AddressOfLocal:
       case IrOpcode::FileReadByte:
+      case IrOpcode::FileMapBytes:
         localCount = std::max(localCount, static_cast<size_t>(instruction.imm) + 1);
         break;
       default:
@@ -80,6 +81,8 @@ bool usesF32Helpers(IrOpcode opcode) {
     case IrOpcode::ConvertF32ToU64:
     case IrOpcode::ConvertF32ToF64:
     case IrOpcode::ConvertF64ToF32:
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathBinaryF32:
       return true;
     default:
       return false;
@@ -118,6 +121,8 @@ bool usesF64Helpers(IrOpcode opcode) {
     case IrOpcode::ConvertF64ToU64:
     case IrOpcode::ConvertF32ToF64:
     case IrOpcode::ConvertF64ToF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF64:
       return true;
     default:
       return false;
@@ -135,6 +140,29 @@ bool moduleUsesF64Helpers(const IrModule &module) {
   return false;
 }
 
+bool usesMathFunctions(IrOpcode opcode) {
+  switch (opcode) {
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool moduleUsesMathFunctions(const IrModule &module) {
+  for (const IrFunction &function : module.functions) {
+    for (const IrInstruction &instruction : function.instructions) {
+      if (usesMathFunctions(instruction.op)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool usesClampI32ConvertHelpers(IrOpcode opcode) {
   switch (opcode) {
     case IrOpcode::ConvertF32ToI32:
@@ -215,12 +243,27 @@ bool usesFileIoHelpers(IrOpcode opcode) {
     case IrOpcode::FileWriteString:
     case IrOpcode::FileWriteByte:
     case IrOpcode::FileWriteNewline:
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes:
+    case IrOpcode::FileMapBytes:
       return true;
     default:
       return false;
   }
 }
 
+bool moduleUsesFileByteRangeHelpers(const IrModule &module) {
+  for (const IrFunction &function : module.functions) {
+    for (const IrInstruction &instruction : function.instructions) {
+      if (instruction.op == IrOpcode::FileReadBytes || instruction.op == IrOpcode::FileWriteBytes ||
+          instruction.op == IrOpcode::FileMapBytes) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool moduleUsesFileIoHelpers(const IrModule &module) {
   for (const IrFunction &function : module.functions) {
     for (const IrInstruction &instruction : function.instructions) {
@@ -264,10 +307,12 @@ bool IrToCppEmitter::emitSource(const IrModule &module, std::string &out, std::s
   std::ostringstream body;
   const bool needsF32Helpers = moduleUsesF32Helpers(module);
   const bool needsF64Helpers = moduleUsesF64Helpers(module);
+  const bool needsMathFunctions = moduleUsesMathFunctions(module);
   const bool needsClampI32ConvertHelpers = moduleUsesClampI32ConvertHelpers(module);
   const bool needsClampI64ConvertHelpers = moduleUsesClampI64ConvertHelpers(module);
   const bool needsClampU64ConvertHelpers = moduleUsesClampU64ConvertHelpers(module);
   const bool needsFileIoHelpers = moduleUsesFileIoHelpers(module);
+  const bool needsFileByteRangeHelpers = moduleUsesFileByteRangeHelpers(module);
   body << "#include <algorithm>\n";
   body << "#include <cstddef>\n";
   body << "#include <cstdint>\n";
@@ -275,7 +320,8 @@ bool IrToCppEmitter::emitSource(const IrModule &module, std::string &out, std::s
   body << "#include <string>\n";
   body << "#include <deque>\n";
   body << "#include <vector>\n";
-  if (needsClampI32ConvertHelpers || needsClampI64ConvertHelpers || needsClampU64ConvertHelpers) {
+  if (needsMathFunctions || needsClampI32ConvertHelpers || needsClampI64ConvertHelpers ||
+      needsClampU64ConvertHelpers) {
     body << "#include <cmath>\n";
   }
   if (needsF32Helpers || needsF64Helpers) {
@@ -284,6 +330,10 @@ bool IrToCppEmitter::emitSource(const IrModule &module, std::string &out, std::s
   if (needsFileIoHelpers) {
     body << "#include <cerrno>\n";
     body << "#include <fcntl.h>\n";
+    if (needsFileByteRangeHelpers) {
+      body << "#include <sys/mman.h>\n";
+      body << "#include <sys/stat.h>\n";
+    }
     body << "#include <unistd.h>\n";
   }
   body << "\n";
@@ -562,6 +612,115 @@ bool IrToCppEmitter::emitSource(const IrModule &module, std::string &out, std::s
   body << "  }\n";
   body << "  return false;\n";
   body << "}\n\n";
+  if (needsFileByteRangeHelpers) {
+    body << "static bool psResolveSlotRange(uint64_t address,\n";
+    body << "                               uint64_t count,\n";
+    body << "                               std::vector<uint64_t> &locals,\n";
+    body << "                               std::vector<uint64_t> &heapSlots,\n";
+    body << "                               const std::vector<PsHeapAllocation> &heapAllocations,\n";
+    body << "                               uint64_t *&slotsOut) {\n";
+    body << "  if ((address % " << IrSlotBytes << "ull) != 0ull) {\n";
+    body << "    return false;\n";
+    body << "  }\n";
+    body << "  if ((address & ps_heap_address_tag) == 0ull) {\n";
+    body << "    uint64_t localIndex = address / " << IrSlotBytes << "ull;\n";
+    body << "    if (localIndex >= locals.size() || count > locals.size() - localIndex) {\n";
+    body << "      return false;\n";
+    body << "    }\n";
+    body << "    slotsOut = locals.data() + localIndex;\n";
+    body << "    return true;\n";
+    body << "  }\n";
+    body << "  uint64_t heapIndex = (address & ~ps_heap_address_tag) / " << IrSlotBytes << "ull;\n";
+    body << "  for (const auto &allocation : heapAllocations) {\n";
+    body << "    uint64_t baseIndex = static_cast<uint64_t>(allocation.baseIndex);\n";
+    body << "    uint64_t endIndex = baseIndex + static_cast<uint64_t>(allocation.slotCount);\n";
+    body << "    if (!allocation.live || heapIndex < baseIndex || heapIndex >= endIndex) {\n";
+    body << "      continue;\n";
+    body << "    }\n";
+    body << "    if (count > endIndex - heapIndex || endIndex > heapSlots.size()) {\n";
+    body << "      return false;\n";
+    body << "    }\n";
+    body << "    slotsOut = heapSlots.data() + heapIndex;\n";
+    body << "    return true;\n";
+    body << "  }\n";
+    body << "  return false;\n";
+    body << "}\n\n";
+    body << "static uint32_t psFileWriteBytes(int fd, const uint64_t *slots, uint64_t count) {\n";
+    body << "  unsigned char chunk[4096];\n";
+    body << "  for (uint64_t offset = 0; offset < count; offset += sizeof(chunk)) {\n";
+    body << "    std::size_t size = static_cast<std::size_t>(std::min<uint64_t>(sizeof(chunk), count - offset));\n";
+    body << "    for (std::size_t i = 0; i < size; ++i) {\n";
+    body << "      chunk[i] = static_cast<unsigned char>(slots[offset + i] & 0xffu);\n";
+    body << "    }\n";
+    body << "    uint32_t err = psWriteAll(fd, chunk, size);\n";
+    body << "    if (err != 0u) {\n";
+    body << "      return err;\n";
+    body << "    }\n";
+    body << "  }\n";
+    body << "  return 0u;\n";
+    body << "}\n\n";
+    body << "static uint32_t psFileReadBytes(int fd, uint64_t *slots, uint64_t count) {\n";
+    body << "  unsigned char chunk[4096];\n";
+    body << "  uint64_t done = 0;\n";
+    body << "  while (done < count) {\n";
+    body << "    std::size_t want = static_cast<std::size_t>(std::min<uint64_t>(sizeof(chunk), count - done));\n";
+    body << "    ssize_t got = ::read(fd, chunk, want);\n";
+    body << "    if (got < 0) {\n";
+    body << "      return errno == 0 ? 1u : static_cast<uint32_t>(errno);\n";
+    body << "    }\n";
+    body << "    if (got == 0) {\n";
+    body << "      return " << FileReadEofCode << "u;\n";
+    body << "    }\n";
+    body << "    for (ssize_t i = 0; i < got; ++i) {\n";
+    body << "      slots[done + static_cast<uint64_t>(i)] = static_cast<uint64_t>(chunk[i]);\n";
+    body << "    }\n";
+    body << "    done += static_cast<uint64_t>(got);\n";
+    body << "  }\n";
+    body << "  return 0u;\n";
+    body << "}\n\n";
+    // Generated code has no tagged view addresses, so the mapping is expanded
+    // into a fresh heap array (count slot, then one byte per slot) and
+    // released before returning.
+    body << "static uint32_t psFileMapBytes(int fd,\n";
+    body << "                               std::vector<uint64_t> &heapSlots,\n";
+    body << "                               std::vector<PsHeapAllocation> &heapAllocations,\n";
+    body << "                               uint64_t &addressOut) {\n";
+    body << "  struct stat info {};\n";
+    body << "  if (::fstat(fd, &info) != 0) {\n";
+    body << "    return errno == 0 ? 1u : static_cast<uint32_t>(errno);\n";
+    body << "  }\n";
+    body << "  if (!S_ISREG(info.st_mode)) {\n";
+    body << "    return static_cast<uint32_t>(ENODEV);\n";
+    body << "  }\n";
+    body << "  uint64_t size = static_cast<uint64_t>(info.st_size);\n";
+    body << "  const unsigned char *bytes = nullptr;\n";
+    body << "  if (size != 0ull) {\n";
+    body << "    void *data = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);\n";
+    body << "    if (data == MAP_FAILED) {\n";
+    body << "      return errno == 0 ? 1u : static_cast<uint32_t>(errno);\n";
+    body << "    }\n";
+    body << "    bytes = static_cast<const unsigned char *>(data);\n";
+    body << "  }\n";
+    body << "  uint64_t address = 0;\n";
+    body << "  if (!psHeapAlloc(size + 1ull, heapSlots, heapAllocations, address)) {\n";
+    body << "    if (bytes != nullptr) {\n";
+    body << "      ::munmap(const_cast<unsigned char *>(bytes), static_cast<std::size_t>(size));\n";
+    body << "    }\n";
+    body << "    return static_cast<uint32_t>(ENOMEM);\n";
+    body << "  }\n";
+    body << "  std::size_t baseIndex = static_cast<std::size_t>((address & ~ps_heap_address_tag) / "
+         << IrSlotBytes << "ull);\n";
+    body << "  heapSlots[baseIndex] = size;\n";
+    body << "  for (uint64_t i = 0; i < size; ++i) {\n";
+    body << "    heapSlots[baseIndex + 1 + static_cast<std::size_t>(i)] = static_cast<uint64_t>(bytes[i]);\n";
+    body << "  }\n";
+    body << "  if (bytes != nullptr) {\n";
+    body << "    ::munmap(const_cast<unsigned char *>(bytes), static_cast<std::size_t>(size));\n";
+    body << "  }\n";
+    body << "  addressOut = address;\n";
+    body << "  return 0u;\n";
+    body << "}\n\n";
+  }
   body << "struct PsStack {\n";
   body << "  explicit PsStack(std::size_t initialSize) : slots(initialSize, 0ull) {}\n";
   body << "  uint64_t &operator[](std::size_t index) {\n";
@@ -529,6 +529,33 @@ bool emitInstruction(const IrInstruction &instruction,
       out << "        pc = " << nextIndex << ";\n";
       out << "        break;\n";
       return true;
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64: {
+      if (!isValidIrMathFunctionImm(instruction.op, instruction.imm)) {
+        error = "IrToCppEmitter invalid math function at instruction " + std::to_string(index);
+        return false;
+      }
+      const bool isF64 = instruction.op == IrOpcode::MathUnaryF64 || instruction.op == IrOpcode::MathBinaryF64;
+      const bool isBinary = instruction.op == IrOpcode::MathBinaryF32 || instruction.op == IrOpcode::MathBinaryF64;
+      const char *valueType = isF64 ? "double" : "float";
+      const char *fromBits = isF64 ? "psBitsToF64" : "psBitsToF32";
+      const char *toBits = isF64 ? "psF64ToBits" : "psF32ToBits";
+      const char *name = irMathFunctionName(static_cast<IrMathFunction>(instruction.imm));
+      emitStackUnderflowGuard(isBinary ? 2 : 1, name);
+      if (isBinary) {
+        out << "        " << valueType << " right = " << fromBits << "(stack[--sp]);\n";
+        out << "        " << valueType << " left = " << fromBits << "(stack[--sp]);\n";
+        out << "        stack[sp++] = " << toBits << "(std::" << name << "(left, right));\n";
+      } else {
+        out << "        " << valueType << " value = " << fromBits << "(stack[sp - 1]);\n";
+        out << "        stack[sp - 1] = " << toBits << "(std::" << name << "(value));\n";
+      }
+      out << "        pc = " << nextIndex << ";\n";
+      out << "        break;\n";
+      return true;
+    }
     case IrOpcode::Jump:
       if (instruction.imm > instructionCount) {
         error = "IrToCppEmitter jump target out of range at instruction " + std::to_string(index);
@@ -588,6 +615,9 @@ bool emitInstruction(const IrInstruction &instruction,
     case IrOpcode::FileWriteByte:
     case IrOpcode::FileReadByte:
     case IrOpcode::FileWriteNewline:
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes:
+    case IrOpcode::FileMapBytes:
     case IrOpcode::LoadStringByte:
     case IrOpcode::LoadStringLength:
       return emitPrintAndFileInstruction(instruction, index, nextIndex, localCount, context, out, error);
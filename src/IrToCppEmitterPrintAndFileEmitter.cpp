@@ -284,6 +284,44 @@ bool emitPrintAndFileInstruction(const IrInstruction &instruction,
       out << "        pc = " << nextIndex << ";\n";
       out << "        break;\n";
       return true;
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes: {
+      const bool isRead = instruction.op == IrOpcode::FileReadBytes;
+      emitStackUnderflowGuard(3, isRead ? "file read" : "file write");
+      out << "        uint64_t fileBytesCount = stack[--sp];\n";
+      out << "        uint64_t fileBytesAddress = stack[--sp];\n";
+      out << "        uint64_t fileBytesHandle = stack[--sp];\n";
+      out << "        uint64_t *fileBytesSlots = nullptr;\n";
+      out << "        if (fileBytesCount != 0ull && !psResolveSlotRange(fileBytesAddress, fileBytesCount, locals, "
+             "heapSlots, heapAllocations, fileBytesSlots)) {\n";
+      out << "          std::cerr << \"invalid indirect address in IR\\n\";\n";
+      out << "          return 1;\n";
+      out << "        }\n";
+      out << "        int fileBytesFd = static_cast<int>(fileBytesHandle & 0xffffffffu);\n";
+      out << "        stack[sp++] = static_cast<uint64_t>("
+          << (isRead ? "psFileReadBytes" : "psFileWriteBytes")
+          << "(fileBytesFd, fileBytesSlots, fileBytesCount));\n";
+      out << "        pc = " << nextIndex << ";\n";
+      out << "        break;\n";
+      return true;
+    }
+    case IrOpcode::FileMapBytes:
+      if (instruction.imm >= localCount) {
+        error = "IrToCppEmitter local index out of range at instruction " + std::to_string(index);
+        return false;
+      }
+      emitStackUnderflowGuard(1, "file map");
+      out << "        uint64_t fileMapHandle = stack[--sp];\n";
+      out << "        int fileMapFd = static_cast<int>(fileMapHandle & 0xffffffffu);\n";
+      out << "        uint64_t fileMapAddress = 0;\n";
+      out << "        uint32_t fileMapErr = psFileMapBytes(fileMapFd, heapSlots, heapAllocations, fileMapAddress);\n";
+      out << "        if (fileMapErr == 0u) {\n";
+      out << "          locals[" << instruction.imm << "] = fileMapAddress;\n";
+      out << "        }\n";
+      out << "        stack[sp++] = static_cast<uint64_t>(fileMapErr);\n";
+      out << "        pc = " << nextIndex << ";\n";
+      out << "        break;\n";
+      return true;
     case IrOpcode::FileWriteNewline:
       emitStackUnderflowGuard(1, "file write");
       out << "        uint64_t fileLineHandle = stack[--sp];\n";
@@ -611,6 +611,13 @@ bool emitInstruction(const IrInstruction &instruction,
       out << "        pc = " << nextIndex << ";\n";
       out << "        break;\n";
       return true;
+    case IrOpcode::FileWriteBytes:
+      out << "        // GLSL backend cannot write files; consume count/address/handle and push deterministic success code.\n";
+      out << "        sp -= 3;\n";
+      out << "        stack[sp++] = 0;\n";
+      out << "        pc = " << nextIndex << ";\n";
+      out << "        break;\n";
+      return true;
     case IrOpcode::FileWriteNewline:
       out << "        // GLSL backend cannot write files; replace handle with deterministic success code.\n";
       out << "        stack[sp - 1] = 0;\n";
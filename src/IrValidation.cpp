@@ -9,7 +9,7 @@ namespace primec {
 namespace {
 
 constexpr uint8_t MinOpcode = static_cast<uint8_t>(IrOpcode::PushI32);
-constexpr uint8_t MaxOpcode = static_cast<uint8_t>(IrOpcode::FileWriteStringDynamic);
+constexpr uint8_t MaxOpcode = static_cast<uint8_t>(IrOpcode::MathBinaryF64);
 constexpr uint64_t MaxGlslLocalIndex = 1023;
 constexpr uint32_t MaxCallParameterCount = 4096;
 constexpr uint64_t KnownEffectMask = EffectIoOut | EffectIoErr | EffectHeapAlloc | EffectPathSpaceNotify |
@@ -102,6 +102,7 @@ bool isGlslOpcodeAllowed(IrOpcode op) {
     case IrOpcode::FileWriteStringDynamic:
     case IrOpcode::FileWriteByte:
     case IrOpcode::FileWriteNewline:
+    case IrOpcode::FileWriteBytes:
     case IrOpcode::PushF32:
     case IrOpcode::PushF64:
     case IrOpcode::AddF32:
@@ -224,6 +225,10 @@ bool isWasmOpcodeAllowedWasi(IrOpcode op) {
     case IrOpcode::ConvertF64ToU64:
     case IrOpcode::ConvertF32ToF64:
     case IrOpcode::ConvertF64ToF32:
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64:
     case IrOpcode::PrintI32:
     case IrOpcode::PrintI64:
     case IrOpcode::PrintU64:
@@ -451,6 +456,7 @@ bool validateFunction(const IrModule &module,
       case IrOpcode::StoreLocal:
       case IrOpcode::AddressOfLocal:
       case IrOpcode::FileReadByte:
+      case IrOpcode::FileMapBytes:
         if (inst.imm > static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())) {
           return failInstruction(functionIndex, function.name, instructionIndex, "local index exceeds 32-bit limit", error);
         }
@@ -496,6 +502,14 @@ bool validateFunction(const IrModule &module,
         break;
       case IrOpcode::LoadStringLength:
         break;
+      case IrOpcode::MathUnaryF32:
+      case IrOpcode::MathUnaryF64:
+      case IrOpcode::MathBinaryF32:
+      case IrOpcode::MathBinaryF64:
+        if (!isValidIrMathFunctionImm(inst.op, inst.imm)) {
+          return failInstruction(functionIndex, function.name, instructionIndex, "invalid math function", error);
+        }
+        break;
       default:
         break;
     }
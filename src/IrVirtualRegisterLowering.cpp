@@ -73,7 +73,6 @@ bool stackEffectForOpcode(const IrInstruction &inst, const IrModule &module, Sta
       return true;
     case IrOpcode::LoadIndirect:
     case IrOpcode::HeapAlloc:
-    case IrOpcode::HeapRealloc:
     case IrOpcode::NegI32:
     case IrOpcode::NegI64:
     case IrOpcode::NegF32:
@@ -92,9 +91,12 @@ bool stackEffectForOpcode(const IrInstruction &inst, const IrModule &module, Sta
     case IrOpcode::ConvertF64ToU64:
     case IrOpcode::ConvertF32ToF64:
     case IrOpcode::ConvertF64ToF32:
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
     case IrOpcode::FileClose:
     case IrOpcode::FileFlush:
     case IrOpcode::FileReadByte:
+    case IrOpcode::FileMapBytes:
     case IrOpcode::FileWriteString:
     case IrOpcode::FileWriteNewline:
     case IrOpcode::LoadStringByte:
@@ -102,6 +104,7 @@ bool stackEffectForOpcode(const IrInstruction &inst, const IrModule &module, Sta
       out = {1, 1, 0};
       return true;
     case IrOpcode::StoreIndirect:
+    case IrOpcode::HeapRealloc:
     case IrOpcode::AddI32:
     case IrOpcode::SubI32:
     case IrOpcode::MulI32:
@@ -119,6 +122,8 @@ bool stackEffectForOpcode(const IrInstruction &inst, const IrModule &module, Sta
     case IrOpcode::SubF64:
     case IrOpcode::MulF64:
     case IrOpcode::DivF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64:
     case IrOpcode::CmpEqI32:
     case IrOpcode::CmpNeI32:
     case IrOpcode::CmpLtI32:
@@ -154,6 +159,10 @@ bool stackEffectForOpcode(const IrInstruction &inst, const IrModule &module, Sta
     case IrOpcode::FileWriteByte:
       out = {2, 1, 0};
       return true;
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes:
+      out = {3, 1, 0};
+      return true;
     case IrOpcode::Dup:
       out = {0, 1, 1};
       return true;
@@ -281,6 +290,7 @@ bool buildBlockGraph(const IrFunction &function,
 
 bool propagateReachableStackDepths(const IrFunction &function,
                                    const IrModule &module,
+                                   int64_t entryDepth,
                                    std::vector<BlockBuildInfo> &blocks,
                                    std::string &error) {
   error.clear();
@@ -289,7 +299,7 @@ bool propagateReachableStackDepths(const IrFunction &function,
   }
 
   std::vector<size_t> worklist;
-  blocks[0].entryDepth = 0;
+  blocks[0].entryDepth = entryDepth;
   worklist.push_back(0);
 
   while (!worklist.empty()) {
@@ -337,12 +347,14 @@ bool propagateReachableStackDepths(const IrFunction &function,
 
 bool lowerFunctionToVirtualRegisters(const IrFunction &function,
                                      const IrModule &module,
+                                     int64_t entryDepth,
                                      IrVirtualRegisterFunction &out,
                                      std::string &error) {
   error.clear();
   out = {};
   out.name = function.name;
   out.metadata = function.metadata;
+  out.parameterCount = function.parameterCount;
   out.localDebugSlots = function.localDebugSlots;
   if (function.instructions.empty()) {
     return true;
@@ -357,7 +369,7 @@ bool lowerFunctionToVirtualRegisters(const IrFunction &function,
   if (!buildBlockGraph(function, leaders, blockInfo, error)) {
     return false;
   }
-  if (!propagateReachableStackDepths(function, module, blockInfo, error)) {
+  if (!propagateReachableStackDepths(function, module, entryDepth, blockInfo, error)) {
     return false;
   }
 
@@ -462,6 +474,41 @@ bool lowerFunctionToVirtualRegisters(const IrFunction &function,
   return true;
 }
 
+bool liftFunctionBlocks(const IrVirtualRegisterFunction &function,
+                        std::vector<IrInstruction> &out,
+                        std::string &error) {
+  std::vector<std::pair<size_t, size_t>> liftedBlockStarts;
+  liftedBlockStarts.reserve(function.blocks.size());
+  size_t originalEnd = 0;
+  for (const IrVirtualRegisterBlock &block : function.blocks) {
+    liftedBlockStarts.push_back({block.startInstructionIndex, out.size()});
+    originalEnd = std::max(originalEnd, block.endInstructionIndex);
+    for (const IrVirtualRegisterInstruction &instruction : block.instructions) {
+      out.push_back(instruction.instruction);
+    }
+  }
+  std::sort(liftedBlockStarts.begin(), liftedBlockStarts.end());
+
+  for (IrInstruction &instruction : out) {
+    if (instruction.op != IrOpcode::Jump && instruction.op != IrOpcode::JumpIfZero) {
+      continue;
+    }
+    if (instruction.imm == originalEnd) {
+      instruction.imm = out.size();
+      continue;
+    }
+    const auto it = std::lower_bound(liftedBlockStarts.begin(),
+                                     liftedBlockStarts.end(),
+                                     std::pair<size_t, size_t>{static_cast<size_t>(instruction.imm), 0});
+    if (it == liftedBlockStarts.end() || it->first != instruction.imm) {
+      error = "jump target " + std::to_string(instruction.imm) + " is not a block start";
+      return false;
+    }
+    instruction.imm = it->second;
+  }
+  return true;
+}
+
 } // namespace
 
 bool lowerIrModuleToBlockVirtualRegisters(const IrModule &module, IrVirtualRegisterModule &out, std::string &error) {
@@ -474,7 +521,7 @@ bool lowerIrModuleToBlockVirtualRegisters(const IrModule &module, IrVirtualRegis
   out.functions.resize(module.functions.size());
 
   for (size_t functionIndex = 0; functionIndex < module.functions.size(); ++functionIndex) {
-    if (!lowerFunctionToVirtualRegisters(module.functions[functionIndex], module, out.functions[functionIndex], error)) {
+    if (!lowerFunctionToVirtualRegisters(module.functions[functionIndex], module, 0, out.functions[functionIndex], error)) {
       if (!error.empty()) {
         error = "virtual-register lowering failed in function " + module.functions[functionIndex].name + ": " + error;
       }
@@ -484,6 +531,26 @@ bool lowerIrModuleToBlockVirtualRegisters(const IrModule &module, IrVirtualRegis
   return true;
 }
 
+bool lowerIrFunctionToBlockVirtualRegisters(const IrModule &module,
+                                            size_t functionIndex,
+                                            IrVirtualRegisterFunction &out,
+                                            std::string &error) {
+  error.clear();
+  out = {};
+  if (functionIndex >= module.functions.size()) {
+    error = "virtual-register lowering function index out of range";
+    return false;
+  }
+  const IrFunction &function = module.functions[functionIndex];
+  if (!lowerFunctionToVirtualRegisters(function, module, function.parameterCount, out, error)) {
+    if (!error.empty()) {
+      error = "virtual-register lowering failed in function " + module.functions[functionIndex].name + ": " + error;
+    }
+    return false;
+  }
+  return true;
+}
+
 bool liftBlockVirtualRegistersToIrModule(const IrVirtualRegisterModule &virtualModule, IrModule &out, std::string &error) {
   error.clear();
   out = {};
@@ -497,11 +564,11 @@ bool liftBlockVirtualRegistersToIrModule(const IrVirtualRegisterModule &virtualM
     IrFunction loweredFunction;
     loweredFunction.name = virtualFunction.name;
     loweredFunction.metadata = virtualFunction.metadata;
+    loweredFunction.parameterCount = virtualFunction.parameterCount;
     loweredFunction.localDebugSlots = virtualFunction.localDebugSlots;
-    for (const IrVirtualRegisterBlock &block : virtualFunction.blocks) {
-      for (const IrVirtualRegisterInstruction &instruction : block.instructions) {
-        loweredFunction.instructions.push_back(instruction.instruction);
-      }
+    if (!liftFunctionBlocks(virtualFunction, loweredFunction.instructions, error)) {
+      error = "virtual-register lift failed in function " + virtualFunction.name + ": " + error;
+      return false;
     }
     out.functions.push_back(std::move(loweredFunction));
   }
@@ -43,6 +43,11 @@ bool isRegisterSpilled(const std::vector<std::optional<AssignmentLookupEntry>> &
 
 uint32_t opcodeBaseLatency(IrOpcode op) {
   switch (op) {
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64:
+      return 20;
     case IrOpcode::DivI32:
     case IrOpcode::DivI64:
     case IrOpcode::DivU64:
@@ -127,6 +132,7 @@ bool isSchedulingBarrierOpcode(IrOpcode op) {
     case IrOpcode::FileOpenWriteDynamic:
     case IrOpcode::FileOpenAppendDynamic:
     case IrOpcode::FileReadByte:
+    case IrOpcode::FileMapBytes:
     case IrOpcode::FileClose:
     case IrOpcode::FileFlush:
     case IrOpcode::FileWriteI32:
@@ -136,6 +142,8 @@ bool isSchedulingBarrierOpcode(IrOpcode op) {
     case IrOpcode::FileWriteStringDynamic:
     case IrOpcode::FileWriteByte:
     case IrOpcode::FileWriteNewline:
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes:
       return true;
     default:
       return false;
@@ -92,6 +92,7 @@ bool verifyBarrierOrdering(const IrVirtualRegisterBlock &originalBlock,
       case IrOpcode::FileOpenWriteDynamic:
       case IrOpcode::FileOpenAppendDynamic:
       case IrOpcode::FileReadByte:
+      case IrOpcode::FileMapBytes:
       case IrOpcode::FileClose:
       case IrOpcode::FileFlush:
       case IrOpcode::FileWriteI32:
@@ -101,6 +102,8 @@ bool verifyBarrierOrdering(const IrVirtualRegisterBlock &originalBlock,
       case IrOpcode::FileWriteStringDynamic:
       case IrOpcode::FileWriteByte:
       case IrOpcode::FileWriteNewline:
+      case IrOpcode::FileReadBytes:
+      case IrOpcode::FileWriteBytes:
         return true;
       default:
         return false;
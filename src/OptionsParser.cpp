@@ -42,6 +42,43 @@ bool parseDebugJsonSnapshotMode(std::string_view value, DebugJsonSnapshotMode &o
   return false;
 }
 
+bool parseVmEngineMode(std::string_view value, VmEngineMode &out) {
+  if (value == "checked") {
+    out = VmEngineMode::Checked;
+    return true;
+  }
+  if (value == "fast") {
+    out = VmEngineMode::Fast;
+    return true;
+  }
+  return false;
+}
+
+bool parseNativeCodegenMode(std::string_view value, NativeCodegenMode &out) {
+  if (value == "stack") {
+    out = NativeCodegenMode::Stack;
+    return true;
+  }
+  if (value == "regalloc") {
+    out = NativeCodegenMode::RegisterAllocated;
+    return true;
+  }
+  return false;
+}
+
+// Accepts -O0, -O1, -O2, and bare -O (same as -O1).
+bool parseOptimizationLevel(std::string_view flag, uint32_t &out) {
+  if (flag == "-O") {
+    out = 1;
+    return true;
+  }
+  if (flag.size() != 3 || flag[2] < '0' || flag[2] > '2') {
+    return false;
+  }
+  out = static_cast<uint32_t>(flag[2] - '0');
+  return true;
+}
+
 bool normalizeWasmProfile(const std::string &value, std::string &normalized) {
   if (value == "wasi" || value == "wasm-wasi") {
     normalized = "wasi";
@@ -784,6 +821,43 @@ bool parseOptions(int argc, char **argv, OptionsParserMode mode, Options &out, s
       out.benchmarkSemanticDefinitionValidationWorkerCount = workerCount;
     } else if (arg == "--ir-inline") {
       out.inlineIrCalls = true;
+    } else if (arg.rfind("-O", 0) == 0) {
+      if (!parseOptimizationLevel(arg, out.optimizationLevel)) {
+        error = "unsupported optimization level: " + arg + " (expected -O0|-O1|-O2)";
+        return false;
+      }
+    } else if (arg == "--ir-opt-report") {
+      out.irOptimizationReport = true;
+    } else if (arg == "--vm-engine" && i + 1 < argc) {
+      const std::string value = argv[++i];
+      if (!parseVmEngineMode(value, out.vmEngine)) {
+        error = "unsupported --vm-engine value: " + value + " (expected checked|fast)";
+        return false;
+      }
+    } else if (arg == "--vm-engine") {
+      error = "--vm-engine requires a value";
+      return false;
+    } else if (arg.rfind("--vm-engine=", 0) == 0) {
+      const std::string value = arg.substr(std::string("--vm-engine=").size());
+      if (!parseVmEngineMode(value, out.vmEngine)) {
+        error = "unsupported --vm-engine value: " + value + " (expected checked|fast)";
+        return false;
+      }
+    } else if (arg == "--native-codegen" && i + 1 < argc) {
+      const std::string value = argv[++i];
+      if (!parseNativeCodegenMode(value, out.nativeCodegen)) {
+        error = "unsupported --native-codegen value: " + value + " (expected stack|regalloc)";
+        return false;
+      }
+    } else if (arg == "--native-codegen") {
+      error = "--native-codegen requires a value";
+      return false;
+    } else if (arg.rfind("--native-codegen=", 0) == 0) {
+      const std::string value = arg.substr(std::string("--native-codegen=").size());
+      if (!parseNativeCodegenMode(value, out.nativeCodegen)) {
+        error = "unsupported --native-codegen value: " + value + " (expected stack|regalloc)";
+        return false;
+      }
     } else if (!arg.empty() && arg[0] == '-') {
       error = "unknown option: " + arg;
       return false;
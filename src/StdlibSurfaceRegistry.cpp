@@ -31,6 +31,10 @@ constexpr auto FileHelperMembers = std::to_array<std::string_view>({
     "write_byte",
     "writeBytes",
     "write_bytes",
+    "readBytes",
+    "read_bytes",
+    "mapBytes",
+    "map_bytes",
     "flush",
     "close",
 });
@@ -45,6 +49,8 @@ constexpr auto FileHelperCompatibilitySpellings = std::to_array<std::string_view
     "/file/read_byte",
     "/file/write_byte",
     "/file/write_bytes",
+    "/file/read_bytes",
+    "/file/map_bytes",
     "/file/flush",
 });
 
@@ -59,6 +65,8 @@ constexpr auto FileHelperLoweringSpellings = std::to_array<std::string_view>({
     "/file/read_byte",
     "/file/write_byte",
     "/file/write_bytes",
+    "/file/read_bytes",
+    "/file/map_bytes",
     "/file/flush",
     "/file/close",
 });
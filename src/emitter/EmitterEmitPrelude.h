@@ -10,6 +10,7 @@
   out << "#include <functional>\n";
   out << "#include <string>\n";
   out << "#include <string_view>\n";
+  out << "#include <sys/mman.h>\n";
   out << "#include <sys/stat.h>\n";
   out << "#include <unistd.h>\n";
   out << "#include <type_traits>\n";
@@ -661,16 +662,63 @@
   out << "}\n";
   out << "template <typename T>\n";
   out << "static inline uint32_t ps_file_write_bytes(const ps_file_handle &file, const std::vector<T> &bytes) {\n";
+  out << "  uint8_t chunk[4096];\n";
   out << "  uint32_t err = 0;\n";
-  out << "  for (const auto &value : bytes) {\n";
-  out << "    if (err != 0) {\n";
-  out << "      break;\n";
+  out << "  for (size_t offset = 0; offset < bytes.size() && err == 0; offset += sizeof(chunk)) {\n";
+  out << "    const size_t remaining = bytes.size() - offset;\n";
+  out << "    const size_t count = remaining < sizeof(chunk) ? remaining : sizeof(chunk);\n";
+  out << "    for (size_t i = 0; i < count; ++i) {\n";
+  out << "      chunk[i] = static_cast<uint8_t>(bytes[offset + i]);\n";
   out << "    }\n";
-  out << "    uint8_t byte = static_cast<uint8_t>(value);\n";
-  out << "    err = ps_file_write_all(file.fd, &byte, 1);\n";
+  out << "    err = ps_file_write_all(file.fd, chunk, count);\n";
   out << "  }\n";
   out << "  return err;\n";
   out << "}\n";
+  out << "template <typename T>\n";
+  out << "static inline uint32_t ps_file_read_bytes(const ps_file_handle &file, std::vector<T> &bytes) {\n";
+  out << "  uint8_t chunk[4096];\n";
+  out << "  size_t offset = 0;\n";
+  out << "  while (offset < bytes.size()) {\n";
+  out << "    const size_t remaining = bytes.size() - offset;\n";
+  out << "    const size_t want = remaining < sizeof(chunk) ? remaining : sizeof(chunk);\n";
+  out << "    ssize_t rc = ::read(file.fd, chunk, want);\n";
+  out << "    if (rc < 0) {\n";
+  out << "      return ps_errno_value();\n";
+  out << "    }\n";
+  out << "    if (rc == 0) {\n";
+  out << "      return " << FileReadEofCode << "u;\n";
+  out << "    }\n";
+  out << "    for (ssize_t i = 0; i < rc; ++i) {\n";
+  out << "      bytes[offset++] = static_cast<T>(chunk[i]);\n";
+  out << "    }\n";
+  out << "  }\n";
+  out << "  return 0u;\n";
+  out << "}\n";
+  out << "template <typename T>\n";
+  out << "static inline uint32_t ps_file_map_bytes(const ps_file_handle &file, std::vector<T> &bytes) {\n";
+  out << "  struct stat info {};\n";
+  out << "  if (::fstat(file.fd, &info) != 0) {\n";
+  out << "    return ps_errno_value();\n";
+  out << "  }\n";
+  out << "  if (!S_ISREG(info.st_mode)) {\n";
+  out << "    return static_cast<uint32_t>(ENODEV);\n";
+  out << "  }\n";
+  out << "  const size_t size = static_cast<size_t>(info.st_size);\n";
+  out << "  bytes.resize(size);\n";
+  out << "  if (size == 0) {\n";
+  out << "    return 0u;\n";
+  out << "  }\n";
+  out << "  void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0);\n";
+  out << "  if (data == MAP_FAILED) {\n";
+  out << "    return ps_errno_value();\n";
+  out << "  }\n";
+  out << "  const uint8_t *mapped = static_cast<const uint8_t *>(data);\n";
+  out << "  for (size_t i = 0; i < size; ++i) {\n";
+  out << "    bytes[i] = static_cast<T>(mapped[i]);\n";
+  out << "  }\n";
+  out << "  ::munmap(data, size);\n";
+  out << "  return 0u;\n";
+  out << "}\n";
   out << "static inline uint32_t ps_file_flush(const ps_file_handle &file) {\n";
   out << "  int rc = ::fsync(file.fd);\n";
   out << "  return (rc < 0) ? ps_errno_value() : 0u;\n";
@@ -46,8 +46,9 @@
             << "))";
         return out.str();
       }
-      if (expr.name == "write_bytes" && expr.args.size() == 2) {
-        out << "ps_result_status_from_error(ps_file_write_bytes(" << receiver << ", "
+      if ((expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes") &&
+          expr.args.size() == 2) {
+        out << "ps_result_status_from_error(ps_file_" << expr.name << "(" << receiver << ", "
             << emitExpr(expr.args[1], nameMap, paramMap, defMap, structTypeMap, importAliases, localTypes, returnKinds,
                         resultInfos, returnStructs, allowMathBare)
             << "))";
@@ -388,79 +388,85 @@ bool emitFileWriteBytesCall(const Expr &expr,
                             const EmitExprForWriteFn &emitExpr,
                             const AllocTempLocalForWriteFn &allocTempLocal,
                             const EmitInstructionForWriteFn &emitInstruction,
-                            const GetInstructionCountForWriteFn &getInstructionCount,
-                            const PatchInstructionImmForWriteFn &patchInstructionImm,
                             std::string &error) {
   if (expr.args.size() != 2) {
     error = "write_bytes requires exactly one argument";
     return false;
   }
-  return emitFileWriteBytesLoop(expr.args[1],
-                                handleIndex,
-                                emitExpr,
-                                allocTempLocal,
-                                emitInstruction,
-                                getInstructionCount,
-                                patchInstructionImm);
+  return emitFileBytesRange(
+      expr.args[1], handleIndex, IrOpcode::FileWriteBytes, emitExpr, allocTempLocal, emitInstruction);
 }
 
-bool emitFileWriteBytesLoop(const Expr &bytesExpr,
-                            int32_t handleIndex,
-                            const EmitExprForWriteFn &emitExpr,
-                            const AllocTempLocalForWriteFn &allocTempLocal,
-                            const EmitInstructionForWriteFn &emitInstruction,
-                            const GetInstructionCountForWriteFn &getInstructionCount,
-                            const PatchInstructionImmForWriteFn &patchInstructionImm) {
+bool emitFileReadBytesCall(const Expr &expr,
+                           const LocalMap &localsIn,
+                           int32_t handleIndex,
+                           const EmitExprForWriteFn &emitExpr,
+                           const AllocTempLocalForWriteFn &allocTempLocal,
+                           const EmitInstructionForWriteFn &emitInstruction,
+                           std::string &error) {
+  if (expr.args.size() != 2) {
+    error = "read_bytes requires exactly one argument";
+    return false;
+  }
+  if (expr.args[1].kind != Expr::Kind::Name) {
+    error = "read_bytes requires mutable array binding";
+    return false;
+  }
+  auto it = localsIn.find(expr.args[1].name);
+  if (it == localsIn.end() || !it->second.isMutable || it->second.kind != LocalInfo::Kind::Array) {
+    error = "read_bytes requires mutable array binding";
+    return false;
+  }
+  return emitFileBytesRange(
+      expr.args[1], handleIndex, IrOpcode::FileReadBytes, emitExpr, allocTempLocal, emitInstruction);
+}
+
+bool emitFileMapBytesCall(const Expr &expr,
+                          const LocalMap &localsIn,
+                          int32_t handleIndex,
+                          const EmitInstructionForWriteFn &emitInstruction,
+                          std::string &error) {
+  if (expr.args.size() != 2) {
+    error = "map_bytes requires exactly one argument";
+    return false;
+  }
+  if (expr.args[1].kind != Expr::Kind::Name) {
+    error = "map_bytes requires mutable array binding";
+    return false;
+  }
+  auto it = localsIn.find(expr.args[1].name);
+  if (it == localsIn.end() || !it->second.isMutable || it->second.kind != LocalInfo::Kind::Array) {
+    error = "map_bytes requires mutable array binding";
+    return false;
+  }
+  // FileMapBytes rebinds the array local to a read-only view of the whole
+  // file laid out like any other array (count slot, then one byte per slot).
+  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(handleIndex));
+  emitInstruction(IrOpcode::FileMapBytes, static_cast<uint64_t>(it->second.index));
+  return true;
+}
+
+bool emitFileBytesRange(const Expr &bytesExpr,
+                        int32_t handleIndex,
+                        IrOpcode op,
+                        const EmitExprForWriteFn &emitExpr,
+                        const AllocTempLocalForWriteFn &allocTempLocal,
+                        const EmitInstructionForWriteFn &emitInstruction) {
+  // Arrays keep their count in the first slot and one element per slot after
+  // it, which is exactly the byte-range layout FileReadBytes/FileWriteBytes
+  // expect: [handle, first element address, count] -> status.
   const int32_t ptrLocal = allocTempLocal();
   if (!emitExpr(bytesExpr)) {
     return false;
   }
   emitInstruction(IrOpcode::StoreLocal, static_cast<uint64_t>(ptrLocal));
-  const int32_t countLocal = allocTempLocal();
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(ptrLocal));
-  emitInstruction(IrOpcode::LoadIndirect, 0);
-  emitInstruction(IrOpcode::StoreLocal, static_cast<uint64_t>(countLocal));
-  const int32_t indexLocal = allocTempLocal();
-  emitInstruction(IrOpcode::PushI32, 0);
-  emitInstruction(IrOpcode::StoreLocal, static_cast<uint64_t>(indexLocal));
-  const int32_t errorLocal = allocTempLocal();
-  emitInstruction(IrOpcode::PushI32, 0);
-  emitInstruction(IrOpcode::StoreLocal, static_cast<uint64_t>(errorLocal));
-
-  const size_t loopStart = getInstructionCount();
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(errorLocal));
-  emitInstruction(IrOpcode::PushI64, 0);
-  emitInstruction(IrOpcode::CmpEqI64, 0);
-  const size_t jumpError = getInstructionCount();
-  emitInstruction(IrOpcode::JumpIfZero, 0);
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(indexLocal));
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(countLocal));
-  emitInstruction(IrOpcode::CmpLtI32, 0);
-  const size_t jumpLoopEnd = getInstructionCount();
-  emitInstruction(IrOpcode::JumpIfZero, 0);
-
   emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(handleIndex));
   emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(ptrLocal));
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(indexLocal));
-  emitInstruction(IrOpcode::PushI32, 1);
-  emitInstruction(IrOpcode::AddI32, 0);
-  emitInstruction(IrOpcode::PushI32, IrSlotBytesI32);
-  emitInstruction(IrOpcode::MulI32, 0);
+  emitInstruction(IrOpcode::PushI64, IrSlotBytes);
   emitInstruction(IrOpcode::AddI64, 0);
+  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(ptrLocal));
   emitInstruction(IrOpcode::LoadIndirect, 0);
-  emitInstruction(IrOpcode::FileWriteByte, 0);
-  emitInstruction(IrOpcode::StoreLocal, static_cast<uint64_t>(errorLocal));
-
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(indexLocal));
-  emitInstruction(IrOpcode::PushI32, 1);
-  emitInstruction(IrOpcode::AddI32, 0);
-  emitInstruction(IrOpcode::StoreLocal, static_cast<uint64_t>(indexLocal));
-  emitInstruction(IrOpcode::Jump, static_cast<uint64_t>(loopStart));
-
-  const size_t loopEnd = getInstructionCount();
-  patchInstructionImm(jumpError, static_cast<int32_t>(loopEnd));
-  patchInstructionImm(jumpLoopEnd, static_cast<int32_t>(loopEnd));
-  emitInstruction(IrOpcode::LoadLocal, static_cast<uint64_t>(errorLocal));
+  emitInstruction(op, 0);
   return true;
 }
 
@@ -605,13 +611,29 @@ FileHandleMethodCallEmitResult tryEmitFileHandleMethodCall(
                                 [&](const Expr &valueExpr) { return emitExpr(valueExpr, localsIn); },
                                 allocTempLocal,
                                 emitInstruction,
-                                getInstructionCount,
-                                patchInstructionImm,
                                 error)) {
       return FileHandleMethodCallEmitResult::Error;
     }
     return FileHandleMethodCallEmitResult::Emitted;
   }
+  if (expr.name == "read_bytes") {
+    if (!emitFileReadBytesCall(expr,
+                               localsIn,
+                               handleIndex,
+                               [&](const Expr &valueExpr) { return emitExpr(valueExpr, localsIn); },
+                               allocTempLocal,
+                               emitInstruction,
+                               error)) {
+      return FileHandleMethodCallEmitResult::Error;
+    }
+    return FileHandleMethodCallEmitResult::Emitted;
+  }
+  if (expr.name == "map_bytes") {
+    if (!emitFileMapBytesCall(expr, localsIn, handleIndex, emitInstruction, error)) {
+      return FileHandleMethodCallEmitResult::Error;
+    }
+    return FileHandleMethodCallEmitResult::Emitted;
+  }
   if (expr.name == "flush") {
     emitFileFlushCall(handleIndex, emitInstruction);
     return FileHandleMethodCallEmitResult::Emitted;
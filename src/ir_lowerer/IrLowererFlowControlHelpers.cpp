@@ -178,6 +178,27 @@ bool emitStructCopySlots(std::vector<IrInstruction> &instructions,
   return emitStructCopyFromPtrs(instructions, destPtrLocal, srcPtrLocal, slotCount);
 }
 
+void emitPushStructSlotsFromPtr(std::vector<IrInstruction> &instructions,
+                                int32_t srcPtrLocal,
+                                int32_t slotCount) {
+  for (int32_t i = 0; i < slotCount; ++i) {
+    instructions.push_back({IrOpcode::LoadLocal, static_cast<uint64_t>(srcPtrLocal)});
+    if (i != 0) {
+      instructions.push_back({IrOpcode::PushI64, static_cast<uint64_t>(i) * IrSlotBytes});
+      instructions.push_back({IrOpcode::AddI64, 0});
+    }
+    instructions.push_back({IrOpcode::LoadIndirect, 0});
+  }
+}
+
+void emitPopStructSlotsToLocals(std::vector<IrInstruction> &instructions,
+                                int32_t destBaseLocal,
+                                int32_t slotCount) {
+  for (int32_t i = slotCount; i-- > 0;) {
+    instructions.push_back({IrOpcode::StoreLocal, static_cast<uint64_t>(destBaseLocal + i)});
+  }
+}
+
 void emitDisarmTemporaryStructAfterCopy(const std::function<void(IrOpcode, uint64_t)> &emitInstruction,
                                         int32_t srcPtrLocal,
                                         const std::string &structPath) {
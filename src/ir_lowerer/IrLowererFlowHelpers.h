@@ -73,6 +73,15 @@ bool emitStructCopySlots(std::vector<IrInstruction> &instructions,
                          int32_t srcPtrLocal,
                          int32_t slotCount,
                          const std::function<int32_t()> &allocTempLocal);
+// Real-call struct argument passing: the caller pushes every slot of the
+// struct at srcPtrLocal (header first) onto the operand stack, and the
+// callee prologue pops them back into its own slot block at destBaseLocal.
+void emitPushStructSlotsFromPtr(std::vector<IrInstruction> &instructions,
+                                int32_t srcPtrLocal,
+                                int32_t slotCount);
+void emitPopStructSlotsToLocals(std::vector<IrInstruction> &instructions,
+                                int32_t destBaseLocal,
+                                int32_t slotCount);
 bool emitVectorDestroySlot(
     std::vector<IrInstruction> &instructions,
     int32_t dataPtrLocal,
@@ -179,7 +179,8 @@ bool isBaseSetupFileErrorTypeText(const std::string &typeText) {
 bool isBaseSetupFileHandleMethodName(const std::string &methodName) {
   return methodName == "write" || methodName == "write_line" ||
          methodName == "write_byte" || methodName == "read_byte" ||
-         methodName == "write_bytes" || methodName == "flush" ||
+         methodName == "write_bytes" || methodName == "read_bytes" || methodName == "map_bytes" ||
+         methodName == "flush" ||
          methodName == "close";
 }
 
@@ -1422,21 +1423,24 @@ bool inferCallExprBaseKindImpl(const Expr &expr,
     }
     if (!expr.args.empty() && isIndexedArgsPackFileHandleReceiver(expr.args.front(), localsIn)) {
       if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-          expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+          expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+          expr.name == "flush" || expr.name == "close") {
         kindOut = LocalInfo::ValueKind::Int32;
         return true;
       }
     }
     if (!expr.args.empty() && isIndexedBorrowedArgsPackFileHandleReceiver(expr.args.front(), localsIn)) {
       if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-          expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+          expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+          expr.name == "flush" || expr.name == "close") {
         kindOut = LocalInfo::ValueKind::Int32;
         return true;
       }
     }
     if (!expr.args.empty() && isIndexedPointerArgsPackFileHandleReceiver(expr.args.front(), localsIn)) {
       if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-          expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+          expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+          expr.name == "flush" || expr.name == "close") {
         kindOut = LocalInfo::ValueKind::Int32;
         return true;
       }
@@ -1606,7 +1610,8 @@ bool inferCallExprBaseKindImpl(const Expr &expr,
         auto it = localsIn.find(arg.args.front().name);
         if (it != localsIn.end() && it->second.isFileHandle) {
           if (arg.name == "write" || arg.name == "write_line" || arg.name == "write_byte" || arg.name == "read_byte" ||
-              arg.name == "write_bytes" || arg.name == "flush" || arg.name == "close") {
+              arg.name == "write_bytes" || arg.name == "read_bytes" || arg.name == "map_bytes" ||
+              arg.name == "flush" || arg.name == "close") {
             kindOut = LocalInfo::ValueKind::Int32;
             return true;
           }
@@ -131,7 +131,8 @@ bool isDispatchSetupFileErrorTypeText(const std::string &typeText) {
 
 bool isDispatchSetupFileHandleMethodName(const std::string &methodName) {
   return methodName == "write" || methodName == "write_line" ||
-         methodName == "write_byte" || methodName == "write_bytes" ||
+         methodName == "write_byte" || methodName == "write_bytes" || methodName == "read_bytes" ||
+         methodName == "map_bytes" ||
          methodName == "flush" || methodName == "close";
 }
 
@@ -1025,7 +1026,8 @@ bool runLowerInferenceExprKindDispatchSetup(const LowerInferenceExprKindDispatch
         auto it = localsIn.find(receiverExpr.name);
         if (it != localsIn.end() && it->second.isFileHandle) {
           if (resultExpr.name == "write" || resultExpr.name == "write_line" || resultExpr.name == "write_byte" ||
-              resultExpr.name == "write_bytes" || resultExpr.name == "flush" || resultExpr.name == "close") {
+              resultExpr.name == "write_bytes" || resultExpr.name == "read_bytes" || resultExpr.name == "map_bytes" ||
+              resultExpr.name == "flush" || resultExpr.name == "close") {
             kindOut = LocalInfo::ValueKind::Int32;
             return true;
           }
@@ -1058,7 +1060,8 @@ bool runLowerInferenceExprKindDispatchSetup(const LowerInferenceExprKindDispatch
       if (resultExpr.isMethodCall && !resultExpr.args.empty() &&
           isIndexedArgsPackFileHandleReceiver(resultExpr.args.front(), localsIn)) {
         if (resultExpr.name == "write" || resultExpr.name == "write_line" || resultExpr.name == "write_byte" ||
-            resultExpr.name == "write_bytes" || resultExpr.name == "flush" || resultExpr.name == "close") {
+            resultExpr.name == "write_bytes" || resultExpr.name == "read_bytes" || resultExpr.name == "map_bytes" ||
+            resultExpr.name == "flush" || resultExpr.name == "close") {
           kindOut = LocalInfo::ValueKind::Int32;
           return true;
         }
@@ -1066,7 +1069,8 @@ bool runLowerInferenceExprKindDispatchSetup(const LowerInferenceExprKindDispatch
       if (resultExpr.isMethodCall && !resultExpr.args.empty() &&
           isIndexedBorrowedArgsPackFileHandleReceiver(resultExpr.args.front(), localsIn)) {
         if (resultExpr.name == "write" || resultExpr.name == "write_line" || resultExpr.name == "write_byte" ||
-            resultExpr.name == "write_bytes" || resultExpr.name == "flush" || resultExpr.name == "close") {
+            resultExpr.name == "write_bytes" || resultExpr.name == "read_bytes" || resultExpr.name == "map_bytes" ||
+            resultExpr.name == "flush" || resultExpr.name == "close") {
           kindOut = LocalInfo::ValueKind::Int32;
           return true;
         }
@@ -1074,7 +1078,8 @@ bool runLowerInferenceExprKindDispatchSetup(const LowerInferenceExprKindDispatch
       if (resultExpr.isMethodCall && !resultExpr.args.empty() &&
           isIndexedPointerArgsPackFileHandleReceiver(resultExpr.args.front(), localsIn)) {
         if (resultExpr.name == "write" || resultExpr.name == "write_line" || resultExpr.name == "write_byte" ||
-            resultExpr.name == "write_bytes" || resultExpr.name == "flush" || resultExpr.name == "close") {
+            resultExpr.name == "write_bytes" || resultExpr.name == "read_bytes" || resultExpr.name == "map_bytes" ||
+            resultExpr.name == "flush" || resultExpr.name == "close") {
           kindOut = LocalInfo::ValueKind::Int32;
           return true;
         }
@@ -19,6 +19,9 @@
     // emitExpr path and left on the shared operand stack - the callee's own
     // prologue is responsible for popping them into its locals, matching the
     // calling convention already used by every existing Call/CallVoid site.
+    // Struct arguments travel as their flat run of slots (header first), so
+    // the callee's copy lives in its own frame exactly like the inline
+    // path's by-value struct parameter copy.
     if (const auto realCallIt = realCallReservationIndex.find(callee.fullPath);
         realCallIt != realCallReservationIndex.end()) {
       ReturnInfo calleeReturnInfo;
@@ -48,14 +51,29 @@
         error = "internal error: unexpected packed arguments for real-call target " + callee.fullPath;
         return false;
       }
-      for (const Expr *argExpr : realCallOrderedArgs) {
-        if (argExpr == nullptr) {
+      for (size_t argIndex = 0; argIndex < realCallOrderedArgs.size(); ++argIndex) {
+        const Expr *argExpr = realCallOrderedArgs[argIndex];
+        if (argExpr == nullptr || argIndex >= realCallParams.size()) {
           error = "internal error: missing argument for real-call target " + callee.fullPath;
           return false;
         }
         if (!emitExpr(*argExpr, callerLocals)) {
           return false;
         }
+        const std::string paramTypeName = ir_lowerer::extractParameterTypeNameStatic(realCallParams[argIndex]);
+        if (ir_lowerer::isSupportedScalarTypeName(paramTypeName)) {
+          continue;
+        }
+        const std::string argStruct = inferStructExprPath(*argExpr, callerLocals);
+        StructSlotLayoutInfo paramLayout;
+        if (argStruct.empty() || !resolveStructSlotLayout(argStruct, paramLayout)) {
+          error = "struct parameter type mismatch: expected " + paramTypeName + ", got " +
+                  (argStruct.empty() ? std::string("<unknown>") : argStruct);
+          return false;
+        }
+        const int32_t srcPtrLocal = allocTempLocal();
+        function.instructions.push_back({IrOpcode::StoreLocal, static_cast<uint64_t>(srcPtrLocal)});
+        ir_lowerer::emitPushStructSlotsFromPtr(function.instructions, srcPtrLocal, paramLayout.totalSlots);
       }
       const uint64_t placeholderImm = (uint64_t(1) << 32) | realCallIt->second;
       function.instructions.push_back(
@@ -27,6 +27,7 @@
 #include "IrLowererOperatorConversionsAndCallsHelpers.h"
 #include "IrLowererOperatorPowAbsSignHelpers.h"
 #include "IrLowererOperatorSaturateRoundingRootsHelpers.h"
+#include "IrLowererRecursionAnalysis.h"
 #include "IrLowererReturnInferenceHelpers.h"
 #include "IrLowererSemanticProductTargetAdapters.h"
 #include "IrLowererSetupMathHelpers.h"
@@ -1,6 +1,7 @@
 #include "IrLowererLowerStatementsCallsStage.h"
 
 #include "IrLowererCallHelpers.h"
+#include "IrLowererFlowHelpers.h"
 #include "IrLowererLowerEffects.h"
 #include "IrLowererLowerStatementsCallsStep.h"
 #include "IrLowererLowerStatementsEntryExecutionStep.h"
@@ -184,7 +185,6 @@ bool runLowerStatementsCallsStage(const LowerStatementsCallsStageInput &input,
       *input.nextLocal = 0;
 
       input.function->name = def.fullPath;
-      input.function->parameterCount = static_cast<uint32_t>(def.parameters.size());
       // Match lowerCallableDefinitionOrchestration's precedence
       // (IrLowererStatementCallHelpers.cpp): prefer the semantic-product's
       // transitively-computed active effects/capabilities when available -
@@ -240,29 +240,56 @@ bool runLowerStatementsCallsStage(const LowerStatementsCallsStageInput &input,
               ? InstrumentationTailExecution
               : 0;
 
-      // The eligibility scan already verified every parameter statically
-      // resolves to a scalar type - re-derive it here with the identical
-      // extraction rather than trusting that verdict blindly, and fail
-      // loudly on a mismatch instead of silently miscompiling.
+      // Bind parameters with the same inference orchestration-lowered
+      // callables use, then re-check each against the static eligibility
+      // verdict (scalar of the identical kind, or a struct value with a
+      // resolved slot layout) and fail loudly on a mismatch instead of
+      // silently miscompiling.
+      Expr unusedCallExpr;
+      if (!input.buildDefinitionCallContext(def, *input.nextLocal, *input.locals, unusedCallExpr, errorOut)) {
+        return false;
+      }
+      std::vector<const LocalInfo *> paramInfos;
+      paramInfos.reserve(def.parameters.size());
+      uint32_t parameterSlotCount = 0;
       for (const Expr &param : def.parameters) {
+        const auto localIt = input.locals->find(param.name);
         const std::string typeName = extractParameterTypeNameStatic(param);
-        if (typeName.empty() || !isSupportedScalarTypeName(typeName)) {
+        const bool isScalar = isSupportedScalarTypeName(typeName);
+        // Homogeneous scalar structs bind as struct-array locals; both forms
+        // hold the address of the same header-plus-fields slot block.
+        if (localIt == input.locals->end() ||
+            (isScalar && (localIt->second.kind != LocalInfo::Kind::Value ||
+                          !localIt->second.structTypeName.empty() ||
+                          localIt->second.valueKind != valueKindFromTypeName(typeName))) ||
+            (!isScalar && ((localIt->second.kind != LocalInfo::Kind::Value &&
+                            localIt->second.kind != LocalInfo::Kind::Array) ||
+                           localIt->second.structTypeName.empty() || localIt->second.structSlotCount <= 0))) {
           errorOut = "internal error: real-call eligibility mismatch on parameter type for " + def.fullPath;
           return false;
         }
-        LocalInfo info;
-        info.index = (*input.nextLocal)++;
-        info.kind = LocalInfo::Kind::Value;
-        info.valueKind = valueKindFromTypeName(typeName);
-        input.locals->emplace(param.name, info);
+        paramInfos.push_back(&localIt->second);
+        parameterSlotCount += isScalar ? 1u : static_cast<uint32_t>(localIt->second.structSlotCount);
       }
+      input.function->parameterCount = parameterSlotCount;
       // Prologue: the caller left its evaluated arguments on the shared
       // operand stack in parameter order (see the real-call redirect in
-      // IrLowererLowerInlineCalls.h) - pop them into locals 0..N-1, last
+      // IrLowererLowerInlineCalls.h) - pop them into their locals, last
       // pushed first, matching the calling convention already used by every
-      // existing Call/CallVoid site in the native/VM/C++ backends.
-      for (size_t i = def.parameters.size(); i-- > 0;) {
-        input.function->instructions.push_back({IrOpcode::StoreLocal, static_cast<uint64_t>(i)});
+      // existing Call/CallVoid site in the native/VM/C++ backends. A struct
+      // argument arrives as its slots and is popped into a fresh slot block
+      // whose address becomes the parameter's value.
+      for (size_t i = paramInfos.size(); i-- > 0;) {
+        const LocalInfo &info = *paramInfos[i];
+        if (info.structTypeName.empty()) {
+          input.function->instructions.push_back({IrOpcode::StoreLocal, static_cast<uint64_t>(info.index)});
+          continue;
+        }
+        const int32_t baseLocal = *input.nextLocal;
+        *input.nextLocal += info.structSlotCount;
+        emitPopStructSlotsToLocals(input.function->instructions, baseLocal, info.structSlotCount);
+        input.function->instructions.push_back({IrOpcode::AddressOfLocal, static_cast<uint64_t>(baseLocal)});
+        input.function->instructions.push_back({IrOpcode::StoreLocal, static_cast<uint64_t>(info.index)});
       }
 
       auto emitBodyStatement = [&](const Expr &stmt) -> bool {
@@ -6,6 +6,7 @@
 #include "IrLowererSharedTypes.h"
 #include "IrLowererTemplateTypeParseHelpers.h"
 
+#include <functional>
 #include <unordered_map>
 #include <vector>
 
@@ -47,6 +48,29 @@ std::string extractParameterTypeNameStatic(const Expr &paramExpr) {
   return {};
 }
 
+std::string resolveStaticStructTypePath(const std::string &typeName,
+                                        const std::string &scopePath,
+                                        const std::unordered_set<std::string> &structPaths) {
+  if (typeName.empty()) {
+    return {};
+  }
+  if (typeName.front() == '/') {
+    return structPaths.count(typeName) > 0 ? typeName : std::string{};
+  }
+  std::string scope = scopePath;
+  while (true) {
+    const std::string candidate = (scope.empty() || scope == "/") ? "/" + typeName : scope + "/" + typeName;
+    if (structPaths.count(candidate) > 0) {
+      return candidate;
+    }
+    if (scope.empty() || scope == "/") {
+      return {};
+    }
+    const size_t slash = scope.find_last_of('/');
+    scope = slash == std::string::npos ? std::string{} : scope.substr(0, slash);
+  }
+}
+
 namespace {
 
 void collectCallEdges(const Expr &expr, std::vector<std::string> &out) {
@@ -173,7 +197,80 @@ std::unordered_map<std::string, size_t> countCallSitesByDefinitionPath(const Pro
 // motivating problem (see docs/todo.md's TODO-4747 entry).
 constexpr size_t kMinCallSitesForRealCall = 2;
 
-bool hasOnlyScalarParameters(const Definition &def) {
+bool isStructLifecycleHelperName(const std::string &helperName) {
+  return helperName == "Destroy" || helperName == "Copy" || helperName == "Move" ||
+         helperName == "DestroyStack" || helperName == "DestroyHeap" || helperName == "DestroyBuffer";
+}
+
+// Struct paths whose instances can cross a real Call as a flat run of slots:
+// every instance field is a scalar or (recursively) another such struct, and
+// the struct declares no Destroy/Copy/Move lifecycle helper. Copying the
+// slots is then exactly what the inline path's by-value struct parameter
+// copy does, with no ownership to hand over - structs that own heap storage
+// (vector-backed records, Result payloads, ...) stay on the inline path.
+std::unordered_set<std::string> collectSlotCopyableStructPaths(
+    const Program &program,
+    const std::unordered_map<std::string, const Definition *> &byPath) {
+  std::unordered_set<std::string> structPaths;
+  std::unordered_set<std::string> lifecycleOwners;
+  for (const Definition &def : program.definitions) {
+    if (definitionHasTransform(def, "struct")) {
+      structPaths.insert(def.fullPath);
+    }
+  }
+  for (const Definition &def : program.definitions) {
+    const size_t slash = def.fullPath.find_last_of('/');
+    if (slash == std::string::npos || slash == 0) {
+      continue;
+    }
+    if (isStructLifecycleHelperName(def.fullPath.substr(slash + 1))) {
+      lifecycleOwners.insert(def.fullPath.substr(0, slash));
+    }
+  }
+
+  std::unordered_map<std::string, VisitState> state;
+  std::unordered_set<std::string> copyable;
+  std::function<bool(const std::string &)> visit = [&](const std::string &path) -> bool {
+    const VisitState current = state[path];
+    if (current == VisitState::Done) {
+      return copyable.count(path) > 0;
+    }
+    if (current == VisitState::OnStack) {
+      return false;
+    }
+    state[path] = VisitState::OnStack;
+    bool ok = lifecycleOwners.count(path) == 0 && !definitionHasTransform(*byPath.at(path), "sum");
+    if (ok) {
+      std::vector<Expr> fields;
+      std::string fieldError;
+      ok = collectInstanceStructFieldParams(*byPath.at(path), fields, fieldError);
+      for (const Expr &field : fields) {
+        if (!ok) {
+          break;
+        }
+        const std::string typeName = extractParameterTypeNameStatic(field);
+        if (typeName.empty()) {
+          ok = false;
+        } else if (!isSupportedScalarTypeName(typeName)) {
+          const std::string fieldStructPath = resolveStaticStructTypePath(typeName, path, structPaths);
+          ok = !fieldStructPath.empty() && visit(fieldStructPath);
+        }
+      }
+    }
+    state[path] = VisitState::Done;
+    if (ok) {
+      copyable.insert(path);
+    }
+    return ok;
+  };
+  for (const std::string &path : structPaths) {
+    visit(path);
+  }
+  return copyable;
+}
+
+bool hasRealCallPassableParameters(const Definition &def,
+                                   const std::unordered_set<std::string> &copyableStructPaths) {
   for (const Expr &param : def.parameters) {
     if (isArgsPackBinding(param)) {
       return false;
@@ -188,7 +285,15 @@ bool hasOnlyScalarParameters(const Definition &def) {
       return false;
     }
     const std::string typeName = extractParameterTypeNameStatic(param);
-    if (typeName.empty() || !isSupportedScalarTypeName(typeName)) {
+    if (typeName.empty()) {
+      return false;
+    }
+    if (isSupportedScalarTypeName(typeName)) {
+      continue;
+    }
+    const std::string structPath =
+        resolveStaticStructTypePath(typeName, def.namespacePrefix, copyableStructPaths);
+    if (structPath.empty()) {
       return false;
     }
   }
@@ -327,6 +432,14 @@ std::unordered_set<std::string> computeRealCallEligibleDefinitionPaths(const Pro
     byPath.emplace(def.fullPath, &def);
   }
 
+  const std::unordered_set<std::string> copyableStructPaths = collectSlotCopyableStructPaths(program, byPath);
+  std::unordered_set<std::string> structPaths;
+  for (const Definition &def : program.definitions) {
+    if (definitionHasTransform(def, "struct")) {
+      structPaths.insert(def.fullPath);
+    }
+  }
+
   std::unordered_set<std::string> eligible;
   for (const std::string &path : reachable) {
     if (path == entryPath) {
@@ -354,7 +467,13 @@ std::unordered_set<std::string> computeRealCallEligibleDefinitionPaths(const Pro
         definitionHasTransform(def, "compute") || definitionHasTransform(def, "on_error")) {
       continue;
     }
-    if (!hasOnlyScalarParameters(def) || !hasScalarOrVoidReturn(def)) {
+    // Instance helpers take an implicit `this` the real-call body lowering
+    // never binds; keep them on the inline path.
+    std::string helperParent;
+    if (isStructHelperDefinition(def, structPaths, helperParent) && !definitionHasTransform(def, "static")) {
+      continue;
+    }
+    if (!hasRealCallPassableParameters(def, copyableStructPaths) || !hasScalarOrVoidReturn(def)) {
       continue;
     }
     if (definitionUsesTry(def)) {
@@ -37,13 +37,16 @@ std::unordered_set<std::string> findReachableDefinitionPaths(const Program &prog
 // one site gains nothing from a real Call - see kMinCallSitesForRealCall
 // in the .cpp - so single-call-site definitions are left inlined exactly
 // as before this analysis existed), and (c) pass a conservative, purely
-// static shape check: every parameter and the return type (if any) must
-// resolve, via a plain explicit type transform (no template args, no
-// args-pack, no `mut`), to a scalar valueKindFromTypeName result
-// (Int32/Int64/UInt64/Float32/Float64/Bool) or void; the definition must
-// not be a struct/sum/compute definition, have an on_error handler, or
-// itself use `try(...)`/the `?` postfix (both desugar to the same "try"
-// call at parse time - see ParserExpr.cpp). `mut` scalar parameters are
+// static shape check: every parameter must resolve, via a plain explicit
+// type transform (no template args, no args-pack, no `mut`), to a scalar
+// valueKindFromTypeName result (Int32/Int64/UInt64/Float32/Float64/Bool) or
+// to a slot-copyable struct (scalar or nested slot-copyable fields only, no
+// Destroy/Copy/Move helper), which crosses the call as its flat run of
+// slots; the return type (if any) must be such a scalar or void; the
+// definition must not be a struct/sum/compute definition or an instance
+// struct helper, have an on_error handler, or itself use `try(...)`/the `?`
+// postfix (both desugar to the same "try" call at parse time - see
+// ParserExpr.cpp). `mut` scalar parameters are
 // PrimeStruct's out-parameter mechanism (the inline path passes the
 // caller's local by address; a real call can't replicate that with a
 // separate locals array) and `try`/`?` reads a dynamically-scoped handler
@@ -68,4 +71,11 @@ std::unordered_set<std::string> computeRealCallEligibleDefinitionPaths(const Pro
 bool isSupportedScalarTypeName(const std::string &typeName);
 std::string extractParameterTypeNameStatic(const Expr &paramExpr);
 
+// Resolves a bare or rooted type name against `structPaths` the way a
+// namespace-relative reference would: `scopePath` first, then each
+// enclosing namespace up to the root. Empty when nothing matches.
+std::string resolveStaticStructTypePath(const std::string &typeName,
+                                        const std::string &scopePath,
+                                        const std::unordered_set<std::string> &structPaths);
+
 } // namespace primec::ir_lowerer
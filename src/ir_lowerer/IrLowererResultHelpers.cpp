@@ -853,7 +853,8 @@ bool resolveResultExprInfo(const Expr &expr,
       const LocalResultInfo local = lookupLocalFn(expr.args.front().name);
       if (local.found && local.isFileHandle) {
         if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-            expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+            expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+            expr.name == "flush" || expr.name == "close") {
           out.isResult = true;
           out.hasValue = false;
           out.errorType = "FileError";
@@ -1054,7 +1055,8 @@ bool resolveResultExprInfoFromLocals(const Expr &expr,
   if (expr.kind == Expr::Kind::Call && expr.isMethodCall && !expr.args.empty() &&
       isIndexedArgsPackFileHandleReceiver(expr.args.front())) {
     if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-        expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+        expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+        expr.name == "flush" || expr.name == "close") {
       out.isResult = true;
       out.hasValue = false;
       out.errorType = "FileError";
@@ -1064,7 +1066,8 @@ bool resolveResultExprInfoFromLocals(const Expr &expr,
   if (expr.kind == Expr::Kind::Call && expr.isMethodCall && !expr.args.empty() &&
       isIndexedBorrowedArgsPackFileHandleReceiver(expr.args.front())) {
     if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-        expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+        expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+        expr.name == "flush" || expr.name == "close") {
       out.isResult = true;
       out.hasValue = false;
       out.errorType = "FileError";
@@ -1074,7 +1077,8 @@ bool resolveResultExprInfoFromLocals(const Expr &expr,
   if (expr.kind == Expr::Kind::Call && expr.isMethodCall && !expr.args.empty() &&
       isIndexedPointerArgsPackFileHandleReceiver(expr.args.front())) {
     if (expr.name == "write" || expr.name == "write_line" || expr.name == "write_byte" || expr.name == "read_byte" ||
-        expr.name == "write_bytes" || expr.name == "flush" || expr.name == "close") {
+        expr.name == "write_bytes" || expr.name == "read_bytes" || expr.name == "map_bytes" ||
+        expr.name == "flush" || expr.name == "close") {
       out.isResult = true;
       out.hasValue = false;
       out.errorType = "FileError";
@@ -100,7 +100,8 @@ bool isExperimentalSoaVectorSpecializedStructPath(std::string_view path) {
 bool isBuiltinFileHandleMethodName(std::string_view methodName) {
   return methodName == "write" || methodName == "write_line" ||
          methodName == "write_byte" || methodName == "read_byte" ||
-         methodName == "write_bytes" || methodName == "flush" ||
+         methodName == "write_bytes" || methodName == "read_bytes" || methodName == "map_bytes" ||
+         methodName == "flush" ||
          methodName == "close";
 }
 
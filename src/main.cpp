@@ -217,6 +217,8 @@ bool runIrBackend(const primec::IrBackend &backend,
   emitOptions.outputPath = options.outputPath;
   emitOptions.inputPath = options.inputPath;
   emitOptions.programArgs = options.programArgs;
+  emitOptions.vmEngine = options.vmEngine;
+  emitOptions.nativeCodegen = options.nativeCodegen;
   if (!backend.emit(ir, emitOptions, result, error)) {
     const std::string_view backendTag = diagnostics.backendTag;
     const bool outputWriteFailure =
@@ -255,7 +257,8 @@ int main(int argc, char **argv) {
                 << "[--transform-list <list>] [--no-text-transforms] [--no-semantic-transforms] "
                 << "[--no-transforms] [--out-dir <dir>] [--list-transforms] [--emit-diagnostics] "
                 << "[--collect-diagnostics] "
-                << "[--default-effects <list>] [--ir-inline] "
+                << "[--default-effects <list>] [--ir-inline] [-O0|-O1|-O2] [--ir-opt-report] [--vm-engine checked|fast] "
+                << "[--native-codegen stack|regalloc] "
                 << "[--benchmark-semantic-phase-counters] "
                 << "[--benchmark-semantic-allocation-counters] "
                 << "[--benchmark-semantic-rss-checkpoints] "
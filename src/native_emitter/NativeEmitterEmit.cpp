@@ -89,7 +89,9 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
   }
 
   const size_t entryIndex = static_cast<size_t>(module.entryIndex);
+  std::vector<NativeEmitterRegisterPlan> registerPlans(module.functions.size());
   std::vector<NativeEmitterFunctionLayout> layouts(module.functions.size());
+  bool needsHeapRuntime = false;
   for (size_t functionIndex = 0; functionIndex < module.functions.size(); ++functionIndex) {
     const IrFunction &fn = module.functions[functionIndex];
     NativeEmitterFunctionLayout &layout = layouts[functionIndex];
@@ -114,6 +116,10 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
       if (inst.op == IrOpcode::PushArgc) {
         layout.needsArgc = true;
       }
+      if (inst.op == IrOpcode::HeapAlloc || inst.op == IrOpcode::HeapFree ||
+          inst.op == IrOpcode::HeapRealloc || inst.op == IrOpcode::FileMapBytes) {
+        needsHeapRuntime = true;
+      }
     }
     {
       int64_t maxStack = 0;
@@ -133,6 +139,21 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
     layout.localCount += 1;
     layout.linkLocalIndex = static_cast<uint32_t>(layout.localCount);
     layout.localCount += 1;
+    if (options.enableRegisterAllocation) {
+      NativeEmitterRegisterPlan &plan = registerPlans[functionIndex];
+      std::string planError;
+#if defined(__APPLE__) && (defined(__aarch64__) || defined(__arm64__))
+      constexpr uint32_t AllocatableRegisterCount = Arm64Emitter::AllocatableRegisters.size();
+#else
+      constexpr uint32_t AllocatableRegisterCount = X64Emitter::AllocatableRegisters.size();
+#endif
+      if (buildNativeEmitterRegisterPlan(module, functionIndex, AllocatableRegisterCount, plan, planError)) {
+        layout.registerSaveLocalIndex = static_cast<uint32_t>(layout.localCount);
+        layout.localCount += AllocatableRegisterCount;
+        layout.spillLocalIndex = static_cast<uint32_t>(layout.localCount);
+        layout.localCount += plan.spillSlotCount;
+      }
+    }
     layout.scratchSlots = layout.needsPrintScratch ? PrintScratchSlots : 0;
     layout.scratchBytes = layout.scratchSlots * 16;
     layout.scratchOffset = static_cast<uint32_t>(layout.localCount) * 16;
@@ -146,6 +167,7 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
   X64Emitter emitter;
 #endif
   emitter.setValueStackCacheEnabled(options.enableRegisterCache);
+  emitter.setHeapRuntimeEnabled(needsHeapRuntime);
   std::vector<NativeEmitterBranchFixup> branchFixups;
   std::vector<NativeEmitterCallFixup> callFixups;
   std::vector<NativeEmitterStringFixup> stringFixups;
@@ -181,12 +203,14 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
       functionInstrumentation.functionIndex = functionIndex;
       functionInstrumentation.functionName = module.functions[functionIndex].name;
       functionInstrumentation.instructionTotal = module.functions[functionIndex].instructions.size();
+      functionInstrumentation.registerAllocated = registerPlans[functionIndex].enabled;
     }
   }
 
   if (!emitNativeFunctions(module,
                            entryIndex,
                            layouts,
+                           registerPlans,
                            emitOrder,
                            emitter,
                            branchFixups,
@@ -201,6 +225,7 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
                            error)) {
     return false;
   }
+  emitter.emitHeapRuntime();
   if (instrumentation != nullptr) {
     for (const auto &functionInstrumentation : instrumentation->perFunction) {
       instrumentation->totalInstructionCount += functionInstrumentation.instructionTotal;
@@ -208,6 +233,9 @@ bool NativeEmitter::emitExecutable(const IrModule &module,
       instrumentation->totalValueStackPopCount += functionInstrumentation.valueStackPopCount;
       instrumentation->totalSpillCount += functionInstrumentation.spillCount;
       instrumentation->totalReloadCount += functionInstrumentation.reloadCount;
+      if (functionInstrumentation.registerAllocated) {
+        instrumentation->registerAllocatedFunctionCount += 1;
+      }
     }
   }
 
@@ -2,6 +2,7 @@
 
 #include "NativeEmitterInternals.h"
 #include "NativeEmitterInternalsX64.h"
+#include "primec/IrVirtualRegisterLowering.h"
 #include "primec/NativeEmitter.h"
 
 #include <string>
@@ -18,6 +19,11 @@ struct NativeEmitterFunctionLayout {
   uint32_t argvLocalIndex = 0;
   uint32_t framePointerLocalIndex = 0;
   uint32_t linkLocalIndex = 0;
+  // Register-allocated functions only: one save slot per allocatable
+  // register (caller-saved around calls and stack-routine fallbacks),
+  // followed by the linear-scan spill slots.
+  uint32_t registerSaveLocalIndex = 0;
+  uint32_t spillLocalIndex = 0;
   uint32_t scratchSlots = 0;
   uint32_t scratchBytes = 0;
   uint32_t scratchOffset = 0;
@@ -25,6 +31,36 @@ struct NativeEmitterFunctionLayout {
   uint64_t frameSize = 0;
 };
 
+// Where a virtual register lives for its whole (single-hull) live
+// interval: a physical register (an index into the emitter's
+// AllocatableRegisters) or a frame spill slot. Dead edge destinations have
+// no interval and stay None.
+struct NativeEmitterRegisterLocation {
+  enum class Kind : uint8_t { None, Register, SpillSlot };
+  Kind kind = Kind::None;
+  uint32_t index = 0;
+  uint32_t startPosition = 0;
+  uint32_t endPosition = 0;
+};
+
+// Per-function input to the register-allocated codegen mode, built from
+// the block virtual-register form and its linear-scan allocation. A
+// disabled plan means the function is emitted as a stack machine.
+struct NativeEmitterRegisterPlan {
+  bool enabled = false;
+  IrVirtualRegisterFunction function;
+  std::vector<NativeEmitterRegisterLocation> locations;
+  uint32_t spillSlotCount = 0;
+};
+
+// Fails (leaving `out` disabled) when the function cannot be lowered to
+// block virtual-register form or the allocation does not verify.
+bool buildNativeEmitterRegisterPlan(const IrModule &module,
+                                    size_t functionIndex,
+                                    uint32_t physicalRegisterCount,
+                                    NativeEmitterRegisterPlan &out,
+                                    std::string &error);
+
 struct NativeEmitterBranchFixup {
   size_t codeIndex = 0;
   size_t functionIndex = 0;
@@ -51,6 +87,7 @@ template <typename EmitterT>
 bool emitNativeFunctions(const IrModule &module,
                          size_t entryIndex,
                          const std::vector<NativeEmitterFunctionLayout> &layouts,
+                         const std::vector<NativeEmitterRegisterPlan> &registerPlans,
                          const std::vector<size_t> &emitOrder,
                          EmitterT &emitter,
                          std::vector<NativeEmitterBranchFixup> &branchFixups,
@@ -1,14 +1,681 @@
 #include "NativeEmitterEmitInternal.h"
 
+#include <algorithm>
 #include <fcntl.h>
 #include <type_traits>
+#include <unordered_map>
 
 namespace primec::native_emitter {
 
+namespace {
+
+// Where a virtual register's value lives while a register-allocated function
+// runs: one of the emitter's allocatable registers, a spill local, or scratch
+// register B (only while a parallel edge move breaks a cycle).
+struct RegisterValueSlot {
+  enum class Kind { Register, Local, ScratchB };
+  Kind kind = Kind::Register;
+  uint32_t index = 0;
+
+  bool operator==(const RegisterValueSlot &other) const = default;
+};
+
+// Opcodes with a direct register lowering map onto one shared emitter
+// operation computing scratch A = A op B.
+bool registerOpForOpcode(IrOpcode op, NativeRegisterOp &out) {
+  switch (op) {
+    case IrOpcode::AddI32:
+    case IrOpcode::AddI64:
+      out = NativeRegisterOp::Add;
+      return true;
+    case IrOpcode::SubI32:
+    case IrOpcode::SubI64:
+      out = NativeRegisterOp::Sub;
+      return true;
+    case IrOpcode::MulI32:
+    case IrOpcode::MulI64:
+      out = NativeRegisterOp::Mul;
+      return true;
+    case IrOpcode::DivI32:
+    case IrOpcode::DivI64:
+      out = NativeRegisterOp::Div;
+      return true;
+    case IrOpcode::DivU64:
+      out = NativeRegisterOp::DivU;
+      return true;
+    case IrOpcode::NegI32:
+    case IrOpcode::NegI64:
+      out = NativeRegisterOp::Neg;
+      return true;
+    case IrOpcode::CmpEqI32:
+    case IrOpcode::CmpEqI64:
+      out = NativeRegisterOp::CmpEq;
+      return true;
+    case IrOpcode::CmpNeI32:
+    case IrOpcode::CmpNeI64:
+      out = NativeRegisterOp::CmpNe;
+      return true;
+    case IrOpcode::CmpLtI32:
+    case IrOpcode::CmpLtI64:
+      out = NativeRegisterOp::CmpLt;
+      return true;
+    case IrOpcode::CmpLeI32:
+    case IrOpcode::CmpLeI64:
+      out = NativeRegisterOp::CmpLe;
+      return true;
+    case IrOpcode::CmpGtI32:
+    case IrOpcode::CmpGtI64:
+      out = NativeRegisterOp::CmpGt;
+      return true;
+    case IrOpcode::CmpGeI32:
+    case IrOpcode::CmpGeI64:
+      out = NativeRegisterOp::CmpGe;
+      return true;
+    case IrOpcode::CmpLtU64:
+      out = NativeRegisterOp::CmpLtU;
+      return true;
+    case IrOpcode::CmpLeU64:
+      out = NativeRegisterOp::CmpLeU;
+      return true;
+    case IrOpcode::CmpGtU64:
+      out = NativeRegisterOp::CmpGtU;
+      return true;
+    case IrOpcode::CmpGeU64:
+      out = NativeRegisterOp::CmpGeU;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Stack routines for these opcodes only touch the scratch registers (plus the
+// float scratch registers and, on x86_64, rdx), so bridging them through the
+// value stack does not need to save the allocatable registers first.
+bool stackRoutinePreservesAllocatableRegisters(IrOpcode op) {
+  switch (op) {
+    case IrOpcode::AddF32:
+    case IrOpcode::SubF32:
+    case IrOpcode::MulF32:
+    case IrOpcode::DivF32:
+    case IrOpcode::NegF32:
+    case IrOpcode::AddF64:
+    case IrOpcode::SubF64:
+    case IrOpcode::MulF64:
+    case IrOpcode::DivF64:
+    case IrOpcode::NegF64:
+    case IrOpcode::CmpEqF32:
+    case IrOpcode::CmpNeF32:
+    case IrOpcode::CmpLtF32:
+    case IrOpcode::CmpLeF32:
+    case IrOpcode::CmpGtF32:
+    case IrOpcode::CmpGeF32:
+    case IrOpcode::CmpEqF64:
+    case IrOpcode::CmpNeF64:
+    case IrOpcode::CmpLtF64:
+    case IrOpcode::CmpLeF64:
+    case IrOpcode::CmpGtF64:
+    case IrOpcode::CmpGeF64:
+    case IrOpcode::ConvertI32ToF32:
+    case IrOpcode::ConvertI32ToF64:
+    case IrOpcode::ConvertI64ToF32:
+    case IrOpcode::ConvertI64ToF64:
+    case IrOpcode::ConvertU64ToF32:
+    case IrOpcode::ConvertU64ToF64:
+    case IrOpcode::ConvertF32ToI32:
+    case IrOpcode::ConvertF32ToI64:
+    case IrOpcode::ConvertF32ToU64:
+    case IrOpcode::ConvertF64ToI32:
+    case IrOpcode::ConvertF64ToI64:
+    case IrOpcode::ConvertF64ToU64:
+    case IrOpcode::ConvertF32ToF64:
+    case IrOpcode::ConvertF64ToF32:
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Emits one function from its register plan: every stack slot the IR would
+// have pushed lives in the virtual register the plan assigned it, so
+// straight-line integer code, locals, and branches never touch the value
+// stack. Opcodes without a register lowering are bridged: their operands are
+// pushed, the stack routine runs unchanged, and the result is popped back.
+template <typename EmitterT, typename StackInstructionEmitter>
+class RegisterAllocatedFunctionEmitter {
+public:
+  RegisterAllocatedFunctionEmitter(const IrModule &module,
+                                   size_t functionIndex,
+                                   const NativeEmitterFunctionLayout &layout,
+                                   const NativeEmitterRegisterPlan &plan,
+                                   EmitterT &emitter,
+                                   std::vector<NativeEmitterBranchFixup> &branchFixups,
+                                   std::vector<NativeEmitterCallFixup> &callFixups,
+                                   std::vector<size_t> &instOffsets,
+                                   StackInstructionEmitter &emitStackInstruction,
+                                   std::string &error)
+      : module_(module),
+        functionIndex_(functionIndex),
+        layout_(layout),
+        plan_(plan),
+        emitter_(emitter),
+        branchFixups_(branchFixups),
+        callFixups_(callFixups),
+        instOffsets_(instOffsets),
+        emitStackInstruction_(emitStackInstruction),
+        error_(error) {}
+
+  bool emit() {
+    const IrVirtualRegisterFunction &function = plan_.function;
+    for (uint32_t vreg = 0; vreg < plan_.locations.size(); ++vreg) {
+      if (plan_.locations[vreg].kind == NativeEmitterRegisterLocation::Kind::Register) {
+        registersByStart_.push_back(vreg);
+      }
+    }
+    std::stable_sort(registersByStart_.begin(), registersByStart_.end(), [&](uint32_t left, uint32_t right) {
+      return plan_.locations[left].startPosition < plan_.locations[right].startPosition;
+    });
+    for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+      blockByStart_.emplace(function.blocks[blockIndex].startInstructionIndex, blockIndex);
+    }
+    if (!function.blocks.empty()) {
+      // Arguments arrive on the value stack, last parameter on top.
+      const auto &parameters = function.blocks.front().entryRegisters;
+      for (size_t index = parameters.size(); index > 0; --index) {
+        emitter_.emitPopRegPublic(ScratchA);
+        if (!defineValue(parameters[index - 1], ScratchA)) {
+          return false;
+        }
+      }
+    }
+
+    for (size_t blockIndex = 0; blockIndex < function.blocks.size(); ++blockIndex) {
+      const IrVirtualRegisterBlock &block = function.blocks[blockIndex];
+      if (!block.reachable) {
+        for (size_t index = block.startInstructionIndex; index < block.endInstructionIndex; ++index) {
+          instOffsets_[index] = emitter_.currentWordIndex();
+        }
+        continue;
+      }
+      bool fallsThrough = true;
+      for (size_t offset = 0; offset < block.instructions.size(); ++offset) {
+        const IrVirtualRegisterInstruction &instruction = block.instructions[offset];
+        const size_t index = block.startInstructionIndex + offset;
+        instOffsets_[index] = emitter_.currentWordIndex();
+        if (!emitInstruction(block, index, instruction)) {
+          return false;
+        }
+        const IrOpcode op = instruction.instruction.op;
+        fallsThrough = op != IrOpcode::Jump && op != IrOpcode::ReturnVoid && op != IrOpcode::ReturnI32 &&
+                       op != IrOpcode::ReturnI64 && op != IrOpcode::ReturnF32 && op != IrOpcode::ReturnF64;
+      }
+      if (fallsThrough && !emitEdgeMoves(block, block.endInstructionIndex)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr uint8_t ScratchA = EmitterT::RegisterScratchA;
+  static constexpr uint8_t ScratchB = EmitterT::RegisterScratchB;
+
+  const NativeEmitterRegisterLocation *locationFor(uint32_t vreg) {
+    if (vreg >= plan_.locations.size()) {
+      error_ = "native register plan references unknown virtual register";
+      return nullptr;
+    }
+    return &plan_.locations[vreg];
+  }
+
+  uint32_t spillLocal(const NativeEmitterRegisterLocation &location) const {
+    return layout_.spillLocalIndex + location.index;
+  }
+
+  // Returns the physical register holding `vreg`, reloading spilled values
+  // into `scratch` first.
+  bool useValue(uint32_t vreg, uint8_t scratch, uint8_t &out) {
+    const NativeEmitterRegisterLocation *location = locationFor(vreg);
+    if (location == nullptr) {
+      return false;
+    }
+    switch (location->kind) {
+      case NativeEmitterRegisterLocation::Kind::Register:
+        out = EmitterT::AllocatableRegisters[location->index];
+        return true;
+      case NativeEmitterRegisterLocation::Kind::SpillSlot:
+        emitter_.emitReloadRegFromLocal(scratch, spillLocal(*location));
+        out = scratch;
+        return true;
+      case NativeEmitterRegisterLocation::Kind::None:
+        break;
+    }
+    error_ = "native register plan uses a value with no location";
+    return false;
+  }
+
+  bool useValueInto(uint32_t vreg, uint8_t scratch) {
+    uint8_t reg = scratch;
+    if (!useValue(vreg, scratch, reg)) {
+      return false;
+    }
+    if (reg != scratch) {
+      emitter_.emitMovRegPublic(scratch, reg);
+    }
+    return true;
+  }
+
+  // Register that a new value for `vreg` should be computed into; spilled or
+  // dead values are computed into `scratch` and handed to defineValue.
+  bool defineRegister(uint32_t vreg, uint8_t scratch, uint8_t &out) {
+    const NativeEmitterRegisterLocation *location = locationFor(vreg);
+    if (location == nullptr) {
+      return false;
+    }
+    out = location->kind == NativeEmitterRegisterLocation::Kind::Register
+              ? EmitterT::AllocatableRegisters[location->index]
+              : scratch;
+    return true;
+  }
+
+  bool defineValue(uint32_t vreg, uint8_t reg) {
+    const NativeEmitterRegisterLocation *location = locationFor(vreg);
+    if (location == nullptr) {
+      return false;
+    }
+    switch (location->kind) {
+      case NativeEmitterRegisterLocation::Kind::Register: {
+        const uint8_t target = EmitterT::AllocatableRegisters[location->index];
+        if (target != reg) {
+          emitter_.emitMovRegPublic(target, reg);
+        }
+        break;
+      }
+      case NativeEmitterRegisterLocation::Kind::SpillSlot:
+        emitter_.emitSpillRegToLocal(spillLocal(*location), reg);
+        break;
+      case NativeEmitterRegisterLocation::Kind::None:
+        break;
+    }
+    return true;
+  }
+
+  // Allocatable registers whose values are live across instruction `index`
+  // (used before it and still needed after it). Instructions are visited in
+  // order, so the active set only ever moves forward.
+  std::vector<uint8_t> liveAcrossRegisters(size_t index) {
+    const uint32_t usePosition = static_cast<uint32_t>(index * 2);
+    const uint32_t defPosition = usePosition + 1;
+    while (nextByStart_ < registersByStart_.size() &&
+           plan_.locations[registersByStart_[nextByStart_]].startPosition <= usePosition) {
+      active_.push_back(registersByStart_[nextByStart_++]);
+    }
+    std::erase_if(active_, [&](uint32_t vreg) { return plan_.locations[vreg].endPosition < usePosition; });
+    std::vector<uint8_t> registers;
+    for (uint32_t vreg : active_) {
+      if (plan_.locations[vreg].endPosition >= defPosition) {
+        registers.push_back(static_cast<uint8_t>(plan_.locations[vreg].index));
+      }
+    }
+    return registers;
+  }
+
+  void saveRegisters(const std::vector<uint8_t> &registers) {
+    for (uint8_t registerIndex : registers) {
+      emitter_.emitSpillRegToLocal(layout_.registerSaveLocalIndex + registerIndex,
+                                   EmitterT::AllocatableRegisters[registerIndex]);
+    }
+  }
+
+  void restoreRegisters(const std::vector<uint8_t> &registers) {
+    for (uint8_t registerIndex : registers) {
+      emitter_.emitReloadRegFromLocal(EmitterT::AllocatableRegisters[registerIndex],
+                                      layout_.registerSaveLocalIndex + registerIndex);
+    }
+  }
+
+  bool pushUses(const IrVirtualRegisterInstruction &instruction) {
+    for (uint32_t vreg : instruction.useRegisters) {
+      uint8_t reg = ScratchA;
+      if (!useValue(vreg, ScratchA, reg)) {
+        return false;
+      }
+      emitter_.emitPushRegPublic(reg);
+    }
+    return true;
+  }
+
+  bool emitInstruction(const IrVirtualRegisterBlock &block,
+                       size_t index,
+                       const IrVirtualRegisterInstruction &instruction) {
+    const IrInstruction &inst = instruction.instruction;
+    const auto &uses = instruction.useRegisters;
+    const auto &defs = instruction.defRegisters;
+    NativeRegisterOp registerOp = NativeRegisterOp::Add;
+    switch (inst.op) {
+      case IrOpcode::PushI32:
+      case IrOpcode::PushI64:
+      case IrOpcode::PushF32:
+      case IrOpcode::PushF64: {
+        uint64_t value = inst.imm;
+        if (inst.op == IrOpcode::PushI32) {
+          value = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(inst.imm)));
+        } else if (inst.op == IrOpcode::PushF32) {
+          value = static_cast<uint32_t>(inst.imm);
+        }
+        uint8_t reg = ScratchA;
+        if (!defineRegister(defs.front(), ScratchA, reg)) {
+          return false;
+        }
+        emitter_.emitMovRegImm64Public(reg, value);
+        return defineValue(defs.front(), reg);
+      }
+      case IrOpcode::PushArgc:
+      case IrOpcode::LoadLocal: {
+        const uint32_t local =
+            inst.op == IrOpcode::PushArgc ? layout_.argcLocalIndex : static_cast<uint32_t>(inst.imm);
+        uint8_t reg = ScratchA;
+        if (!defineRegister(defs.front(), ScratchA, reg)) {
+          return false;
+        }
+        emitter_.emitLoadLocalToReg(reg, local);
+        return defineValue(defs.front(), reg);
+      }
+      case IrOpcode::StoreLocal: {
+        uint8_t reg = ScratchA;
+        if (!useValue(uses.front(), ScratchA, reg)) {
+          return false;
+        }
+        emitter_.emitStoreLocalFromReg(static_cast<uint32_t>(inst.imm), reg);
+        return true;
+      }
+      case IrOpcode::AddressOfLocal: {
+        uint8_t reg = ScratchA;
+        if (!defineRegister(defs.front(), ScratchA, reg)) {
+          return false;
+        }
+        emitter_.emitAddressOfLocalToReg(reg, static_cast<uint32_t>(inst.imm));
+        return defineValue(defs.front(), reg);
+      }
+      case IrOpcode::LoadIndirect: {
+        uint8_t address = ScratchA;
+        uint8_t reg = ScratchA;
+        if (!useValue(uses.front(), ScratchA, address) || !defineRegister(defs.front(), ScratchA, reg)) {
+          return false;
+        }
+        emitter_.emitLoadIndirectReg(reg, address);
+        return defineValue(defs.front(), reg);
+      }
+      case IrOpcode::StoreIndirect: {
+        // Reload into A before B: arm64 large-offset local access borrows x1
+        // unless the destination is x1 itself.
+        uint8_t value = ScratchA;
+        uint8_t address = ScratchB;
+        if (!useValue(uses[1], ScratchA, value) || !useValue(uses[0], ScratchB, address)) {
+          return false;
+        }
+        emitter_.emitStoreIndirectReg(address, value);
+        return defineValue(defs.front(), value);
+      }
+      case IrOpcode::Dup: {
+        uint8_t reg = ScratchA;
+        if (!useValue(uses.front(), ScratchA, reg)) {
+          return false;
+        }
+        return defineValue(defs.front(), reg);
+      }
+      case IrOpcode::Pop:
+        return true;
+      case IrOpcode::Jump: {
+        const size_t target = static_cast<size_t>(inst.imm);
+        if (!emitEdgeMoves(block, target)) {
+          return false;
+        }
+        emitBranchFixup(emitter_.emitJumpPlaceholder(), target, false);
+        return true;
+      }
+      case IrOpcode::JumpIfZero: {
+        const size_t target = static_cast<size_t>(inst.imm);
+        uint8_t condition = ScratchA;
+        if (!useValue(uses.front(), ScratchA, condition)) {
+          return false;
+        }
+        const IrVirtualRegisterEdge *takenEdge = edgeTo(block, target);
+        if (takenEdge == nullptr || takenEdge->stackMoves.empty()) {
+          emitBranchFixup(emitter_.emitJumpIfZeroRegPlaceholder(condition), target, true);
+          return true;
+        }
+        // The taken edge needs its own moves: skip over them when the
+        // condition is non-zero and fall through to the next block's moves.
+        const size_t skipIndex = emitter_.emitBranchIfNonZeroRegPlaceholder(condition);
+        if (!emitEdgeMoves(block, target)) {
+          return false;
+        }
+        emitBranchFixup(emitter_.emitJumpPlaceholder(), target, false);
+        emitter_.patchBranchIfNonZeroHere(skipIndex);
+        return true;
+      }
+      case IrOpcode::Call:
+      case IrOpcode::CallVoid: {
+        if (inst.imm >= module_.functions.size()) {
+          error_ = "native backend detected invalid call target";
+          return false;
+        }
+        const std::vector<uint8_t> saved = liveAcrossRegisters(index);
+        saveRegisters(saved);
+        if (!pushUses(instruction)) {
+          return false;
+        }
+        emitter_.flushValueStackCachePublic();
+        callFixups_.push_back({emitter_.emitCallPlaceholder(), static_cast<size_t>(inst.imm)});
+        restoreRegisters(saved);
+        if (inst.op == IrOpcode::Call) {
+          return defineValue(defs.front(), ScratchA);
+        }
+        return true;
+      }
+      case IrOpcode::ReturnVoid:
+        emitter_.emitReturnVoidWithFrameAndLink(layout_.framePointerLocalIndex, layout_.linkLocalIndex);
+        return true;
+      case IrOpcode::ReturnI32:
+      case IrOpcode::ReturnI64:
+      case IrOpcode::ReturnF32:
+      case IrOpcode::ReturnF64: {
+        uint8_t reg = ScratchA;
+        if (!useValue(uses.front(), ScratchA, reg)) {
+          return false;
+        }
+        emitter_.emitPushRegPublic(reg);
+        emitter_.emitReturnWithFrameAndLink(layout_.framePointerLocalIndex, layout_.linkLocalIndex);
+        return true;
+      }
+      default:
+        break;
+    }
+
+    if (registerOpForOpcode(inst.op, registerOp)) {
+      if (!useValueInto(uses.front(), ScratchA) || (uses.size() > 1 && !useValueInto(uses[1], ScratchB))) {
+        return false;
+      }
+      emitter_.emitRegisterOp(registerOp);
+      return defineValue(defs.front(), ScratchA);
+    }
+
+    std::vector<uint8_t> saved;
+    if (!stackRoutinePreservesAllocatableRegisters(inst.op)) {
+      saved = liveAcrossRegisters(index);
+    }
+    saveRegisters(saved);
+    if (!pushUses(instruction) || !emitStackInstruction_(inst)) {
+      return false;
+    }
+    if (!defs.empty()) {
+      emitter_.emitPopRegPublic(ScratchA);
+    }
+    restoreRegisters(saved);
+    return defs.empty() || defineValue(defs.front(), ScratchA);
+  }
+
+  const IrVirtualRegisterEdge *edgeTo(const IrVirtualRegisterBlock &block, size_t targetInstruction) const {
+    const auto blockIt = blockByStart_.find(targetInstruction);
+    if (blockIt == blockByStart_.end()) {
+      return nullptr;
+    }
+    for (const auto &edge : block.successorEdges) {
+      if (edge.successorBlockIndex == blockIt->second) {
+        return &edge;
+      }
+    }
+    return nullptr;
+  }
+
+  void emitBranchFixup(size_t codeIndex, size_t target, bool isConditional) {
+    NativeEmitterBranchFixup fixup;
+    fixup.codeIndex = codeIndex;
+    fixup.functionIndex = functionIndex_;
+    fixup.targetInst = target;
+    fixup.isConditional = isConditional;
+    branchFixups_.push_back(fixup);
+  }
+
+  bool slotFor(uint32_t vreg, RegisterValueSlot &out, bool &present) {
+    const NativeEmitterRegisterLocation *location = locationFor(vreg);
+    if (location == nullptr) {
+      return false;
+    }
+    present = location->kind != NativeEmitterRegisterLocation::Kind::None;
+    out.kind = location->kind == NativeEmitterRegisterLocation::Kind::Register ? RegisterValueSlot::Kind::Register
+                                                                               : RegisterValueSlot::Kind::Local;
+    out.index = location->kind == NativeEmitterRegisterLocation::Kind::Register ? location->index
+                                                                                : spillLocal(*location);
+    return true;
+  }
+
+  void emitSlotMove(const RegisterValueSlot &source, const RegisterValueSlot &destination) {
+    auto physical = [](const RegisterValueSlot &slot) {
+      return slot.kind == RegisterValueSlot::Kind::ScratchB ? ScratchB
+                                                            : EmitterT::AllocatableRegisters[slot.index];
+    };
+    if (source.kind == RegisterValueSlot::Kind::Local) {
+      if (destination.kind == RegisterValueSlot::Kind::Local) {
+        emitter_.emitReloadRegFromLocal(ScratchA, source.index);
+        emitter_.emitSpillRegToLocal(destination.index, ScratchA);
+      } else {
+        emitter_.emitReloadRegFromLocal(physical(destination), source.index);
+      }
+      return;
+    }
+    if (destination.kind == RegisterValueSlot::Kind::Local) {
+      emitter_.emitSpillRegToLocal(destination.index, physical(source));
+      return;
+    }
+    emitter_.emitMovRegPublic(physical(destination), physical(source));
+  }
+
+  // Resolves the edge into the block starting at `targetInstruction` as one
+  // parallel move: the IR stack's slots are renamed in every block, so the
+  // predecessor's exit values have to be shuffled into the successor's entry
+  // locations before control transfers.
+  bool emitEdgeMoves(const IrVirtualRegisterBlock &block, size_t targetInstruction) {
+    const IrVirtualRegisterEdge *edge = edgeTo(block, targetInstruction);
+    if (edge == nullptr) {
+      return true;
+    }
+    struct PendingMove {
+      RegisterValueSlot source;
+      RegisterValueSlot destination;
+    };
+    std::vector<PendingMove> pending;
+    for (const auto &move : edge->stackMoves) {
+      PendingMove pendingMove;
+      bool sourcePresent = false;
+      bool destinationPresent = false;
+      if (!slotFor(move.sourceRegister, pendingMove.source, sourcePresent) ||
+          !slotFor(move.destinationRegister, pendingMove.destination, destinationPresent)) {
+        return false;
+      }
+      if (!destinationPresent || pendingMove.source == pendingMove.destination) {
+        continue;
+      }
+      if (!sourcePresent) {
+        error_ = "native register plan moves a value with no location";
+        return false;
+      }
+      pending.push_back(pendingMove);
+    }
+
+    while (!pending.empty()) {
+      bool progressed = false;
+      for (size_t i = 0; i < pending.size(); ++i) {
+        const bool destinationStillRead =
+            std::any_of(pending.begin(), pending.end(), [&](const PendingMove &other) {
+              return other.source == pending[i].destination;
+            });
+        if (destinationStillRead) {
+          continue;
+        }
+        emitSlotMove(pending[i].source, pending[i].destination);
+        pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(i));
+        progressed = true;
+        break;
+      }
+      if (progressed) {
+        continue;
+      }
+      // Every remaining destination is still read: break the cycle by
+      // parking one destination's current value in scratch B.
+      const RegisterValueSlot parked = pending.front().destination;
+      const RegisterValueSlot scratch{RegisterValueSlot::Kind::ScratchB, 0};
+      emitSlotMove(parked, scratch);
+      for (auto &move : pending) {
+        if (move.source == parked) {
+          move.source = scratch;
+        }
+      }
+    }
+    return true;
+  }
+
+  const IrModule &module_;
+  size_t functionIndex_ = 0;
+  const NativeEmitterFunctionLayout &layout_;
+  const NativeEmitterRegisterPlan &plan_;
+  EmitterT &emitter_;
+  std::vector<NativeEmitterBranchFixup> &branchFixups_;
+  std::vector<NativeEmitterCallFixup> &callFixups_;
+  std::vector<size_t> &instOffsets_;
+  StackInstructionEmitter &emitStackInstruction_;
+  std::string &error_;
+  std::unordered_map<size_t, size_t> blockByStart_;
+  std::vector<uint32_t> registersByStart_;
+  std::vector<uint32_t> active_;
+  size_t nextByStart_ = 0;
+};
+
+template <typename EmitterT, typename StackInstructionEmitter>
+bool emitRegisterAllocatedFunction(const IrModule &module,
+                                   size_t functionIndex,
+                                   const NativeEmitterFunctionLayout &layout,
+                                   const NativeEmitterRegisterPlan &plan,
+                                   EmitterT &emitter,
+                                   std::vector<NativeEmitterBranchFixup> &branchFixups,
+                                   std::vector<NativeEmitterCallFixup> &callFixups,
+                                   std::vector<size_t> &instOffsets,
+                                   StackInstructionEmitter &emitStackInstruction,
+                                   std::string &error) {
+  RegisterAllocatedFunctionEmitter<EmitterT, StackInstructionEmitter> functionEmitter(
+      module, functionIndex, layout, plan, emitter, branchFixups, callFixups, instOffsets, emitStackInstruction, error);
+  return functionEmitter.emit();
+}
+
+} // namespace
+
 template <typename EmitterT>
 bool emitNativeFunctions(const IrModule &module,
                          size_t entryIndex,
                          const std::vector<NativeEmitterFunctionLayout> &layouts,
+                         const std::vector<NativeEmitterRegisterPlan> &registerPlans,
                          const std::vector<size_t> &emitOrder,
                          EmitterT &emitter,
                          std::vector<NativeEmitterBranchFixup> &branchFixups,
@@ -30,7 +697,7 @@ bool emitNativeFunctions(const IrModule &module,
     uint64_t frameSize = layout.frameSize;
     if (isEntryFunction) {
       constexpr uint64_t ValueStackBytes = 1024ull * 1024ull;
-      frameSize = alignTo(layout.localsSize + ValueStackBytes, 16);
+      frameSize = alignTo(layout.localsSize + ValueStackBytes + HeapStateBytes, 16);
     }
     functionOffsets[functionIndex] = emitter.currentWordIndex();
     if constexpr (kIsArm64) {
@@ -70,477 +737,526 @@ bool emitNativeFunctions(const IrModule &module,
       }
     }
     instOffsets[functionIndex].assign(fn.instructions.size() + 1, 0);
-    std::vector<bool> branchTargets(fn.instructions.size() + 1, false);
-    for (const auto &inst : fn.instructions) {
-      if ((inst.op == IrOpcode::Jump || inst.op == IrOpcode::JumpIfZero) &&
-          inst.imm <= fn.instructions.size()) {
-        branchTargets[static_cast<size_t>(inst.imm)] = true;
-      }
-    }
-
-    for (size_t index = 0; index < fn.instructions.size(); ++index) {
-      if (branchTargets[index]) {
-        emitter.flushValueStackCachePublic();
-      }
-      const auto &inst = fn.instructions[index];
-      instOffsets[functionIndex][index] = emitter.currentWordIndex();
+    // Emits one instruction as a stack-machine operation. Register-allocated
+    // functions also route every opcode without a register lowering through
+    // here, with its operands pushed and its result popped around the call.
+    auto emitStackInstruction = [&](const IrInstruction &inst) -> bool {
       switch (inst.op) {
-      case IrOpcode::PushI32:
-        emitter.emitPushI32(static_cast<int32_t>(inst.imm));
-        break;
-      case IrOpcode::PushI64:
-        emitter.emitPushI64(inst.imm);
-        break;
-      case IrOpcode::PushF32:
-        emitter.emitPushF32(static_cast<uint32_t>(inst.imm));
-        break;
-      case IrOpcode::PushF64:
-        emitter.emitPushF64(inst.imm);
-        break;
-      case IrOpcode::PushArgc:
-        emitter.emitLoadLocal(layout.argcLocalIndex);
-        break;
-      case IrOpcode::LoadLocal:
-        emitter.emitLoadLocal(static_cast<uint32_t>(inst.imm));
-        break;
-      case IrOpcode::StoreLocal:
-        emitter.emitStoreLocal(static_cast<uint32_t>(inst.imm));
-        break;
-      case IrOpcode::AddressOfLocal:
-        emitter.emitAddressOfLocal(static_cast<uint32_t>(inst.imm));
-        break;
-      case IrOpcode::LoadIndirect:
-        emitter.emitLoadIndirect();
-        break;
-      case IrOpcode::StoreIndirect:
-        emitter.emitStoreIndirect();
-        break;
-      case IrOpcode::HeapAlloc:
-        emitter.emitHeapAlloc();
-        break;
-      case IrOpcode::HeapFree:
-        emitter.emitHeapFree();
-        break;
-      case IrOpcode::HeapRealloc:
-        emitter.emitHeapRealloc();
-        break;
-      case IrOpcode::Dup:
-        emitter.emitDup();
-        break;
-      case IrOpcode::Pop:
-        emitter.emitPop();
-        break;
-      case IrOpcode::AddI32:
-        emitter.emitAdd();
-        break;
-      case IrOpcode::SubI32:
-        emitter.emitSub();
-        break;
-      case IrOpcode::MulI32:
-        emitter.emitMul();
-        break;
-      case IrOpcode::DivI32:
-        emitter.emitDiv();
-        break;
-      case IrOpcode::NegI32:
-        emitter.emitNeg();
-        break;
-      case IrOpcode::AddI64:
-        emitter.emitAdd();
-        break;
-      case IrOpcode::SubI64:
-        emitter.emitSub();
-        break;
-      case IrOpcode::MulI64:
-        emitter.emitMul();
-        break;
-      case IrOpcode::DivI64:
-        emitter.emitDiv();
-        break;
-      case IrOpcode::DivU64:
-        emitter.emitDivU();
-        break;
-      case IrOpcode::NegI64:
-        emitter.emitNeg();
-        break;
-      case IrOpcode::AddF32:
-        emitter.emitAddF32();
-        break;
-      case IrOpcode::SubF32:
-        emitter.emitSubF32();
-        break;
-      case IrOpcode::MulF32:
-        emitter.emitMulF32();
-        break;
-      case IrOpcode::DivF32:
-        emitter.emitDivF32();
-        break;
-      case IrOpcode::NegF32:
-        emitter.emitNegF32();
-        break;
-      case IrOpcode::AddF64:
-        emitter.emitAddF64();
-        break;
-      case IrOpcode::SubF64:
-        emitter.emitSubF64();
-        break;
-      case IrOpcode::MulF64:
-        emitter.emitMulF64();
-        break;
-      case IrOpcode::DivF64:
-        emitter.emitDivF64();
-        break;
-      case IrOpcode::NegF64:
-        emitter.emitNegF64();
-        break;
-      case IrOpcode::CmpEqI32:
-        emitter.emitCmpEq();
-        break;
-      case IrOpcode::CmpNeI32:
-        emitter.emitCmpNe();
-        break;
-      case IrOpcode::CmpLtI32:
-        emitter.emitCmpLt();
-        break;
-      case IrOpcode::CmpLeI32:
-        emitter.emitCmpLe();
-        break;
-      case IrOpcode::CmpGtI32:
-        emitter.emitCmpGt();
-        break;
-      case IrOpcode::CmpGeI32:
-        emitter.emitCmpGe();
-        break;
-      case IrOpcode::CmpEqI64:
-        emitter.emitCmpEq();
-        break;
-      case IrOpcode::CmpNeI64:
-        emitter.emitCmpNe();
-        break;
-      case IrOpcode::CmpLtI64:
-        emitter.emitCmpLt();
-        break;
-      case IrOpcode::CmpLeI64:
-        emitter.emitCmpLe();
-        break;
-      case IrOpcode::CmpGtI64:
-        emitter.emitCmpGt();
-        break;
-      case IrOpcode::CmpGeI64:
-        emitter.emitCmpGe();
-        break;
-      case IrOpcode::CmpLtU64:
-        emitter.emitCmpLtU();
-        break;
-      case IrOpcode::CmpLeU64:
-        emitter.emitCmpLeU();
-        break;
-      case IrOpcode::CmpGtU64:
-        emitter.emitCmpGtU();
-        break;
-      case IrOpcode::CmpGeU64:
-        emitter.emitCmpGeU();
-        break;
-      case IrOpcode::CmpEqF32:
-        emitter.emitCmpEqF32();
-        break;
-      case IrOpcode::CmpNeF32:
-        emitter.emitCmpNeF32();
-        break;
-      case IrOpcode::CmpLtF32:
-        emitter.emitCmpLtF32();
-        break;
-      case IrOpcode::CmpLeF32:
-        emitter.emitCmpLeF32();
-        break;
-      case IrOpcode::CmpGtF32:
-        emitter.emitCmpGtF32();
-        break;
-      case IrOpcode::CmpGeF32:
-        emitter.emitCmpGeF32();
-        break;
-      case IrOpcode::CmpEqF64:
-        emitter.emitCmpEqF64();
-        break;
-      case IrOpcode::CmpNeF64:
-        emitter.emitCmpNeF64();
-        break;
-      case IrOpcode::CmpLtF64:
-        emitter.emitCmpLtF64();
-        break;
-      case IrOpcode::CmpLeF64:
-        emitter.emitCmpLeF64();
-        break;
-      case IrOpcode::CmpGtF64:
-        emitter.emitCmpGtF64();
-        break;
-      case IrOpcode::CmpGeF64:
-        emitter.emitCmpGeF64();
-        break;
-      case IrOpcode::ConvertI32ToF32:
-        emitter.emitConvertI32ToF32();
-        break;
-      case IrOpcode::ConvertI32ToF64:
-        emitter.emitConvertI32ToF64();
-        break;
-      case IrOpcode::ConvertI64ToF32:
-        emitter.emitConvertI64ToF32();
-        break;
-      case IrOpcode::ConvertI64ToF64:
-        emitter.emitConvertI64ToF64();
-        break;
-      case IrOpcode::ConvertU64ToF32:
-        emitter.emitConvertU64ToF32();
-        break;
-      case IrOpcode::ConvertU64ToF64:
-        emitter.emitConvertU64ToF64();
-        break;
-      case IrOpcode::ConvertF32ToI32:
-        emitter.emitConvertF32ToI32();
-        break;
-      case IrOpcode::ConvertF32ToI64:
-        emitter.emitConvertF32ToI64();
-        break;
-      case IrOpcode::ConvertF32ToU64:
-        emitter.emitConvertF32ToU64();
-        break;
-      case IrOpcode::ConvertF64ToI32:
-        emitter.emitConvertF64ToI32();
-        break;
-      case IrOpcode::ConvertF64ToI64:
-        emitter.emitConvertF64ToI64();
-        break;
-      case IrOpcode::ConvertF64ToU64:
-        emitter.emitConvertF64ToU64();
-        break;
-      case IrOpcode::ConvertF32ToF64:
-        emitter.emitConvertF32ToF64();
-        break;
-      case IrOpcode::ConvertF64ToF32:
-        emitter.emitConvertF64ToF32();
-        break;
-      case IrOpcode::JumpIfZero: {
-        NativeEmitterBranchFixup fixup;
-        fixup.codeIndex = emitter.emitJumpIfZeroPlaceholder();
-        fixup.functionIndex = functionIndex;
-        fixup.targetInst = static_cast<size_t>(inst.imm);
-        fixup.isConditional = true;
-        branchFixups.push_back(fixup);
-        break;
-      }
-      case IrOpcode::Jump: {
-        emitter.flushValueStackCachePublic();
-        NativeEmitterBranchFixup fixup;
-        fixup.codeIndex = emitter.emitJumpPlaceholder();
-        fixup.functionIndex = functionIndex;
-        fixup.targetInst = static_cast<size_t>(inst.imm);
-        fixup.isConditional = false;
-        branchFixups.push_back(fixup);
-        break;
-      }
-      case IrOpcode::Call: {
-        if (inst.imm >= module.functions.size()) {
-          error = "native backend detected invalid call target";
-          return false;
+        case IrOpcode::PushI32:
+          emitter.emitPushI32(static_cast<int32_t>(inst.imm));
+          break;
+        case IrOpcode::PushI64:
+          emitter.emitPushI64(inst.imm);
+          break;
+        case IrOpcode::PushF32:
+          emitter.emitPushF32(static_cast<uint32_t>(inst.imm));
+          break;
+        case IrOpcode::PushF64:
+          emitter.emitPushF64(inst.imm);
+          break;
+        case IrOpcode::PushArgc:
+          emitter.emitLoadLocal(layout.argcLocalIndex);
+          break;
+        case IrOpcode::LoadLocal:
+          emitter.emitLoadLocal(static_cast<uint32_t>(inst.imm));
+          break;
+        case IrOpcode::StoreLocal:
+          emitter.emitStoreLocal(static_cast<uint32_t>(inst.imm));
+          break;
+        case IrOpcode::AddressOfLocal:
+          emitter.emitAddressOfLocal(static_cast<uint32_t>(inst.imm));
+          break;
+        case IrOpcode::LoadIndirect:
+          emitter.emitLoadIndirect();
+          break;
+        case IrOpcode::StoreIndirect:
+          emitter.emitStoreIndirect();
+          break;
+        case IrOpcode::HeapAlloc:
+          emitter.emitHeapAlloc();
+          break;
+        case IrOpcode::HeapFree:
+          emitter.emitHeapFree();
+          break;
+        case IrOpcode::HeapRealloc:
+          emitter.emitHeapRealloc();
+          break;
+        case IrOpcode::Dup:
+          emitter.emitDup();
+          break;
+        case IrOpcode::Pop:
+          emitter.emitPop();
+          break;
+        case IrOpcode::AddI32:
+          emitter.emitAdd();
+          break;
+        case IrOpcode::SubI32:
+          emitter.emitSub();
+          break;
+        case IrOpcode::MulI32:
+          emitter.emitMul();
+          break;
+        case IrOpcode::DivI32:
+          emitter.emitDiv();
+          break;
+        case IrOpcode::NegI32:
+          emitter.emitNeg();
+          break;
+        case IrOpcode::AddI64:
+          emitter.emitAdd();
+          break;
+        case IrOpcode::SubI64:
+          emitter.emitSub();
+          break;
+        case IrOpcode::MulI64:
+          emitter.emitMul();
+          break;
+        case IrOpcode::DivI64:
+          emitter.emitDiv();
+          break;
+        case IrOpcode::DivU64:
+          emitter.emitDivU();
+          break;
+        case IrOpcode::NegI64:
+          emitter.emitNeg();
+          break;
+        case IrOpcode::AddF32:
+          emitter.emitAddF32();
+          break;
+        case IrOpcode::SubF32:
+          emitter.emitSubF32();
+          break;
+        case IrOpcode::MulF32:
+          emitter.emitMulF32();
+          break;
+        case IrOpcode::DivF32:
+          emitter.emitDivF32();
+          break;
+        case IrOpcode::NegF32:
+          emitter.emitNegF32();
+          break;
+        case IrOpcode::AddF64:
+          emitter.emitAddF64();
+          break;
+        case IrOpcode::SubF64:
+          emitter.emitSubF64();
+          break;
+        case IrOpcode::MulF64:
+          emitter.emitMulF64();
+          break;
+        case IrOpcode::DivF64:
+          emitter.emitDivF64();
+          break;
+        case IrOpcode::NegF64:
+          emitter.emitNegF64();
+          break;
+        case IrOpcode::CmpEqI32:
+          emitter.emitCmpEq();
+          break;
+        case IrOpcode::CmpNeI32:
+          emitter.emitCmpNe();
+          break;
+        case IrOpcode::CmpLtI32:
+          emitter.emitCmpLt();
+          break;
+        case IrOpcode::CmpLeI32:
+          emitter.emitCmpLe();
+          break;
+        case IrOpcode::CmpGtI32:
+          emitter.emitCmpGt();
+          break;
+        case IrOpcode::CmpGeI32:
+          emitter.emitCmpGe();
+          break;
+        case IrOpcode::CmpEqI64:
+          emitter.emitCmpEq();
+          break;
+        case IrOpcode::CmpNeI64:
+          emitter.emitCmpNe();
+          break;
+        case IrOpcode::CmpLtI64:
+          emitter.emitCmpLt();
+          break;
+        case IrOpcode::CmpLeI64:
+          emitter.emitCmpLe();
+          break;
+        case IrOpcode::CmpGtI64:
+          emitter.emitCmpGt();
+          break;
+        case IrOpcode::CmpGeI64:
+          emitter.emitCmpGe();
+          break;
+        case IrOpcode::CmpLtU64:
+          emitter.emitCmpLtU();
+          break;
+        case IrOpcode::CmpLeU64:
+          emitter.emitCmpLeU();
+          break;
+        case IrOpcode::CmpGtU64:
+          emitter.emitCmpGtU();
+          break;
+        case IrOpcode::CmpGeU64:
+          emitter.emitCmpGeU();
+          break;
+        case IrOpcode::CmpEqF32:
+          emitter.emitCmpEqF32();
+          break;
+        case IrOpcode::CmpNeF32:
+          emitter.emitCmpNeF32();
+          break;
+        case IrOpcode::CmpLtF32:
+          emitter.emitCmpLtF32();
+          break;
+        case IrOpcode::CmpLeF32:
+          emitter.emitCmpLeF32();
+          break;
+        case IrOpcode::CmpGtF32:
+          emitter.emitCmpGtF32();
+          break;
+        case IrOpcode::CmpGeF32:
+          emitter.emitCmpGeF32();
+          break;
+        case IrOpcode::CmpEqF64:
+          emitter.emitCmpEqF64();
+          break;
+        case IrOpcode::CmpNeF64:
+          emitter.emitCmpNeF64();
+          break;
+        case IrOpcode::CmpLtF64:
+          emitter.emitCmpLtF64();
+          break;
+        case IrOpcode::CmpLeF64:
+          emitter.emitCmpLeF64();
+          break;
+        case IrOpcode::CmpGtF64:
+          emitter.emitCmpGtF64();
+          break;
+        case IrOpcode::CmpGeF64:
+          emitter.emitCmpGeF64();
+          break;
+        case IrOpcode::ConvertI32ToF32:
+          emitter.emitConvertI32ToF32();
+          break;
+        case IrOpcode::ConvertI32ToF64:
+          emitter.emitConvertI32ToF64();
+          break;
+        case IrOpcode::ConvertI64ToF32:
+          emitter.emitConvertI64ToF32();
+          break;
+        case IrOpcode::ConvertI64ToF64:
+          emitter.emitConvertI64ToF64();
+          break;
+        case IrOpcode::ConvertU64ToF32:
+          emitter.emitConvertU64ToF32();
+          break;
+        case IrOpcode::ConvertU64ToF64:
+          emitter.emitConvertU64ToF64();
+          break;
+        case IrOpcode::ConvertF32ToI32:
+          emitter.emitConvertF32ToI32();
+          break;
+        case IrOpcode::ConvertF32ToI64:
+          emitter.emitConvertF32ToI64();
+          break;
+        case IrOpcode::ConvertF32ToU64:
+          emitter.emitConvertF32ToU64();
+          break;
+        case IrOpcode::ConvertF64ToI32:
+          emitter.emitConvertF64ToI32();
+          break;
+        case IrOpcode::ConvertF64ToI64:
+          emitter.emitConvertF64ToI64();
+          break;
+        case IrOpcode::ConvertF64ToU64:
+          emitter.emitConvertF64ToU64();
+          break;
+        case IrOpcode::ConvertF32ToF64:
+          emitter.emitConvertF32ToF64();
+          break;
+        case IrOpcode::ConvertF64ToF32:
+          emitter.emitConvertF64ToF32();
+          break;
+        case IrOpcode::MathUnaryF32:
+        case IrOpcode::MathUnaryF64:
+          // Lowering outlines every other math function into a shared IR
+          // routine for this backend; only sqrt maps onto one instruction.
+          if (inst.imm != static_cast<uint64_t>(IrMathFunction::Sqrt)) {
+            error = "native backend requires outlined math function: " +
+                    std::string(irMathFunctionName(static_cast<IrMathFunction>(inst.imm)));
+            return false;
+          }
+          if (inst.op == IrOpcode::MathUnaryF64) {
+            emitter.emitSqrtF64();
+          } else {
+            emitter.emitSqrtF32();
+          }
+          break;
+        case IrOpcode::JumpIfZero: {
+          NativeEmitterBranchFixup fixup;
+          fixup.codeIndex = emitter.emitJumpIfZeroPlaceholder();
+          fixup.functionIndex = functionIndex;
+          fixup.targetInst = static_cast<size_t>(inst.imm);
+          fixup.isConditional = true;
+          branchFixups.push_back(fixup);
+          break;
         }
-        // The value-stack cache register is a single global slot with no
-        // save/restore around calls, so anything left cached here (e.g.
-        // an operand pushed just before this call, still awaiting a
-        // later pop) would be silently clobbered by the callee's own use
-        // of the same register - flush it to the real, memory-backed
-        // stack first so it survives the call. This is the TODO-4747
-        // Step 3 finding, confirmed by actually running compiled output:
-        // a function that used a call's result in further arithmetic
-        // segfaulted/produced wrong results without this flush.
-        emitter.flushValueStackCachePublic();
-        callFixups.push_back({emitter.emitCallPlaceholder(), static_cast<size_t>(inst.imm)});
-        emitter.emitPushReg0();
-        break;
-      }
-      case IrOpcode::CallVoid: {
-        if (inst.imm >= module.functions.size()) {
-          error = "native backend detected invalid call target";
-          return false;
+        case IrOpcode::Jump: {
+          emitter.flushValueStackCachePublic();
+          NativeEmitterBranchFixup fixup;
+          fixup.codeIndex = emitter.emitJumpPlaceholder();
+          fixup.functionIndex = functionIndex;
+          fixup.targetInst = static_cast<size_t>(inst.imm);
+          fixup.isConditional = false;
+          branchFixups.push_back(fixup);
+          break;
         }
-        emitter.flushValueStackCachePublic();
-        callFixups.push_back({emitter.emitCallPlaceholder(), static_cast<size_t>(inst.imm)});
-        break;
-      }
-      case IrOpcode::ReturnVoid:
-        emitter.emitReturnVoidWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
-        break;
-      case IrOpcode::ReturnI32:
-        emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
-        break;
-      case IrOpcode::ReturnI64:
-        emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
-        break;
-      case IrOpcode::ReturnF32:
-        emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
-        break;
-      case IrOpcode::ReturnF64:
-        emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
-        break;
-      case IrOpcode::PrintI32: {
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        emitter.emitPrintSigned(layout.scratchOffset, layout.scratchBytes, newline, fd);
-        break;
-      }
-      case IrOpcode::PrintI64: {
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        emitter.emitPrintSigned(layout.scratchOffset, layout.scratchBytes, newline, fd);
-        break;
-      }
-      case IrOpcode::PrintU64: {
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        emitter.emitPrintUnsigned(layout.scratchOffset, layout.scratchBytes, newline, fd);
-        break;
-      }
-      case IrOpcode::PrintString: {
-        uint64_t stringIndex = decodePrintStringIndex(inst.imm);
-        if (stringIndex >= module.stringTable.size()) {
-          error = "native backend encountered invalid string index";
-          return false;
+        case IrOpcode::Call: {
+          if (inst.imm >= module.functions.size()) {
+            error = "native backend detected invalid call target";
+            return false;
+          }
+          // The value-stack cache register is a single global slot with no
+          // save/restore around calls, so anything left cached here (e.g.
+          // an operand pushed just before this call, still awaiting a
+          // later pop) would be silently clobbered by the callee's own use
+          // of the same register - flush it to the real, memory-backed
+          // stack first so it survives the call. This is the TODO-4747
+          // Step 3 finding, confirmed by actually running compiled output:
+          // a function that used a call's result in further arithmetic
+          // segfaulted/produced wrong results without this flush.
+          emitter.flushValueStackCachePublic();
+          callFixups.push_back({emitter.emitCallPlaceholder(), static_cast<size_t>(inst.imm)});
+          emitter.emitPushReg0();
+          break;
         }
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        size_t fixupIndex = emitter.emitPrintStringPlaceholder(
-            module.stringTable[static_cast<size_t>(stringIndex)].size(), layout.scratchOffset, newline, fd);
-        stringFixups.push_back({fixupIndex, static_cast<uint32_t>(stringIndex)});
-        break;
-      }
-      case IrOpcode::PrintStringDynamic: {
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        size_t fixupIndex =
-            emitter.emitPrintStringDynamicPlaceholder(stringTableOffsetDelta, stringOffsetTableSize,
-                                                      layout.scratchOffset, newline, fd);
-        stringTableFixups.push_back(fixupIndex);
-        break;
-      }
-      case IrOpcode::FileOpenRead: {
-        if (inst.imm >= module.stringTable.size()) {
-          error = "native backend encountered invalid string index";
-          return false;
+        case IrOpcode::CallVoid: {
+          if (inst.imm >= module.functions.size()) {
+            error = "native backend detected invalid call target";
+            return false;
+          }
+          emitter.flushValueStackCachePublic();
+          callFixups.push_back({emitter.emitCallPlaceholder(), static_cast<size_t>(inst.imm)});
+          break;
         }
-        size_t fixupIndex = emitter.emitFileOpenPlaceholder(O_RDONLY, 0);
-        stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
-        break;
-      }
-      case IrOpcode::FileOpenWrite: {
-        if (inst.imm >= module.stringTable.size()) {
-          error = "native backend encountered invalid string index";
-          return false;
+        case IrOpcode::ReturnVoid:
+          emitter.emitReturnVoidWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
+          break;
+        case IrOpcode::ReturnI32:
+          emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
+          break;
+        case IrOpcode::ReturnI64:
+          emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
+          break;
+        case IrOpcode::ReturnF32:
+          emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
+          break;
+        case IrOpcode::ReturnF64:
+          emitter.emitReturnWithFrameAndLink(layout.framePointerLocalIndex, layout.linkLocalIndex);
+          break;
+        case IrOpcode::PrintI32: {
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          emitter.emitPrintSigned(layout.scratchOffset, layout.scratchBytes, newline, fd);
+          break;
         }
-        size_t fixupIndex = emitter.emitFileOpenPlaceholder(O_WRONLY | O_CREAT | O_TRUNC, 0644);
-        stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
-        break;
-      }
-      case IrOpcode::FileOpenAppend: {
-        if (inst.imm >= module.stringTable.size()) {
-          error = "native backend encountered invalid string index";
-          return false;
+        case IrOpcode::PrintI64: {
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          emitter.emitPrintSigned(layout.scratchOffset, layout.scratchBytes, newline, fd);
+          break;
         }
-        size_t fixupIndex = emitter.emitFileOpenPlaceholder(O_WRONLY | O_CREAT | O_APPEND, 0644);
-        stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
-        break;
-      }
-      case IrOpcode::FileOpenReadDynamic: {
-        size_t fixupIndex = emitter.emitFileOpenDynamicPlaceholder(stringTableOffsetDelta, O_RDONLY, 0);
-        stringTableFixups.push_back(fixupIndex);
-        break;
-      }
-      case IrOpcode::FileOpenWriteDynamic: {
-        size_t fixupIndex =
-            emitter.emitFileOpenDynamicPlaceholder(stringTableOffsetDelta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-        stringTableFixups.push_back(fixupIndex);
-        break;
-      }
-      case IrOpcode::FileOpenAppendDynamic: {
-        size_t fixupIndex =
-            emitter.emitFileOpenDynamicPlaceholder(stringTableOffsetDelta, O_WRONLY | O_CREAT | O_APPEND, 0644);
-        stringTableFixups.push_back(fixupIndex);
-        break;
-      }
-      case IrOpcode::FileReadByte:
-        emitter.emitFileReadByte(static_cast<uint32_t>(inst.imm), layout.scratchOffset);
-        break;
-      case IrOpcode::FileClose:
-        emitter.emitFileClose();
-        break;
-      case IrOpcode::FileFlush:
-        emitter.emitFileFlush();
-        break;
-      case IrOpcode::FileWriteI32:
-        emitter.emitFileWriteI32(layout.scratchOffset, layout.scratchBytes);
-        break;
-      case IrOpcode::FileWriteI64:
-        emitter.emitFileWriteI64(layout.scratchOffset, layout.scratchBytes);
-        break;
-      case IrOpcode::FileWriteU64:
-        emitter.emitFileWriteU64(layout.scratchOffset, layout.scratchBytes);
-        break;
-      case IrOpcode::FileWriteString: {
-        if (inst.imm >= module.stringTable.size()) {
-          error = "native backend encountered invalid string index";
-          return false;
+        case IrOpcode::PrintU64: {
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          emitter.emitPrintUnsigned(layout.scratchOffset, layout.scratchBytes, newline, fd);
+          break;
         }
-        size_t fixupIndex = emitter.emitFileWriteStringPlaceholder(
-            module.stringTable[static_cast<size_t>(inst.imm)].size(), layout.scratchOffset);
-        stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
-        break;
-      }
-      case IrOpcode::FileWriteStringDynamic: {
-        size_t fixupIndex = emitter.emitFileWriteStringDynamicPlaceholder(
-            stringTableOffsetDelta, stringOffsetTableSize);
-        stringTableFixups.push_back(fixupIndex);
-        break;
+        case IrOpcode::PrintString: {
+          uint64_t stringIndex = decodePrintStringIndex(inst.imm);
+          if (stringIndex >= module.stringTable.size()) {
+            error = "native backend encountered invalid string index";
+            return false;
+          }
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          size_t fixupIndex = emitter.emitPrintStringPlaceholder(
+              module.stringTable[static_cast<size_t>(stringIndex)].size(), layout.scratchOffset, newline, fd);
+          stringFixups.push_back({fixupIndex, static_cast<uint32_t>(stringIndex)});
+          break;
+        }
+        case IrOpcode::PrintStringDynamic: {
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          size_t fixupIndex =
+              emitter.emitPrintStringDynamicPlaceholder(stringTableOffsetDelta, stringOffsetTableSize,
+                                                        layout.scratchOffset, newline, fd);
+          stringTableFixups.push_back(fixupIndex);
+          break;
+        }
+        case IrOpcode::FileOpenRead: {
+          if (inst.imm >= module.stringTable.size()) {
+            error = "native backend encountered invalid string index";
+            return false;
+          }
+          size_t fixupIndex = emitter.emitFileOpenPlaceholder(O_RDONLY, 0);
+          stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
+          break;
+        }
+        case IrOpcode::FileOpenWrite: {
+          if (inst.imm >= module.stringTable.size()) {
+            error = "native backend encountered invalid string index";
+            return false;
+          }
+          size_t fixupIndex = emitter.emitFileOpenPlaceholder(O_WRONLY | O_CREAT | O_TRUNC, 0644);
+          stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
+          break;
+        }
+        case IrOpcode::FileOpenAppend: {
+          if (inst.imm >= module.stringTable.size()) {
+            error = "native backend encountered invalid string index";
+            return false;
+          }
+          size_t fixupIndex = emitter.emitFileOpenPlaceholder(O_WRONLY | O_CREAT | O_APPEND, 0644);
+          stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
+          break;
+        }
+        case IrOpcode::FileOpenReadDynamic: {
+          size_t fixupIndex = emitter.emitFileOpenDynamicPlaceholder(stringTableOffsetDelta, O_RDONLY, 0);
+          stringTableFixups.push_back(fixupIndex);
+          break;
+        }
+        case IrOpcode::FileOpenWriteDynamic: {
+          size_t fixupIndex =
+              emitter.emitFileOpenDynamicPlaceholder(stringTableOffsetDelta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+          stringTableFixups.push_back(fixupIndex);
+          break;
+        }
+        case IrOpcode::FileOpenAppendDynamic: {
+          size_t fixupIndex =
+              emitter.emitFileOpenDynamicPlaceholder(stringTableOffsetDelta, O_WRONLY | O_CREAT | O_APPEND, 0644);
+          stringTableFixups.push_back(fixupIndex);
+          break;
+        }
+        case IrOpcode::FileReadByte:
+          emitter.emitFileReadByte(static_cast<uint32_t>(inst.imm), layout.scratchOffset);
+          break;
+        case IrOpcode::FileClose:
+          emitter.emitFileClose();
+          break;
+        case IrOpcode::FileFlush:
+          emitter.emitFileFlush();
+          break;
+        case IrOpcode::FileWriteI32:
+          emitter.emitFileWriteI32(layout.scratchOffset, layout.scratchBytes);
+          break;
+        case IrOpcode::FileWriteI64:
+          emitter.emitFileWriteI64(layout.scratchOffset, layout.scratchBytes);
+          break;
+        case IrOpcode::FileWriteU64:
+          emitter.emitFileWriteU64(layout.scratchOffset, layout.scratchBytes);
+          break;
+        case IrOpcode::FileWriteString: {
+          if (inst.imm >= module.stringTable.size()) {
+            error = "native backend encountered invalid string index";
+            return false;
+          }
+          size_t fixupIndex = emitter.emitFileWriteStringPlaceholder(
+              module.stringTable[static_cast<size_t>(inst.imm)].size(), layout.scratchOffset);
+          stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
+          break;
+        }
+        case IrOpcode::FileWriteStringDynamic: {
+          size_t fixupIndex = emitter.emitFileWriteStringDynamicPlaceholder(
+              stringTableOffsetDelta, stringOffsetTableSize);
+          stringTableFixups.push_back(fixupIndex);
+          break;
+        }
+        case IrOpcode::FileWriteByte:
+          emitter.emitFileWriteByte(layout.scratchOffset);
+          break;
+        case IrOpcode::FileWriteNewline:
+          emitter.emitFileWriteNewline(layout.scratchOffset);
+          break;
+        case IrOpcode::FileReadBytes:
+          emitter.emitFileReadBytes();
+          break;
+        case IrOpcode::FileWriteBytes:
+          emitter.emitFileWriteBytes();
+          break;
+        case IrOpcode::FileMapBytes:
+          emitter.emitFileMapBytes(static_cast<uint32_t>(inst.imm));
+          break;
+        case IrOpcode::PrintArgv: {
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          emitter.emitPrintArgv(layout.argcLocalIndex, layout.argvLocalIndex, layout.scratchOffset, newline, fd);
+          break;
+        }
+        case IrOpcode::PrintArgvUnsafe: {
+          uint64_t flags = decodePrintFlags(inst.imm);
+          bool newline = (flags & PrintFlagNewline) != 0;
+          uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
+          emitter.emitPrintArgv(layout.argcLocalIndex, layout.argvLocalIndex, layout.scratchOffset, newline, fd);
+          break;
+        }
+        case IrOpcode::LoadStringByte: {
+          if (inst.imm >= module.stringTable.size()) {
+            error = "native backend encountered invalid string index";
+            return false;
+          }
+          size_t fixupIndex = emitter.emitLoadStringBytePlaceholder();
+          stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
+          break;
+        }
+        case IrOpcode::LoadStringLength: {
+          size_t fixupIndex = emitter.emitLoadStringLengthPlaceholder(stringOffsetTableSize);
+          stringTableFixups.push_back(fixupIndex);
+          break;
+        }
+      default:
+        error = "unsupported IR opcode for native backend";
+        return false;
       }
-      case IrOpcode::FileWriteByte:
-        emitter.emitFileWriteByte(layout.scratchOffset);
-        break;
-      case IrOpcode::FileWriteNewline:
-        emitter.emitFileWriteNewline(layout.scratchOffset);
-        break;
-      case IrOpcode::PrintArgv: {
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        emitter.emitPrintArgv(layout.argcLocalIndex, layout.argvLocalIndex, layout.scratchOffset, newline, fd);
-        break;
+      return true;
+    };
+
+    if (registerPlans[functionIndex].enabled) {
+      if (!emitRegisterAllocatedFunction(module,
+                                         functionIndex,
+                                         layout,
+                                         registerPlans[functionIndex],
+                                         emitter,
+                                         branchFixups,
+                                         callFixups,
+                                         instOffsets[functionIndex],
+                                         emitStackInstruction,
+                                         error)) {
+        return false;
       }
-      case IrOpcode::PrintArgvUnsafe: {
-        uint64_t flags = decodePrintFlags(inst.imm);
-        bool newline = (flags & PrintFlagNewline) != 0;
-        uint64_t fd = (flags & PrintFlagStderr) ? 2 : 1;
-        emitter.emitPrintArgv(layout.argcLocalIndex, layout.argvLocalIndex, layout.scratchOffset, newline, fd);
-        break;
+    } else {
+      std::vector<bool> branchTargets(fn.instructions.size() + 1, false);
+      for (const auto &inst : fn.instructions) {
+        if ((inst.op == IrOpcode::Jump || inst.op == IrOpcode::JumpIfZero) &&
+            inst.imm <= fn.instructions.size()) {
+          branchTargets[static_cast<size_t>(inst.imm)] = true;
+        }
       }
-      case IrOpcode::LoadStringByte: {
-        if (inst.imm >= module.stringTable.size()) {
-          error = "native backend encountered invalid string index";
+
+      for (size_t index = 0; index < fn.instructions.size(); ++index) {
+        if (branchTargets[index]) {
+          emitter.flushValueStackCachePublic();
+        }
+        const auto &inst = fn.instructions[index];
+        instOffsets[functionIndex][index] = emitter.currentWordIndex();
+        if (!emitStackInstruction(inst)) {
           return false;
         }
-        size_t fixupIndex = emitter.emitLoadStringBytePlaceholder();
-        stringFixups.push_back({fixupIndex, static_cast<uint32_t>(inst.imm)});
-        break;
-      }
-      case IrOpcode::LoadStringLength: {
-        size_t fixupIndex = emitter.emitLoadStringLengthPlaceholder(stringOffsetTableSize);
-        stringTableFixups.push_back(fixupIndex);
-        break;
-      }
-      default:
-        error = "unsupported IR opcode for native backend";
-        return false;
       }
     }
 
@@ -563,6 +1279,7 @@ bool emitNativeFunctions(const IrModule &module,
 template bool emitNativeFunctions<Arm64Emitter>(const IrModule &,
                                                 size_t,
                                                 const std::vector<NativeEmitterFunctionLayout> &,
+                                                const std::vector<NativeEmitterRegisterPlan> &,
                                                 const std::vector<size_t> &,
                                                 Arm64Emitter &,
                                                 std::vector<NativeEmitterBranchFixup> &,
@@ -579,6 +1296,7 @@ template bool emitNativeFunctions<Arm64Emitter>(const IrModule &,
 template bool emitNativeFunctions<X64Emitter>(const IrModule &,
                                               size_t,
                                               const std::vector<NativeEmitterFunctionLayout> &,
+                                              const std::vector<NativeEmitterRegisterPlan> &,
                                               const std::vector<size_t> &,
                                               X64Emitter &,
                                               std::vector<NativeEmitterBranchFixup> &,
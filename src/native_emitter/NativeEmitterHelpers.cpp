@@ -159,6 +159,12 @@ bool computeMaxStackDepth(const IrFunction &fn, const IrModule &module, int64_t
         return "FileWriteByte";
       case IrOpcode::FileWriteNewline:
         return "FileWriteNewline";
+      case IrOpcode::FileReadBytes:
+        return "FileReadBytes";
+      case IrOpcode::FileWriteBytes:
+        return "FileWriteBytes";
+      case IrOpcode::FileMapBytes:
+        return "FileMapBytes";
       case IrOpcode::Call:
         return "Call";
       case IrOpcode::CallVoid:
@@ -245,6 +251,14 @@ bool computeMaxStackDepth(const IrFunction &fn, const IrModule &module, int64_t
         return "ConvertF32ToF64";
       case IrOpcode::ConvertF64ToF32:
         return "ConvertF64ToF32";
+      case IrOpcode::MathUnaryF32:
+        return "MathUnaryF32";
+      case IrOpcode::MathUnaryF64:
+        return "MathUnaryF64";
+      case IrOpcode::MathBinaryF32:
+        return "MathBinaryF32";
+      case IrOpcode::MathBinaryF64:
+        return "MathBinaryF64";
       default:
         return "Unknown";
     }
@@ -338,7 +352,12 @@ bool computeMaxStackDepth(const IrFunction &fn, const IrModule &module, int64_t
       case IrOpcode::ConvertF64ToU64:
       case IrOpcode::ConvertF32ToF64:
       case IrOpcode::ConvertF64ToF32:
+      case IrOpcode::MathUnaryF32:
+      case IrOpcode::MathUnaryF64:
         return 0;
+      case IrOpcode::MathBinaryF32:
+      case IrOpcode::MathBinaryF64:
+        return -1;
       case IrOpcode::JumpIfZero:
         return -1;
       case IrOpcode::Jump:
@@ -373,6 +392,7 @@ bool computeMaxStackDepth(const IrFunction &fn, const IrModule &module, int64_t
       case IrOpcode::FileOpenAppendDynamic:
         return 0;
       case IrOpcode::FileReadByte:
+      case IrOpcode::FileMapBytes:
         return 0;
       case IrOpcode::FileClose:
       case IrOpcode::FileFlush:
@@ -386,6 +406,9 @@ bool computeMaxStackDepth(const IrFunction &fn, const IrModule &module, int64_t
       case IrOpcode::FileWriteStringDynamic:
       case IrOpcode::FileWriteByte:
         return -1;
+      case IrOpcode::FileReadBytes:
+      case IrOpcode::FileWriteBytes:
+        return -2;
       case IrOpcode::Call:
       case IrOpcode::CallVoid: {
         int64_t consumed = 0;
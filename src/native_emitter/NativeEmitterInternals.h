@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "primec/Ir.h"
@@ -21,6 +23,9 @@ constexpr uint64_t PageSize =
 #endif
 constexpr uint64_t PageZeroSize = 0x100000000ull;
 constexpr uint64_t TextVmAddr = 0x100000000ull;
+// Machine-stack staging buffer for FileReadBytes/FileWriteBytes: one slot
+// byte per IR slot is packed into this many contiguous bytes per syscall.
+constexpr uint32_t FileBytesChunkBytes = 256;
 #if defined(__APPLE__)
 constexpr uint32_t PrintScratchBytes = 32;
 constexpr uint32_t PrintScratchSlots = (PrintScratchBytes + 15) / 16;
@@ -37,7 +42,14 @@ constexpr uint64_t SysMmap = SYS_mmap;
 constexpr uint64_t SysMmap = 197;
 #endif
 constexpr uint64_t SysMunmap = SYS_munmap;
+#if defined(SYS_fstat64)
+constexpr uint64_t SysFstat = SYS_fstat64;
+#else
+constexpr uint64_t SysFstat = SYS_fstat;
+#endif
 constexpr uint64_t MmapProtReadWrite = static_cast<uint64_t>(PROT_READ | PROT_WRITE);
+constexpr uint64_t MmapProtRead = static_cast<uint64_t>(PROT_READ);
+constexpr uint64_t MmapFlagsPrivate = static_cast<uint64_t>(MAP_PRIVATE);
 #if defined(MAP_ANON)
 constexpr uint64_t MmapFlagsPrivateAnon = static_cast<uint64_t>(MAP_PRIVATE | MAP_ANON);
 #else
@@ -51,10 +63,38 @@ constexpr uint64_t SysClose = 0;
 constexpr uint64_t SysFsync = 0;
 constexpr uint64_t SysMmap = 0;
 constexpr uint64_t SysMunmap = 0;
+constexpr uint64_t SysFstat = 0;
 constexpr uint64_t MmapProtReadWrite = 0;
 constexpr uint64_t MmapFlagsPrivateAnon = 0;
+constexpr uint64_t MmapProtRead = 0;
+constexpr uint64_t MmapFlagsPrivate = 0;
 #endif
+// Darwin `struct stat` (64-bit inode layout): total size, the byte holding
+// the S_IFMT nibble of st_mode, and st_size.
+constexpr uint32_t StatBytes = 144;
+constexpr uint16_t StatModeHighByteOffset = 5;
+constexpr uint16_t StatSizeOffset = 96;
 constexpr uint64_t HeapHeaderMagic = 0x5053484541503031ull;
+// Emitted heap runtime (see emitHeapRuntime): every block starts with a
+// 16-byte header (magic, block bytes including the header) followed by the
+// slots handed out to IR. Blocks of up to HeapMaxClassBytes come from
+// power-of-two size classes carved out of HeapArenaChunkBytes mmap chunks
+// and are recycled through per-class free lists; larger ones keep their own
+// page-rounded mmap (HeapHeaderMagic). Freed class blocks are zeroed and
+// re-tagged so a double free is ignored instead of corrupting a list.
+constexpr uint64_t HeapArenaMagic = 0x5053484541503032ull;
+constexpr uint64_t HeapArenaFreeMagic = 0x5053484541503046ull;
+constexpr uint64_t HeapMinBlockBytes = 32;
+constexpr uint32_t HeapSizeClassCount = 12;
+constexpr uint64_t HeapMaxClassBytes = HeapMinBlockBytes << (HeapSizeClassCount - 1);
+constexpr uint64_t HeapArenaChunkBytes = 1ull << 20;
+// Allocator state at the top of the entry frame, above the value stack:
+// one free-list head per size class, then the bump cursor and chunk end.
+constexpr uint32_t HeapStateBumpOffset = HeapSizeClassCount * 8;
+constexpr uint32_t HeapStateEndOffset = HeapStateBumpOffset + 8;
+constexpr uint32_t HeapStateBytes = 128;
+static_assert(HeapStateEndOffset + 8 <= HeapStateBytes);
+static_assert(HeapArenaChunkBytes >= HeapMaxClassBytes);
 
 inline uint64_t alignTo(uint64_t value, uint64_t alignment) {
   if (alignment == 0) {
@@ -64,6 +104,28 @@ inline uint64_t alignTo(uint64_t value, uint64_t alignment) {
   return (value + mask) & ~mask;
 }
 
+// Integer ops the register-allocated codegen mode emits directly on
+// physical registers (see emitRegisterOp). Everything else goes through
+// the stack-machine routines.
+enum class NativeRegisterOp : uint8_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  DivU,
+  Neg,
+  CmpEq,
+  CmpNe,
+  CmpLt,
+  CmpLe,
+  CmpGt,
+  CmpGe,
+  CmpLtU,
+  CmpLeU,
+  CmpGtU,
+  CmpGeU,
+};
+
 struct Arm64InstrumentationCounters {
   uint64_t valueStackPushCount = 0;
   uint64_t valueStackPopCount = 0;
@@ -103,6 +165,15 @@ class Arm64Emitter {
         emitMovImm64(9, frameSize_);
         emit(encodeAddReg(28, 27, 9));
       }
+      // The top HeapStateBytes of the entry frame hold the heap runtime's
+      // state; x22 keeps its base for the rest of the run.
+      emit(encodeSubRegImm(28, 28, static_cast<uint16_t>(HeapStateBytes)));
+      if (heapRuntimeEnabled_) {
+        emitMovReg(22, 28);
+        for (uint32_t offset = 0; offset < HeapStateBytes; offset += 8) {
+          emit(encodeStrRegBase(31, 22, static_cast<uint16_t>(offset)));
+        }
+      }
     }
     return true;
   }
@@ -197,6 +268,12 @@ class Arm64Emitter {
   void emitHeapAlloc();
   void emitHeapFree();
   void emitHeapRealloc();
+  // Mirrors X64Emitter: enable before emitting when the module allocates,
+  // then append the shared heap routines after the last function.
+  void setHeapRuntimeEnabled(bool enabled) {
+    heapRuntimeEnabled_ = enabled;
+  }
+  void emitHeapRuntime();
 
   void emitDup();
   void emitPop();
@@ -216,6 +293,8 @@ class Arm64Emitter {
   void emitMulF64();
   void emitDivF64();
   void emitNegF64();
+  void emitSqrtF32();
+  void emitSqrtF64();
   void emitCmpEq();
   void emitCmpNe();
   void emitCmpLt();
@@ -260,6 +339,25 @@ class Arm64Emitter {
   void patchJumpIfZero(size_t index, int32_t offsetWords);
   void emitPushReg0();
 
+  // Register-allocated codegen primitives. Values live in
+  // AllocatableRegisters between instructions; RegisterScratchA/B (x0/x1)
+  // carry operands, and emitRegisterOp leaves its result in scratch A.
+  static constexpr std::array<uint8_t, 7> AllocatableRegisters = {9, 10, 11, 12, 13, 14, 15};
+  static constexpr uint8_t RegisterScratchA = 0;
+  static constexpr uint8_t RegisterScratchB = 1;
+  void emitPushRegPublic(uint8_t reg);
+  void emitPopRegPublic(uint8_t reg);
+  void emitMovRegImm64Public(uint8_t rd, uint64_t value);
+  void emitAddressOfLocalToReg(uint8_t rd, uint32_t index);
+  void emitLoadIndirectReg(uint8_t rd, uint8_t addressReg);
+  void emitStoreIndirectReg(uint8_t addressReg, uint8_t valueReg);
+  void emitRegisterOp(NativeRegisterOp op);
+  void emitSpillRegToLocal(uint32_t index, uint8_t reg);
+  void emitReloadRegFromLocal(uint8_t reg, uint32_t index);
+  size_t emitJumpIfZeroRegPlaceholder(uint8_t reg);
+  size_t emitBranchIfNonZeroRegPlaceholder(uint8_t reg);
+  void patchBranchIfNonZeroHere(size_t index);
+
   size_t currentWordIndex() const {
     return code_.size();
   }
@@ -291,6 +389,9 @@ class Arm64Emitter {
   size_t emitFileWriteStringDynamicPlaceholder(uint64_t offsetTableDelta, uint64_t offsetTableSize);
   void emitFileWriteByte(uint32_t scratchOffset);
   void emitFileReadByte(uint32_t localIndex, uint32_t scratchOffset);
+  void emitFileReadBytes();
+  void emitFileWriteBytes();
+  void emitFileMapBytes(uint32_t localIndex);
   void emitFileWriteNewline(uint32_t scratchOffset);
   void emitFileClose();
   void emitFileFlush();
@@ -404,6 +505,11 @@ class Arm64Emitter {
   void emitSubReg(uint8_t rd, uint8_t rn, uint8_t rm);
   void emitMulReg(uint8_t rd, uint8_t rn, uint8_t rm);
   void emitUdivReg(uint8_t rd, uint8_t rn, uint8_t rm);
+  enum class HeapRoutine : uint8_t { Alloc, Free, Realloc };
+  void emitHeapRuntimeCall(HeapRoutine routine);
+  void emitHeapAllocRoutine();
+  void emitHeapFreeRoutine();
+  void emitHeapReallocRoutine(size_t allocIndex, size_t freeIndex);
   void emitHeapAllocFromSlotCountReg(uint8_t slotCountReg, uint8_t resultReg);
   void emitHeapFreeFromAddressReg(uint8_t addressReg);
 
@@ -433,12 +539,14 @@ class Arm64Emitter {
   static constexpr uint32_t kFmulD0D0D1 = 0x1e610800;
   static constexpr uint32_t kFdivD0D0D1 = 0x1e611800;
   static constexpr uint32_t kFnegD0 = 0x1e614000;
+  static constexpr uint32_t kFsqrtD0 = 0x1e61c000;
   static constexpr uint32_t kFcmpD0D1 = 0x1e612000;
   static constexpr uint32_t kFaddS0S0S1 = 0x1e212800;
   static constexpr uint32_t kFsubS0S0S1 = 0x1e213800;
   static constexpr uint32_t kFmulS0S0S1 = 0x1e210800;
   static constexpr uint32_t kFdivS0S0S1 = 0x1e211800;
   static constexpr uint32_t kFnegS0 = 0x1e214000;
+  static constexpr uint32_t kFsqrtS0 = 0x1e21c000;
   static constexpr uint32_t kFcmpS0S1 = 0x1e212000;
   static constexpr uint32_t kScvtfD0X0 = 0x9e620000;
   static constexpr uint32_t kScvtfS0X0 = 0x9e220000;
@@ -489,6 +597,8 @@ class Arm64Emitter {
   static constexpr uint8_t valueStackCacheReg_ = 26;
   bool hasValueStackCache_ = false;
   bool valueStackCacheEnabled_ = true;
+  bool heapRuntimeEnabled_ = false;
+  std::vector<std::pair<size_t, HeapRoutine>> heapRuntimeCalls_;
 };
 
 #include "NativeEmitterInternalsArm64Arithmetic.h"
@@ -76,6 +76,14 @@ inline void Arm64Emitter::emitNegF64() {
   emitFloatUnaryOp(true, kFnegD0, kFnegS0);
 }
 
+inline void Arm64Emitter::emitSqrtF32() {
+  emitFloatUnaryOp(false, kFsqrtD0, kFsqrtS0);
+}
+
+inline void Arm64Emitter::emitSqrtF64() {
+  emitFloatUnaryOp(true, kFsqrtD0, kFsqrtS0);
+}
+
 inline void Arm64Emitter::emitCmpEq() {
   emitCompareAndPush(CondCode::Eq);
 }
@@ -403,3 +411,121 @@ inline void Arm64Emitter::emitCompareAndPush(CondCode cond) {
   emitMovImm64(0, 1);
   emitPushReg(0);
 }
+
+inline void Arm64Emitter::emitPushRegPublic(uint8_t reg) {
+  emitPushReg(reg);
+}
+
+inline void Arm64Emitter::emitPopRegPublic(uint8_t reg) {
+  emitPopReg(reg);
+}
+
+inline void Arm64Emitter::emitMovRegImm64Public(uint8_t rd, uint64_t value) {
+  emitMovImm64(rd, value);
+}
+
+inline void Arm64Emitter::emitAddressOfLocalToReg(uint8_t rd, uint32_t index) {
+  uint64_t offset = localOffset(index);
+  if (offset <= 4095) {
+    emit(encodeAddRegImm(rd, 27, static_cast<uint16_t>(offset)));
+  } else {
+    emitMovImm64(rd, offset);
+    emit(encodeAddReg(rd, 27, rd));
+  }
+}
+
+inline void Arm64Emitter::emitLoadIndirectReg(uint8_t rd, uint8_t addressReg) {
+  emit(encodeLdrRegBase(rd, addressReg, 0));
+}
+
+inline void Arm64Emitter::emitStoreIndirectReg(uint8_t addressReg, uint8_t valueReg) {
+  emit(encodeStrRegBase(valueReg, addressReg, 0));
+}
+
+inline void Arm64Emitter::emitRegisterOp(NativeRegisterOp op) {
+  CondCode cond = CondCode::Eq;
+  switch (op) {
+    case NativeRegisterOp::Add:
+      emit(encodeAddReg(0, 0, 1));
+      return;
+    case NativeRegisterOp::Sub:
+      emit(encodeSubReg(0, 0, 1));
+      return;
+    case NativeRegisterOp::Mul:
+      emit(encodeMulReg(0, 0, 1));
+      return;
+    case NativeRegisterOp::Div:
+      emit(encodeSdivReg(0, 0, 1));
+      return;
+    case NativeRegisterOp::DivU:
+      emit(encodeUdivReg(0, 0, 1));
+      return;
+    case NativeRegisterOp::Neg:
+      emit(encodeSubReg(0, 31, 0));
+      return;
+    case NativeRegisterOp::CmpEq:
+      cond = CondCode::Eq;
+      break;
+    case NativeRegisterOp::CmpNe:
+      cond = CondCode::Ne;
+      break;
+    case NativeRegisterOp::CmpLt:
+      cond = CondCode::Lt;
+      break;
+    case NativeRegisterOp::CmpLe:
+      cond = CondCode::Le;
+      break;
+    case NativeRegisterOp::CmpGt:
+      cond = CondCode::Gt;
+      break;
+    case NativeRegisterOp::CmpGe:
+      cond = CondCode::Ge;
+      break;
+    case NativeRegisterOp::CmpLtU:
+      cond = CondCode::Lo;
+      break;
+    case NativeRegisterOp::CmpLeU:
+      cond = CondCode::Ls;
+      break;
+    case NativeRegisterOp::CmpGtU:
+      cond = CondCode::Hi;
+      break;
+    case NativeRegisterOp::CmpGeU:
+      cond = CondCode::Hs;
+      break;
+  }
+  // Same select sequence as emitCompareAndPush: emitMovImm64 is always
+  // four words, so the branch offsets below are fixed.
+  emit(encodeSubsReg(31, 0, 1));
+  emit(encodeBCond(6, static_cast<uint8_t>(cond)));
+  emitMovImm64(0, 0);
+  emit(encodeB(5));
+  emitMovImm64(0, 1);
+}
+
+inline void Arm64Emitter::emitSpillRegToLocal(uint32_t index, uint8_t reg) {
+  counters_.spillCount += 1;
+  emitStoreLocalFromReg(index, reg);
+}
+
+inline void Arm64Emitter::emitReloadRegFromLocal(uint8_t reg, uint32_t index) {
+  counters_.reloadCount += 1;
+  emitLoadLocalToReg(reg, index);
+}
+
+inline size_t Arm64Emitter::emitJumpIfZeroRegPlaceholder(uint8_t reg) {
+  emitCompareRegZero(reg);
+  return emitCondBranchPlaceholder(CondCode::Eq);
+}
+
+inline size_t Arm64Emitter::emitBranchIfNonZeroRegPlaceholder(uint8_t reg) {
+  size_t index = currentWordIndex();
+  emit(encodeCbz(reg, 0) | (1u << 24));
+  return index;
+}
+
+inline void Arm64Emitter::patchBranchIfNonZeroHere(size_t index) {
+  const uint8_t reg = static_cast<uint8_t>(code_[index] & 0x1Fu);
+  const int32_t offsetWords = static_cast<int32_t>(currentWordIndex() - index);
+  patchWord(index, encodeCbz(reg, offsetWords) | (1u << 24));
+}
@@ -1,121 +1,291 @@
 #pragma once
 
+// Heap runtime: same design and block layout as X64Emitter's (see
+// NativeEmitterInternalsX64Core.h). The routines take x0 (and x1 for
+// realloc), return x0, and only touch x0-x8, x16 and x30, so callers such as
+// emitFileMapBytes may keep values in x9-x15 across a call. The allocator
+// state base lives in x22, set once by the entry function's beginFunction.
+inline void Arm64Emitter::emitHeapRuntimeCall(HeapRoutine routine) {
+  // The routines leave x26-x28 alone, so the value-stack cache survives.
+  heapRuntimeCalls_.push_back({currentWordIndex(), routine});
+  emit(encodeBl(0));
+}
+
 inline void Arm64Emitter::emitHeapAlloc() {
-  emitPopReg(1);
-  emitHeapAllocFromSlotCountReg(1, 0);
+  emitPopReg(0);
+  emitHeapRuntimeCall(HeapRoutine::Alloc);
   emitPushReg(0);
 }
 
 inline void Arm64Emitter::emitHeapFree() {
   emitPopReg(0);
-  emitHeapFreeFromAddressReg(0);
+  emitHeapRuntimeCall(HeapRoutine::Free);
 }
 
 inline void Arm64Emitter::emitHeapRealloc() {
   emitPopReg(1);
   emitPopReg(0);
-  emitCompareRegZero(0);
-  const size_t jumpOldNonNull = emitCondBranchPlaceholder(CondCode::Ne);
-  emitHeapAllocFromSlotCountReg(1, 0);
+  emitHeapRuntimeCall(HeapRoutine::Realloc);
   emitPushReg(0);
-  const size_t jumpDone = emitJumpPlaceholder();
+}
+
+inline void Arm64Emitter::emitHeapRuntime() {
+  if (heapRuntimeCalls_.empty()) {
+    return;
+  }
+  hasValueStackCache_ = false;
+  const size_t allocIndex = currentWordIndex();
+  emitHeapAllocRoutine();
+  const size_t freeIndex = currentWordIndex();
+  emitHeapFreeRoutine();
+  const size_t reallocIndex = currentWordIndex();
+  emitHeapReallocRoutine(allocIndex, freeIndex);
+  for (const auto &[callIndex, routine] : heapRuntimeCalls_) {
+    size_t target = allocIndex;
+    if (routine == HeapRoutine::Free) {
+      target = freeIndex;
+    } else if (routine == HeapRoutine::Realloc) {
+      target = reallocIndex;
+    }
+    patchCall(callIndex, static_cast<int32_t>(target) - static_cast<int32_t>(callIndex));
+  }
+  heapRuntimeCalls_.clear();
+}
+
+// x0 = slot count -> x0 = address of slot 0, or 0.
+inline void Arm64Emitter::emitHeapAllocRoutine() {
+  const size_t zeroSlots = emitCbzPlaceholder(0);
+  emitAddRegImm(1, 0, 1);
+  emitMovImm64(2, IrSlotBytes);
+  emitMulReg(1, 1, 2); // x1 = block bytes
+  emitMovImm64(2, HeapMaxClassBytes);
+  emitCompareReg(1, 2);
+  const size_t largeBranch = emitCondBranchPlaceholder(CondCode::Hi);
+
+  // x3 = class block bytes, x4 = &freeList[class].
+  emitMovImm64(3, HeapMinBlockBytes);
+  emitMovReg(4, 22);
+  const size_t classLoop = currentWordIndex();
+  emitCompareReg(3, 1);
+  const size_t classFound = emitCondBranchPlaceholder(CondCode::Hs);
+  emitAddReg(3, 3, 3);
+  emitAddRegImm(4, 4, 8);
+  const size_t classNext = emitJumpPlaceholder();
+  patchJump(classNext, static_cast<int32_t>(classLoop) - static_cast<int32_t>(classNext));
+  patchCondBranch(classFound, static_cast<int32_t>(currentWordIndex() - classFound), CondCode::Hs);
+
+  emit(encodeLdrRegBase(0, 4, 0));
+  const size_t emptyList = emitCbzPlaceholder(0);
+  emit(encodeLdrRegBase(5, 0, static_cast<uint16_t>(IrSlotBytes))); // next link lives in slot 0
+  emit(encodeStrRegBase(5, 4, 0));
+  emit(encodeStrRegBase(31, 0, static_cast<uint16_t>(IrSlotBytes)));
+  emitMovImm64(5, HeapArenaMagic);
+  emit(encodeStrRegBase(5, 0, 0));
+  emitAddRegImm(0, 0, static_cast<uint16_t>(IrSlotBytes));
+  emit(encodeRet());
 
-  const size_t oldNonNullIndex = currentWordIndex();
-  patchCondBranch(jumpOldNonNull,
-                  static_cast<int32_t>(oldNonNullIndex - jumpOldNonNull),
-                  CondCode::Ne);
+  patchCbz(emptyList, 0, static_cast<int32_t>(currentWordIndex() - emptyList));
+  const size_t bump = currentWordIndex();
+  emit(encodeLdrRegBase(0, 22, HeapStateBumpOffset));
+  emitAddReg(5, 0, 3);
+  emit(encodeLdrRegBase(6, 22, HeapStateEndOffset));
+  emitCompareReg(5, 6);
+  const size_t refillBranch = emitCondBranchPlaceholder(CondCode::Hi);
+  emit(encodeStrRegBase(5, 22, HeapStateBumpOffset));
+  emitMovImm64(5, HeapArenaMagic);
+  emit(encodeStrRegBase(5, 0, 0));
+  emit(encodeStrRegBase(3, 0, 8));
+  emitAddRegImm(0, 0, static_cast<uint16_t>(IrSlotBytes));
+  emit(encodeRet());
 
-  emitCompareRegZero(1);
-  const size_t jumpNonZeroSlots = emitCondBranchPlaceholder(CondCode::Ne);
-  emitHeapFreeFromAddressReg(0);
+  patchCondBranch(refillBranch, static_cast<int32_t>(currentWordIndex() - refillBranch), CondCode::Hi);
+  emitAdjustSp(16, false);
+  emit(encodeStrRegBase(3, 31, 0));
   emitMovImm64(0, 0);
-  emitPushReg(0);
-  const size_t jumpDoneAfterFree = emitJumpPlaceholder();
-
-  const size_t nonZeroSlotsIndex = currentWordIndex();
-  patchCondBranch(jumpNonZeroSlots,
-                  static_cast<int32_t>(nonZeroSlotsIndex - jumpNonZeroSlots),
-                  CondCode::Ne);
-
-  emitMovReg(6, 1);
-  emitMovReg(7, 0);
-  emitMovReg(12, 6);
-  emitMovImm64(8, IrSlotBytes);
-  emitSubReg(9, 7, 8);
-  emit(encodeLdrRegBase(10, 9, 0));
-  emitMovImm64(11, HeapHeaderMagic);
-  emitCompareReg(10, 11);
-  const size_t jumpInvalidAddress = emitCondBranchPlaceholder(CondCode::Ne);
-  emit(encodeLdrRegBase(8, 9, 8));
-
-  emitHeapAllocFromSlotCountReg(6, 0);
-  emitCompareRegZero(0);
-  const size_t jumpAllocSucceeded = emitCondBranchPlaceholder(CondCode::Ne);
-  emitPushReg(0);
-  const size_t jumpDoneAfterAllocFailure = emitJumpPlaceholder();
-
-  const size_t allocSucceededIndex = currentWordIndex();
-  patchCondBranch(jumpAllocSucceeded,
-                  static_cast<int32_t>(allocSucceededIndex - jumpAllocSucceeded),
-                  CondCode::Ne);
-
-  emitMovReg(13, 0);
-  emitMovImm64(14, IrSlotBytes);
-  emitUdivReg(15, 8, 14);
-  emitMovImm64(6, 1);
-  emitSubReg(15, 15, 6);
-  emitCompareReg(15, 12);
-  const size_t jumpKeepOldSlots = emitCondBranchPlaceholder(CondCode::Ls);
-  emitMovReg(15, 12);
-  const size_t keepOldSlotsIndex = currentWordIndex();
-  patchCondBranch(jumpKeepOldSlots,
-                  static_cast<int32_t>(keepOldSlotsIndex - jumpKeepOldSlots),
-                  CondCode::Ls);
-
-  emitCompareRegZero(15);
-  const size_t jumpSkipCopy = emitCondBranchPlaceholder(CondCode::Eq);
-  emitMovReg(10, 7);
-  emitMovReg(11, 13);
-  emitMovImm64(14, IrSlotBytes);
-  emitMovImm64(6, 1);
-  const size_t copyLoopIndex = currentWordIndex();
-  emit(encodeLdrRegBase(2, 10, 0));
-  emit(encodeStrRegBase(2, 11, 0));
-  emit(encodeAddReg(10, 10, 14));
-  emit(encodeAddReg(11, 11, 14));
-  emitSubReg(15, 15, 6);
-  emitCompareRegZero(15);
-  const size_t jumpCopyLoop = emitCondBranchPlaceholder(CondCode::Ne);
-  patchCondBranch(jumpCopyLoop,
-                  static_cast<int32_t>(copyLoopIndex - jumpCopyLoop),
-                  CondCode::Ne);
-
-  const size_t skipCopyIndex = currentWordIndex();
-  patchCondBranch(jumpSkipCopy,
-                  static_cast<int32_t>(skipCopyIndex - jumpSkipCopy),
-                  CondCode::Eq);
-
-  emitMovReg(0, 9);
-  emitMovReg(1, 8);
+  emitMovImm64(1, HeapArenaChunkBytes);
+  emitMovImm64(2, MmapProtReadWrite);
+  emitMovImm64(3, MmapFlagsPrivateAnon);
+  emitMovImm64(4, ~0ull);
+  emitMovImm64(5, 0);
+  emitMovImm64(16, SysMmap);
+  emit(encodeSvc());
+  emit(encodeLdrRegBase(3, 31, 0));
+  emitAdjustSp(16, true); // flag-preserving, so carry still reports mmap
+  const size_t refillFailed = emitCondBranchPlaceholder(CondCode::Hs);
+  emit(encodeStrRegBase(0, 22, HeapStateBumpOffset));
+  emitMovImm64(5, HeapArenaChunkBytes);
+  emitAddReg(5, 0, 5);
+  emit(encodeStrRegBase(5, 22, HeapStateEndOffset));
+  const size_t retryBump = emitJumpPlaceholder();
+  patchJump(retryBump, static_cast<int32_t>(bump) - static_cast<int32_t>(retryBump));
+
+  patchCondBranch(largeBranch, static_cast<int32_t>(currentWordIndex() - largeBranch), CondCode::Hi);
+  emitMovImm64(2, PageSize - 1);
+  emitAddReg(1, 1, 2);
+  emitMovImm64(2, PageSize);
+  emitUdivReg(1, 1, 2);
+  emitMulReg(1, 1, 2); // x1 = mapping length, rounded up to whole pages
+  emitAdjustSp(16, false);
+  emit(encodeStrRegBase(1, 31, 0));
+  emitMovImm64(0, 0);
+  emitMovImm64(2, MmapProtReadWrite);
+  emitMovImm64(3, MmapFlagsPrivateAnon);
+  emitMovImm64(4, ~0ull);
+  emitMovImm64(5, 0);
+  emitMovImm64(16, SysMmap);
+  emit(encodeSvc());
+  emit(encodeLdrRegBase(1, 31, 0));
+  emitAdjustSp(16, true);
+  const size_t largeFailed = emitCondBranchPlaceholder(CondCode::Hs);
+  emitMovImm64(2, HeapHeaderMagic);
+  emit(encodeStrRegBase(2, 0, 0));
+  emit(encodeStrRegBase(1, 0, 8));
+  emitAddRegImm(0, 0, static_cast<uint16_t>(IrSlotBytes));
+  emit(encodeRet());
+
+  patchCbz(zeroSlots, 0, static_cast<int32_t>(currentWordIndex() - zeroSlots));
+  patchCondBranch(refillFailed, static_cast<int32_t>(currentWordIndex() - refillFailed), CondCode::Hs);
+  patchCondBranch(largeFailed, static_cast<int32_t>(currentWordIndex() - largeFailed), CondCode::Hs);
+  emitMovImm64(0, 0);
+  emit(encodeRet());
+}
+
+// x0 = address from the alloc routine (0 and unknown headers are ignored).
+inline void Arm64Emitter::emitHeapFreeRoutine() {
+  const size_t nullAddress = emitCbzPlaceholder(0);
+  emitSubRegImm(0, 0, static_cast<uint16_t>(IrSlotBytes)); // x0 = block base
+  emit(encodeLdrRegBase(1, 0, 0));
+  emitMovImm64(2, HeapArenaMagic);
+  emitCompareReg(1, 2);
+  const size_t classBlock = emitCondBranchPlaceholder(CondCode::Eq);
+  emitMovImm64(2, HeapHeaderMagic);
+  emitCompareReg(1, 2);
+  const size_t unknownBlock = emitCondBranchPlaceholder(CondCode::Ne);
+  emit(encodeLdrRegBase(1, 0, 8));
   emitMovImm64(16, SysMunmap);
   emit(encodeSvc());
-  emitMovReg(0, 13);
-  emitPushReg(0);
-  const size_t jumpDoneAfterCopy = emitJumpPlaceholder();
+  emit(encodeRet());
 
-  const size_t invalidAddressIndex = currentWordIndex();
-  patchCondBranch(jumpInvalidAddress,
-                  static_cast<int32_t>(invalidAddressIndex - jumpInvalidAddress),
-                  CondCode::Ne);
+  patchCondBranch(classBlock, static_cast<int32_t>(currentWordIndex() - classBlock), CondCode::Eq);
+  emit(encodeLdrRegBase(1, 0, 8)); // x1 = block bytes
+  emitAddRegImm(2, 0, static_cast<uint16_t>(IrSlotBytes));
+  emitAddReg(3, 0, 1);
+  const size_t zeroLoop = currentWordIndex();
+  emitCompareReg(2, 3);
+  const size_t zeroDone = emitCondBranchPlaceholder(CondCode::Hs);
+  emit(encodeStrRegBase(31, 2, 0));
+  emitAddRegImm(2, 2, 8);
+  const size_t zeroNext = emitJumpPlaceholder();
+  patchJump(zeroNext, static_cast<int32_t>(zeroLoop) - static_cast<int32_t>(zeroNext));
+  patchCondBranch(zeroDone, static_cast<int32_t>(currentWordIndex() - zeroDone), CondCode::Hs);
+
+  emitMovImm64(3, HeapMinBlockBytes);
+  emitMovReg(4, 22);
+  const size_t classLoop = currentWordIndex();
+  emitCompareReg(3, 1);
+  const size_t classFound = emitCondBranchPlaceholder(CondCode::Hs);
+  emitAddReg(3, 3, 3);
+  emitAddRegImm(4, 4, 8);
+  const size_t classNext = emitJumpPlaceholder();
+  patchJump(classNext, static_cast<int32_t>(classLoop) - static_cast<int32_t>(classNext));
+  patchCondBranch(classFound, static_cast<int32_t>(currentWordIndex() - classFound), CondCode::Hs);
+  emit(encodeLdrRegBase(5, 4, 0));
+  emit(encodeStrRegBase(5, 0, static_cast<uint16_t>(IrSlotBytes)));
+  emit(encodeStrRegBase(0, 4, 0));
+  emitMovImm64(5, HeapArenaFreeMagic);
+  emit(encodeStrRegBase(5, 0, 0));
+
+  patchCbz(nullAddress, 0, static_cast<int32_t>(currentWordIndex() - nullAddress));
+  patchCondBranch(unknownBlock, static_cast<int32_t>(currentWordIndex() - unknownBlock), CondCode::Ne);
+  emit(encodeRet());
+}
+
+// x0 = old address, x1 = new slot count -> x0 = new address (or 0).
+inline void Arm64Emitter::emitHeapReallocRoutine(size_t allocIndex, size_t freeIndex) {
+  const auto wordsTo = [&](size_t target) {
+    return static_cast<int32_t>(target) - static_cast<int32_t>(currentWordIndex());
+  };
+  const size_t oldNull = emitCbzPlaceholder(0);
+  const size_t zeroSlots = emitCbzPlaceholder(1);
+  emitSubRegImm(2, 0, static_cast<uint16_t>(IrSlotBytes)); // x2 = block base
+  emit(encodeLdrRegBase(3, 2, 0));
+  emitMovImm64(4, HeapArenaMagic);
+  emitCompareReg(3, 4);
+  const size_t knownClass = emitCondBranchPlaceholder(CondCode::Eq);
+  emitMovImm64(4, HeapHeaderMagic);
+  emitCompareReg(3, 4);
+  const size_t knownLarge = emitCondBranchPlaceholder(CondCode::Eq);
   emitMovImm64(0, 0);
-  emitPushReg(0);
+  emit(encodeRet());
+
+  patchCondBranch(knownClass, static_cast<int32_t>(currentWordIndex() - knownClass), CondCode::Eq);
+  patchCondBranch(knownLarge, static_cast<int32_t>(currentWordIndex() - knownLarge), CondCode::Eq);
+  emit(encodeLdrRegBase(3, 2, 8)); // x3 = block bytes
+  emitAddRegImm(4, 1, 1);
+  emitMovImm64(5, IrSlotBytes);
+  emitMulReg(4, 4, 5); // x4 = requested block bytes
+  emitCompareReg(4, 3);
+  const size_t moveBranch = emitCondBranchPlaceholder(CondCode::Hi);
+  emitAddReg(5, 2, 4);
+  emitAddReg(6, 2, 3);
+  const size_t zeroLoop = currentWordIndex();
+  emitCompareReg(5, 6);
+  const size_t zeroDone = emitCondBranchPlaceholder(CondCode::Hs);
+  emit(encodeStrRegBase(31, 5, 0));
+  emitAddRegImm(5, 5, 8);
+  const size_t zeroNext = emitJumpPlaceholder();
+  patchJump(zeroNext, static_cast<int32_t>(zeroLoop) - static_cast<int32_t>(zeroNext));
+  patchCondBranch(zeroDone, static_cast<int32_t>(currentWordIndex() - zeroDone), CondCode::Hs);
+  emit(encodeRet());
 
-  const size_t doneIndex = currentWordIndex();
-  patchJump(jumpDoneAfterAllocFailure,
-            static_cast<int32_t>(doneIndex - jumpDoneAfterAllocFailure));
-  patchJump(jumpDoneAfterCopy, static_cast<int32_t>(doneIndex - jumpDoneAfterCopy));
-  patchJump(jumpDoneAfterFree, static_cast<int32_t>(doneIndex - jumpDoneAfterFree));
-  patchJump(jumpDone, static_cast<int32_t>(doneIndex - jumpDone));
+  // Growing past the block: copy its whole payload (slots past the old
+  // count are zero), then release it. x30, the old address and the old
+  // block size are kept on the machine stack across the nested calls.
+  patchCondBranch(moveBranch, static_cast<int32_t>(currentWordIndex() - moveBranch), CondCode::Hi);
+  emitAdjustSp(32, false);
+  emit(encodeStrRegBase(30, 31, 0));
+  emit(encodeStrRegBase(0, 31, 8));
+  emit(encodeStrRegBase(3, 31, 16));
+  emitMovReg(0, 1);
+  emit(encodeBl(wordsTo(allocIndex)));
+  emit(encodeLdrRegBase(30, 31, 0));
+  emit(encodeLdrRegBase(1, 31, 8));
+  emit(encodeLdrRegBase(3, 31, 16));
+  const size_t allocFailed = emitCbzPlaceholder(0);
+  emitSubRegImm(3, 3, static_cast<uint16_t>(IrSlotBytes));
+  emitMovReg(4, 1);
+  emitMovReg(5, 0);
+  const size_t copyLoop = currentWordIndex();
+  const size_t copyDone = emitCbzPlaceholder(3);
+  emit(encodeLdrRegBase(6, 4, 0));
+  emit(encodeStrRegBase(6, 5, 0));
+  emitAddRegImm(4, 4, 8);
+  emitAddRegImm(5, 5, 8);
+  emitSubRegImm(3, 3, 8);
+  const size_t copyNext = emitJumpPlaceholder();
+  patchJump(copyNext, static_cast<int32_t>(copyLoop) - static_cast<int32_t>(copyNext));
+  patchCbz(copyDone, 3, static_cast<int32_t>(currentWordIndex() - copyDone));
+  emit(encodeStrRegBase(0, 31, 8));
+  emitMovReg(0, 1);
+  emit(encodeBl(wordsTo(freeIndex)));
+  emit(encodeLdrRegBase(30, 31, 0));
+  emit(encodeLdrRegBase(0, 31, 8));
+  patchCbz(allocFailed, 0, static_cast<int32_t>(currentWordIndex() - allocFailed));
+  emitAdjustSp(32, true);
+  emit(encodeRet());
+
+  patchCbz(oldNull, 0, static_cast<int32_t>(currentWordIndex() - oldNull));
+  emitMovReg(0, 1);
+  emit(encodeB(wordsTo(allocIndex)));
+
+  patchCbz(zeroSlots, 1, static_cast<int32_t>(currentWordIndex() - zeroSlots));
+  emitAdjustSp(16, false);
+  emit(encodeStrRegBase(30, 31, 0));
+  emit(encodeBl(wordsTo(freeIndex)));
+  emit(encodeLdrRegBase(30, 31, 0));
+  emitAdjustSp(16, true);
+  emitMovImm64(0, 0);
+  emit(encodeRet());
 }
 
 inline void Arm64Emitter::emitReturn() {
@@ -277,71 +447,20 @@ inline void Arm64Emitter::emitUdivReg(uint8_t rd, uint8_t rn, uint8_t rm) {
 
 inline void Arm64Emitter::emitHeapAllocFromSlotCountReg(uint8_t slotCountReg,
                                                         uint8_t resultReg) {
-  emitCompareRegZero(slotCountReg);
-  const size_t jumpNonZeroSlots = emitCondBranchPlaceholder(CondCode::Ne);
-  emitMovImm64(resultReg, 0);
-  const size_t jumpDone = emitJumpPlaceholder();
-
-  const size_t nonZeroSlotsIndex = currentWordIndex();
-  patchCondBranch(jumpNonZeroSlots,
-                  static_cast<int32_t>(nonZeroSlotsIndex - jumpNonZeroSlots),
-                  CondCode::Ne);
-
-  emitMovReg(1, slotCountReg);
-  emitMovImm64(6, 1);
-  emit(encodeAddReg(1, 1, 6));
-  emitMovImm64(2, IrSlotBytes);
-  emitMulReg(1, 1, 2);
-  emitMovReg(6, 1);
-  emitMovImm64(0, 0);
-  emitMovImm64(2, MmapProtReadWrite);
-  emitMovImm64(3, MmapFlagsPrivateAnon);
-  emitMovImm64(4, ~0ull);
-  emitMovImm64(5, 0);
-  emitMovImm64(16, SysMmap);
-  emit(encodeSvc());
-
-  emitCompareRegZero(0);
-  const size_t jumpNonNegative = emitCondBranchPlaceholder(CondCode::Ge);
-  emitMovImm64(resultReg, 0);
-  const size_t jumpDoneAfterFailure = emitJumpPlaceholder();
-
-  const size_t nonNegativeIndex = currentWordIndex();
-  patchCondBranch(jumpNonNegative,
-                  static_cast<int32_t>(nonNegativeIndex - jumpNonNegative),
-                  CondCode::Ge);
-
-  emitMovImm64(2, HeapHeaderMagic);
-  emit(encodeStrRegBase(2, 0, 0));
-  emit(encodeStrRegBase(6, 0, 8));
-  emitMovImm64(2, IrSlotBytes);
-  emit(encodeAddReg(resultReg, 0, 2));
-
-  const size_t doneIndex = currentWordIndex();
-  patchJump(jumpDoneAfterFailure,
-            static_cast<int32_t>(doneIndex - jumpDoneAfterFailure));
-  patchJump(jumpDone, static_cast<int32_t>(doneIndex - jumpDone));
+  if (slotCountReg != 0) {
+    emitMovReg(0, slotCountReg);
+  }
+  emitHeapRuntimeCall(HeapRoutine::Alloc);
+  if (resultReg != 0) {
+    emitMovReg(resultReg, 0);
+  }
 }
 
 inline void Arm64Emitter::emitHeapFreeFromAddressReg(uint8_t addressReg) {
-  emitCompareRegZero(addressReg);
-  const size_t jumpDone = emitCondBranchPlaceholder(CondCode::Eq);
-
-  emitMovReg(0, addressReg);
-  emitMovImm64(1, IrSlotBytes);
-  emitSubReg(0, 0, 1);
-  emit(encodeLdrRegBase(1, 0, 0));
-  emitMovImm64(2, HeapHeaderMagic);
-  emitCompareReg(1, 2);
-  const size_t jumpSkip = emitCondBranchPlaceholder(CondCode::Ne);
-  emit(encodeLdrRegBase(1, 0, 8));
-  emitMovImm64(16, SysMunmap);
-  emit(encodeSvc());
-
-  const size_t skipIndex = currentWordIndex();
-  patchCondBranch(jumpSkip, static_cast<int32_t>(skipIndex - jumpSkip), CondCode::Ne);
-  const size_t doneIndex = currentWordIndex();
-  patchCondBranch(jumpDone, static_cast<int32_t>(doneIndex - jumpDone), CondCode::Eq);
+  if (addressReg != 0) {
+    emitMovReg(0, addressReg);
+  }
+  emitHeapRuntimeCall(HeapRoutine::Free);
 }
 
 inline uint32_t Arm64Emitter::encodeAddSpImm(uint16_t imm) {
@@ -262,6 +262,188 @@ inline void Arm64Emitter::emitFileReadByte(uint32_t localIndex, uint32_t scratch
   emitPushReg(0);
 }
 
+// FileWriteBytes/FileReadBytes: [fd, address, count] -> status. Mirrors the
+// x86_64 routines: chunks are packed into (or expanded from) a
+// FileBytesChunkBytes buffer carved below sp. Darwin reports syscall
+// failure through the carry flag with a positive errno in x0.
+// Registers: x9 = remaining count, x10 = slot cursor, x11 = fd,
+// x12 = status, x13 = buffer cursor, x14 = chunk length, x15 = loop count.
+inline void Arm64Emitter::emitFileWriteBytes() {
+  emitPopReg(9);
+  emitPopReg(10);
+  emitPopReg(11);
+  emitMovImm64(12, 0);
+  emitAdjustSp(FileBytesChunkBytes, false);
+
+  const size_t chunkLoop = currentWordIndex();
+  const size_t doneBranch = emitCbzPlaceholder(9);
+  emitMovImm64(14, FileBytesChunkBytes);
+  emitCompareReg(9, 14);
+  const size_t fullBranch = emitCondBranchPlaceholder(CondCode::Hs);
+  emitMovReg(14, 9);
+  patchCondBranch(fullBranch, static_cast<int32_t>(currentWordIndex() - fullBranch), CondCode::Hs);
+  emitSubReg(9, 9, 14);
+
+  emitAddRegImm(13, 31, 0); // x13 = sp
+  emitMovReg(15, 14);
+  const size_t packLoop = currentWordIndex();
+  emit(encodeLdrbRegBase(0, 10, 0));
+  emitStrbRegBase(0, 13, 0);
+  emitAddRegImm(10, 10, static_cast<uint16_t>(IrSlotBytes));
+  emitAddRegImm(13, 13, 1);
+  emitSubRegImm(15, 15, 1);
+  emitCompareRegZero(15);
+  const size_t packBranch = emitCondBranchPlaceholder(CondCode::Ne);
+  patchCondBranch(packBranch, static_cast<int32_t>(packLoop) - static_cast<int32_t>(packBranch), CondCode::Ne);
+
+  emitAddRegImm(13, 31, 0);
+  const size_t writeLoop = currentWordIndex();
+  emitWriteSyscallReg(11, 13, 14);
+  const size_t errorBranch = emitCondBranchPlaceholder(CondCode::Hs);
+  emitCompareRegZero(0);
+  const size_t zeroBranch = emitCondBranchPlaceholder(CondCode::Eq);
+  emitAddReg(13, 13, 0);
+  emitSubReg(14, 14, 0);
+  emitCompareRegZero(14);
+  const size_t writeBranch = emitCondBranchPlaceholder(CondCode::Ne);
+  patchCondBranch(writeBranch, static_cast<int32_t>(writeLoop) - static_cast<int32_t>(writeBranch), CondCode::Ne);
+  const size_t nextChunk = emitJumpPlaceholder();
+  patchJump(nextChunk, static_cast<int32_t>(chunkLoop) - static_cast<int32_t>(nextChunk));
+
+  patchCondBranch(zeroBranch, static_cast<int32_t>(currentWordIndex() - zeroBranch), CondCode::Eq);
+  emitMovImm64(0, 5); // a zero-byte write reports EIO
+  patchCondBranch(errorBranch, static_cast<int32_t>(currentWordIndex() - errorBranch), CondCode::Hs);
+  emitMovReg(12, 0);
+
+  patchCbz(doneBranch, 9, static_cast<int32_t>(currentWordIndex() - doneBranch));
+  emitAdjustSp(FileBytesChunkBytes, true);
+  emitPushReg(12);
+}
+
+inline void Arm64Emitter::emitFileReadBytes() {
+  emitPopReg(9);
+  emitPopReg(10);
+  emitPopReg(11);
+  emitMovImm64(12, 0);
+  emitAdjustSp(FileBytesChunkBytes, false);
+
+  const size_t chunkLoop = currentWordIndex();
+  const size_t doneBranch = emitCbzPlaceholder(9);
+  emitMovImm64(14, FileBytesChunkBytes);
+  emitCompareReg(9, 14);
+  const size_t fullBranch = emitCondBranchPlaceholder(CondCode::Hs);
+  emitMovReg(14, 9);
+  patchCondBranch(fullBranch, static_cast<int32_t>(currentWordIndex() - fullBranch), CondCode::Hs);
+  emitAddRegImm(13, 31, 0);
+  emitReadSyscallReg(11, 13, 14);
+  const size_t errorBranch = emitCondBranchPlaceholder(CondCode::Hs);
+  emitCompareRegZero(0);
+  const size_t eofBranch = emitCondBranchPlaceholder(CondCode::Eq);
+
+  emitSubReg(9, 9, 0);
+  emitMovReg(15, 0);
+  emitAddRegImm(13, 31, 0);
+  const size_t expandLoop = currentWordIndex();
+  emit(encodeLdrbRegBase(0, 13, 0));
+  emit(encodeStrRegBase(0, 10, 0));
+  emitAddRegImm(13, 13, 1);
+  emitAddRegImm(10, 10, static_cast<uint16_t>(IrSlotBytes));
+  emitSubRegImm(15, 15, 1);
+  emitCompareRegZero(15);
+  const size_t expandBranch = emitCondBranchPlaceholder(CondCode::Ne);
+  patchCondBranch(expandBranch, static_cast<int32_t>(expandLoop) - static_cast<int32_t>(expandBranch), CondCode::Ne);
+  const size_t nextChunk = emitJumpPlaceholder();
+  patchJump(nextChunk, static_cast<int32_t>(chunkLoop) - static_cast<int32_t>(nextChunk));
+
+  patchCondBranch(eofBranch, static_cast<int32_t>(currentWordIndex() - eofBranch), CondCode::Eq);
+  emitMovImm64(0, FileReadEofCode);
+  patchCondBranch(errorBranch, static_cast<int32_t>(currentWordIndex() - errorBranch), CondCode::Hs);
+  emitMovReg(12, 0);
+
+  patchCbz(doneBranch, 9, static_cast<int32_t>(currentWordIndex() - doneBranch));
+  emitAdjustSp(FileBytesChunkBytes, true);
+  emitPushReg(12);
+}
+
+inline void Arm64Emitter::emitFileMapBytes(uint32_t localIndex) {
+  // Same shape as the x86_64 backend: map once, expand into a heap array,
+  // unmap. x9-x15 survive both the syscalls and the heap helpers.
+  emitPopReg(9);
+  emitAdjustSp(StatBytes, false);
+  emitMovReg(0, 9);
+  emitAddRegImm(1, 31, 0);
+  emitMovImm64(16, SysFstat);
+  emit(encodeSvc());
+  emitAddRegImm(13, 31, 0);
+  emit(encodeLdrbRegBase(14, 13, StatModeHighByteOffset));
+  emit(encodeLdrRegBase(10, 13, StatSizeOffset));
+  emitAdjustSp(StatBytes, true); // flag-preserving, so carry still reports fstat
+  const size_t statFailedBranch = emitCondBranchPlaceholder(CondCode::Hs);
+  emitSubRegImm(14, 14, 0x80); // S_IFREG sits in the high nibble of this byte
+  emitMovImm64(15, 0x10);
+  emitCompareReg(14, 15);
+  const size_t notRegularBranch = emitCondBranchPlaceholder(CondCode::Hs);
+
+  emitAddRegImm(15, 10, 1);
+  emitHeapAllocFromSlotCountReg(15, 11);
+  const size_t allocFailedBranch = emitCbzPlaceholder(11);
+  emit(encodeStrRegBase(10, 11, 0));
+  const size_t emptyBranch = emitCbzPlaceholder(10);
+
+  emitMovImm64(0, 0);
+  emitMovReg(1, 10);
+  emitMovImm64(2, MmapProtRead);
+  emitMovImm64(3, MmapFlagsPrivate);
+  emitMovReg(4, 9);
+  emitMovImm64(5, 0);
+  emitMovImm64(16, SysMmap);
+  emit(encodeSvc());
+  const size_t mapFailedBranch = emitCondBranchPlaceholder(CondCode::Hs);
+
+  emitMovReg(12, 0);
+  emitMovReg(13, 0);
+  emitAddRegImm(14, 11, static_cast<uint16_t>(IrSlotBytes));
+  emitMovReg(15, 10);
+  const size_t expandLoop = currentWordIndex();
+  emit(encodeLdrbRegBase(9, 13, 0));
+  emit(encodeStrRegBase(9, 14, 0));
+  emitAddRegImm(13, 13, 1);
+  emitAddRegImm(14, 14, static_cast<uint16_t>(IrSlotBytes));
+  emitSubRegImm(15, 15, 1);
+  emitCompareRegZero(15);
+  const size_t expandBranch = emitCondBranchPlaceholder(CondCode::Ne);
+  patchCondBranch(expandBranch, static_cast<int32_t>(expandLoop) - static_cast<int32_t>(expandBranch), CondCode::Ne);
+  emitMovReg(0, 12);
+  emitMovReg(1, 10);
+  emitMovImm64(16, SysMunmap);
+  emit(encodeSvc());
+
+  patchCbz(emptyBranch, 10, static_cast<int32_t>(currentWordIndex() - emptyBranch));
+  emitStoreLocalFromReg(localIndex, 11);
+  emitMovImm64(0, 0);
+  const size_t doneBranch = emitJumpPlaceholder();
+
+  patchCondBranch(mapFailedBranch, static_cast<int32_t>(currentWordIndex() - mapFailedBranch), CondCode::Hs);
+  emitMovReg(12, 0);
+  emitHeapFreeFromAddressReg(11);
+  emitMovReg(0, 12);
+  const size_t mapFailedDone = emitJumpPlaceholder();
+
+  patchCbz(allocFailedBranch, 11, static_cast<int32_t>(currentWordIndex() - allocFailedBranch));
+  emitMovImm64(0, 12); // ENOMEM
+  const size_t allocFailedDone = emitJumpPlaceholder();
+
+  patchCondBranch(notRegularBranch, static_cast<int32_t>(currentWordIndex() - notRegularBranch), CondCode::Hs);
+  emitMovImm64(0, 19); // ENODEV
+
+  patchCondBranch(statFailedBranch, static_cast<int32_t>(currentWordIndex() - statFailedBranch), CondCode::Hs);
+  const size_t doneIndex = currentWordIndex();
+  patchJump(allocFailedDone, static_cast<int32_t>(doneIndex - allocFailedDone));
+  patchJump(mapFailedDone, static_cast<int32_t>(doneIndex - mapFailedDone));
+  patchJump(doneBranch, static_cast<int32_t>(doneIndex - doneBranch));
+  emitPushReg(0);
+}
+
 inline void Arm64Emitter::emitFileWriteNewline(uint32_t scratchOffset) {
   emitPopReg(3);
   emitWriteNewlineReg(3, scratchOffset);
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "primec/Ir.h"
@@ -29,12 +31,20 @@ constexpr uint64_t LinuxSysWrite = SYS_write;
 constexpr uint64_t LinuxSysOpen = SYS_open;
 constexpr uint64_t LinuxSysClose = SYS_close;
 constexpr uint64_t LinuxSysFsync = SYS_fsync;
+constexpr uint64_t LinuxSysFstat = SYS_fstat;
 constexpr uint64_t LinuxSysMmap = SYS_mmap;
 constexpr uint64_t LinuxSysMunmap = SYS_munmap;
 constexpr uint64_t LinuxSysExit = SYS_exit;
 constexpr uint64_t LinuxSysExitGroup = SYS_exit_group;
 constexpr uint64_t LinuxMmapProtReadWrite = static_cast<uint64_t>(PROT_READ | PROT_WRITE);
 constexpr uint64_t LinuxMmapFlagsPrivateAnon = static_cast<uint64_t>(MAP_PRIVATE | MAP_ANONYMOUS);
+constexpr uint64_t LinuxMmapProtRead = static_cast<uint64_t>(PROT_READ);
+constexpr uint64_t LinuxMmapFlagsPrivate = static_cast<uint64_t>(MAP_PRIVATE);
+// x86_64 `struct stat`: total size, the byte holding the S_IFMT nibble of
+// st_mode, and st_size.
+constexpr int32_t LinuxStatBytes = 144;
+constexpr int32_t LinuxStatModeHighByteOffset = 25;
+constexpr int32_t LinuxStatSizeOffset = 48;
 #endif
 
 #if defined(__linux__)
@@ -92,6 +102,14 @@ class X64Emitter {
   void emitHeapAlloc();
   void emitHeapFree();
   void emitHeapRealloc();
+  // Set before any function is emitted when the module allocates; makes the
+  // entry prologue clear the allocator state.
+  void setHeapRuntimeEnabled(bool enabled) {
+    heapRuntimeEnabled_ = enabled;
+  }
+  // Appends the shared alloc/free/realloc routines after the last function
+  // and resolves every call emitted to them. Emits nothing when unused.
+  void emitHeapRuntime();
 
   void emitDup();
   void emitPop();
@@ -111,6 +129,8 @@ class X64Emitter {
   void emitMulF64();
   void emitDivF64();
   void emitNegF64();
+  void emitSqrtF32();
+  void emitSqrtF64();
   void emitCmpEq();
   void emitCmpNe();
   void emitCmpLt();
@@ -156,6 +176,25 @@ class X64Emitter {
   void patchJumpIfZero(size_t index, int32_t offsetWords);
   void emitPushReg0();
 
+  // Register-allocated codegen primitives, mirroring Arm64Emitter's. rbx,
+  // rsi, rdi and r8-r11 hold allocated values; rax/rcx are the operand
+  // scratch pair (rdx is clobbered by division).
+  static constexpr std::array<uint8_t, 7> AllocatableRegisters = {3, 6, 7, 8, 9, 10, 11};
+  static constexpr uint8_t RegisterScratchA = 0;
+  static constexpr uint8_t RegisterScratchB = 1;
+  void emitPushRegPublic(uint8_t reg);
+  void emitPopRegPublic(uint8_t reg);
+  void emitMovRegImm64Public(uint8_t rd, uint64_t value);
+  void emitAddressOfLocalToReg(uint8_t rd, uint32_t index);
+  void emitLoadIndirectReg(uint8_t rd, uint8_t addressReg);
+  void emitStoreIndirectReg(uint8_t addressReg, uint8_t valueReg);
+  void emitRegisterOp(NativeRegisterOp op);
+  void emitSpillRegToLocal(uint32_t index, uint8_t reg);
+  void emitReloadRegFromLocal(uint8_t reg, uint32_t index);
+  size_t emitJumpIfZeroRegPlaceholder(uint8_t reg);
+  size_t emitBranchIfNonZeroRegPlaceholder(uint8_t reg);
+  void patchBranchIfNonZeroHere(size_t index);
+
   size_t currentWordIndex() const {
     return code_.size();
   }
@@ -187,6 +226,9 @@ class X64Emitter {
   size_t emitFileWriteStringDynamicPlaceholder(uint64_t offsetTableDelta, uint64_t offsetTableSize);
   void emitFileWriteByte(uint32_t scratchOffset);
   void emitFileReadByte(uint32_t localIndex, uint32_t scratchOffset);
+  void emitFileReadBytes();
+  void emitFileWriteBytes();
+  void emitFileMapBytes(uint32_t localIndex);
   void emitFileWriteNewline(uint32_t scratchOffset);
   void emitFileClose();
   void emitFileFlush();
@@ -265,6 +307,7 @@ class X64Emitter {
   void emitDivReg(uint8_t reg);      // unsigned divide rdx:rax by reg
   void emitNegReg(uint8_t rd);
   void emitCmpRegReg(uint8_t a, uint8_t b); // flags = a - b
+  void emitTestReg(uint8_t reg);             // flags = reg & reg
   void emitSetccReg(uint8_t rd, CondCode cc);
   void emitMovzxReg8(uint8_t rd, uint8_t rs); // rd = zero-extend(low byte of rs)
   static uint8_t condCodeValue(CondCode cc);
@@ -278,6 +321,9 @@ class X64Emitter {
   void patchCondJumpHere(size_t fixupIndex);
   size_t emitJumpPlaceholderRaw();
   void patchJumpHere(size_t fixupIndex);
+  // Backward variant for loops internal to one routine: points either kind
+  // of rel32 placeholder at an earlier code offset.
+  void patchJumpTo(size_t fixupIndex, size_t targetIndex);
 
   // SSE2 float primitives (xmm registers 0-15, same numbering scheme as
   // GPRs). `isF64` selects the F2 (double) vs F3 (single) SSE prefix.
@@ -305,10 +351,19 @@ class X64Emitter {
   void emitCompareAndPush(CondCode cc);
   void emitFloatBinaryOp(bool isF64, uint8_t opcode);
   void emitFloatNegate(bool isF64);
+  void emitFloatSqrt(bool isF64);
   void emitFloatCompareAndPush(bool isF64, CondCode cc);
   void emitConvertIntToFloatImpl(bool isF64);
   void emitConvertFloatToIntImpl(bool isF64);
 
+  // Heap runtime calls. The routines take rdi (and rsi for realloc), return
+  // in rax, and clobber only rax, rcx, rdx, rsi, rdi and r8-r11.
+  enum class HeapRoutine : uint8_t { Alloc, Free, Realloc };
+  void emitHeapRuntimeCall(HeapRoutine routine);
+  void emitHeapStateBase(uint8_t rd);
+  void emitHeapAllocRoutine();
+  void emitHeapFreeRoutine();
+  void emitHeapReallocRoutine(size_t allocOffset, size_t freeOffset);
   void emitHeapAllocFromSlotCountReg(uint8_t slotCountReg, uint8_t resultReg);
   void emitHeapFreeFromAddressReg(uint8_t addressReg);
 
@@ -383,6 +438,8 @@ class X64Emitter {
   // calls properly), so `ret` there would jump to garbage - the entry
   // function's Return* opcodes must exit_group(value) instead.
   bool isEntryFunction_ = false;
+  bool heapRuntimeEnabled_ = false;
+  std::vector<std::pair<size_t, HeapRoutine>> heapRuntimeCalls_;
 };
 
 #include "NativeEmitterInternalsX64Core.h"
@@ -131,6 +131,11 @@ inline void X64Emitter::patchJumpHere(size_t fixupIndex) {
   patchU32(fixupIndex, static_cast<uint32_t>(delta));
 }
 
+inline void X64Emitter::patchJumpTo(size_t fixupIndex, size_t targetIndex) {
+  const int32_t delta = static_cast<int32_t>(targetIndex) - static_cast<int32_t>(fixupIndex + 4);
+  patchU32(fixupIndex, static_cast<uint32_t>(delta));
+}
+
 inline void X64Emitter::emitCompareAndPush(CondCode cc) {
   emitPopReg(1); // b
   emitPopReg(0); // a
@@ -250,6 +255,14 @@ inline void X64Emitter::emitFloatNegate(bool isF64) {
   emitPushReg(0);
 }
 
+inline void X64Emitter::emitFloatSqrt(bool isF64) {
+  emitPopReg(0);
+  emitMovqXmmFromReg(0, 0);
+  emitSseBinaryOp(isF64, 0x51, 0, 0); // sqrtss/sqrtsd xmm0, xmm0
+  emitMovqRegFromXmm(0, 0);
+  emitPushReg(0);
+}
+
 inline void X64Emitter::emitFloatCompareAndPush(bool isF64, CondCode cc) {
   emitPopReg(1); // b
   emitPopReg(0); // a
@@ -334,6 +347,12 @@ inline void X64Emitter::emitDivF64() {
 inline void X64Emitter::emitNegF64() {
   emitFloatNegate(true);
 }
+inline void X64Emitter::emitSqrtF32() {
+  emitFloatSqrt(false);
+}
+inline void X64Emitter::emitSqrtF64() {
+  emitFloatSqrt(true);
+}
 
 inline void X64Emitter::emitCmpEq() {
   emitCompareAndPush(CondCode::Eq);
@@ -551,3 +570,117 @@ inline void X64Emitter::emitConvertF32ToU64() {
 inline void X64Emitter::emitConvertF64ToU64() {
   emitConvertFloatToUnsigned(true);
 }
+
+inline void X64Emitter::emitPushRegPublic(uint8_t reg) {
+  emitPushReg(reg);
+}
+
+inline void X64Emitter::emitPopRegPublic(uint8_t reg) {
+  emitPopReg(reg);
+}
+
+inline void X64Emitter::emitMovRegImm64Public(uint8_t rd, uint64_t value) {
+  emitMovRegImm64(rd, value);
+}
+
+inline void X64Emitter::emitAddressOfLocalToReg(uint8_t rd, uint32_t index) {
+  emitMovRegReg(rd, 5); // mov rd, rbp
+  emitSubRegImm32(rd, static_cast<int32_t>(frameSize_ - localOffset(index)));
+}
+
+inline void X64Emitter::emitLoadIndirectReg(uint8_t rd, uint8_t addressReg) {
+  emitLoadMem(rd, addressReg, 0);
+}
+
+inline void X64Emitter::emitStoreIndirectReg(uint8_t addressReg, uint8_t valueReg) {
+  emitStoreMem(addressReg, 0, valueReg);
+}
+
+inline void X64Emitter::emitRegisterOp(NativeRegisterOp op) {
+  CondCode cc = CondCode::Eq;
+  switch (op) {
+    case NativeRegisterOp::Add:
+      emitAddRegReg(0, 1);
+      return;
+    case NativeRegisterOp::Sub:
+      emitSubRegReg(0, 1);
+      return;
+    case NativeRegisterOp::Mul:
+      emitImulRegReg(0, 1);
+      return;
+    case NativeRegisterOp::Div:
+      emitCqo();
+      emitIdivReg(1);
+      return;
+    case NativeRegisterOp::DivU:
+      emitMovRegImm64(2, 0); // rdx = 0
+      emitDivReg(1);
+      return;
+    case NativeRegisterOp::Neg:
+      emitNegReg(0);
+      return;
+    case NativeRegisterOp::CmpEq:
+      cc = CondCode::Eq;
+      break;
+    case NativeRegisterOp::CmpNe:
+      cc = CondCode::Ne;
+      break;
+    case NativeRegisterOp::CmpLt:
+      cc = CondCode::Lt;
+      break;
+    case NativeRegisterOp::CmpLe:
+      cc = CondCode::Le;
+      break;
+    case NativeRegisterOp::CmpGt:
+      cc = CondCode::Gt;
+      break;
+    case NativeRegisterOp::CmpGe:
+      cc = CondCode::Ge;
+      break;
+    case NativeRegisterOp::CmpLtU:
+      cc = CondCode::Below;
+      break;
+    case NativeRegisterOp::CmpLeU:
+      cc = CondCode::BelowEq;
+      break;
+    case NativeRegisterOp::CmpGtU:
+      cc = CondCode::Above;
+      break;
+    case NativeRegisterOp::CmpGeU:
+      cc = CondCode::AboveEq;
+      break;
+  }
+  emitCmpRegReg(0, 1); // flags = a - b
+  emitSetccReg(0, cc);
+  emitMovzxReg8(0, 0);
+}
+
+inline void X64Emitter::emitSpillRegToLocal(uint32_t index, uint8_t reg) {
+  counters_.spillCount += 1;
+  emitStoreLocalFromReg(index, reg);
+}
+
+inline void X64Emitter::emitReloadRegFromLocal(uint8_t reg, uint32_t index) {
+  counters_.reloadCount += 1;
+  emitLoadLocalToReg(reg, index);
+}
+
+inline void X64Emitter::emitTestReg(uint8_t reg) {
+  emitRex(true, reg, reg);
+  emitByte(0x85); // test r/m64, r64
+  emitModRmReg(reg, reg);
+}
+
+inline size_t X64Emitter::emitJumpIfZeroRegPlaceholder(uint8_t reg) {
+  emitTestReg(reg);
+  return emitCondJumpPlaceholder(CondCode::Eq);
+}
+
+inline size_t X64Emitter::emitBranchIfNonZeroRegPlaceholder(uint8_t reg) {
+  emitTestReg(reg);
+  return emitCondJumpPlaceholder(CondCode::Ne);
+}
+
+inline void X64Emitter::patchBranchIfNonZeroHere(size_t index) {
+  patchCondJumpHere(index);
+}
@@ -218,7 +218,16 @@ inline bool X64Emitter::beginFunction(uint64_t frameSize, bool resetValueStack,
     emitSubRegImm32(4, static_cast<int32_t>(frameSize_)); // sub rsp, frameSize
   }
   if (resetValueStack) {
-    emitMovRegReg(15, 5); // r15 = rbp (top of this frame's allocated region)
+    // The top HeapStateBytes of the entry frame hold the heap runtime's
+    // state (see emitHeapStateBase); the value stack starts below them.
+    emitMovRegReg(15, 5);
+    emitSubRegImm32(15, static_cast<int32_t>(HeapStateBytes));
+    if (heapRuntimeEnabled_) {
+      emitMovRegImm64(0, 0);
+      for (uint32_t offset = 8; offset <= HeapStateBytes; offset += 8) {
+        emitStoreMem(5, -static_cast<int32_t>(offset), 0);
+      }
+    }
   }
   return true;
 }
@@ -407,189 +416,333 @@ inline void X64Emitter::emitWriteNewlineReg(uint8_t fdReg, uint32_t scratchOffse
   emitWriteSyscallReg(fdReg, 1, 2);
 }
 
-// Heap allocation layout mirrors Arm64Emitter's exactly: a 16-byte header
-// (magic + mmap length in bytes) precedes the returned pointer, which
-// points IrSlotBytes into the mmap'd region.
+// Heap runtime. HeapAlloc/HeapFree/HeapRealloc sites only marshal their
+// operands into rdi/rsi and `call` one of three routines that
+// emitHeapRuntime() appends once after the last function, mirroring
+// Arm64Emitter's routines (see the HeapArenaMagic comment in
+// NativeEmitterInternals.h for the block layout). The allocator state lives
+// at the top of the entry frame; r13 (&argv[0]) is fixed for the whole run
+// and sits 16 bytes above the entry rbp, so every function can reach it.
 //
-// Register-lifetime note: the raw `syscall` instruction clobbers rax,
-// rcx, and r11, and every other free GPR this backend has doubles as a
-// syscall argument register (rdi/rsi/rdx/r10/r8/r9) - so nothing survives
-// a syscall in a register except rbx (register 3), which this backend
-// never uses for syscall arguments. Values that must survive a syscall
-// and don't fit in rbx are saved via emitPushReg/emitPopReg (the real,
-// memory-backed value stack) instead - see emitHeapRealloc below.
-inline void X64Emitter::emitHeapAllocFromSlotCountReg(uint8_t slotCountReg, uint8_t resultReg) {
-  emitCmpRegImm32(slotCountReg, 0);
-  const size_t jumpNonZeroSlots = emitCondJumpPlaceholder(CondCode::Ne);
-  emitMovRegImm64(resultReg, 0);
-  const size_t jumpDone = emitJumpPlaceholderRaw();
-
-  patchCondJumpHere(jumpNonZeroSlots);
-  emitMovRegReg(3, slotCountReg); // rbx = mmap length = (slotCount+1)*IrSlotBytes
-  emitAddRegImm32(3, 1);
-  emitMovRegImm64(2, IrSlotBytes);
-  emitImulRegReg(3, 2);
-
-  emitMovRegImm64(7, 0);                          // rdi = addr (NULL)
-  emitMovRegReg(6, 3);                            // rsi = length
-  emitMovRegImm64(2, LinuxMmapProtReadWrite);     // rdx = prot
-  emitMovRegImm64(10, LinuxMmapFlagsPrivateAnon); // r10 = flags
-  emitMovRegImm64(8, ~0ull);                      // r8 = fd (-1)
-  emitMovRegImm64(9, 0);                          // r9 = offset
-  emitMovRegImm64(0, LinuxSysMmap);
-  emitSyscall();
-
-  emitCmpRegImm32(0, 0);
-  const size_t jumpNonNegative = emitCondJumpPlaceholder(CondCode::Ge);
-  emitMovRegImm64(resultReg, 0);
-  const size_t jumpDoneAfterFailure = emitJumpPlaceholderRaw();
+// Register-lifetime note: the raw `syscall` instruction clobbers rax, rcx
+// and r11, and every argument register is rewritten for mmap itself, so
+// the routines keep values that must survive a syscall on the machine
+// stack (emitPushReg64/emitPopReg64) rather than in registers.
+inline void X64Emitter::emitHeapStateBase(uint8_t rd) {
+  emitMovRegReg(rd, 13);
+  emitSubRegImm32(rd, static_cast<int32_t>(16 + HeapStateBytes));
+}
 
-  patchCondJumpHere(jumpNonNegative);
-  emitMovRegImm64(2, HeapHeaderMagic);
-  emitStoreMem(0, 0, 2);
-  emitStoreMem(0, 8, 3); // rbx (mmap length) survived the syscall
-  emitMovRegImm64(2, IrSlotBytes);
-  emitMovRegReg(resultReg, 0);
-  emitAddRegReg(resultReg, 2);
+inline void X64Emitter::emitHeapRuntimeCall(HeapRoutine routine) {
+  heapRuntimeCalls_.push_back({emitCallPlaceholder(), routine});
+}
 
-  patchJumpHere(jumpDoneAfterFailure);
-  patchJumpHere(jumpDone);
+inline void X64Emitter::emitHeapAllocFromSlotCountReg(uint8_t slotCountReg, uint8_t resultReg) {
+  if (slotCountReg != 7) {
+    emitMovRegReg(7, slotCountReg);
+  }
+  emitHeapRuntimeCall(HeapRoutine::Alloc);
+  if (resultReg != 0) {
+    emitMovRegReg(resultReg, 0);
+  }
 }
 
 inline void X64Emitter::emitHeapFreeFromAddressReg(uint8_t addressReg) {
-  emitCmpRegImm32(addressReg, 0);
-  const size_t jumpDone = emitCondJumpPlaceholder(CondCode::Eq);
-
-  emitMovRegReg(0, addressReg);
-  emitSubRegImm32(0, IrSlotBytes);
-  emitLoadMem(1, 0, 0);
-  emitMovRegImm64(2, HeapHeaderMagic);
-  emitCmpRegReg(1, 2);
-  const size_t jumpSkip = emitCondJumpPlaceholder(CondCode::Ne);
-  emitLoadMem(6, 0, 8); // rsi = mmap length (read before rax is overwritten below)
-  emitMovRegReg(7, 0);  // rdi = mmap base
-  emitMovRegImm64(0, LinuxSysMunmap);
-  emitSyscall();
-
-  patchCondJumpHere(jumpSkip);
-  patchCondJumpHere(jumpDone);
+  if (addressReg != 7) {
+    emitMovRegReg(7, addressReg);
+  }
+  emitHeapRuntimeCall(HeapRoutine::Free);
 }
 
 inline void X64Emitter::emitHeapAlloc() {
-  emitPopReg(1);
-  emitHeapAllocFromSlotCountReg(1, 0);
+  emitPopReg(7);
+  emitHeapRuntimeCall(HeapRoutine::Alloc);
   emitPushReg(0);
 }
 
 inline void X64Emitter::emitHeapFree() {
-  emitPopReg(0);
-  emitHeapFreeFromAddressReg(0);
+  emitPopReg(7);
+  emitHeapRuntimeCall(HeapRoutine::Free);
 }
 
 inline void X64Emitter::emitHeapRealloc() {
-  emitPopReg(1); // reg1 = newSlotCount
-  emitPopReg(0); // reg0 = oldAddr
-  emitCmpRegImm32(0, 0);
-  const size_t jumpOldNonNull = emitCondJumpPlaceholder(CondCode::Ne);
-  emitHeapAllocFromSlotCountReg(1, 0);
+  emitPopReg(6); // rsi = newSlotCount
+  emitPopReg(7); // rdi = oldAddr
+  emitHeapRuntimeCall(HeapRoutine::Realloc);
   emitPushReg(0);
-  const size_t jumpDone = emitJumpPlaceholderRaw();
+}
 
-  patchCondJumpHere(jumpOldNonNull);
-  emitCmpRegImm32(1, 0);
-  const size_t jumpNonZeroSlots = emitCondJumpPlaceholder(CondCode::Ne);
-  emitHeapFreeFromAddressReg(0);
-  emitMovRegImm64(0, 0);
-  emitPushReg(0);
-  const size_t jumpDoneAfterFree = emitJumpPlaceholderRaw();
+inline void X64Emitter::emitHeapRuntime() {
+  if (heapRuntimeCalls_.empty()) {
+    return;
+  }
+  const size_t allocOffset = code_.size();
+  emitHeapAllocRoutine();
+  const size_t freeOffset = code_.size();
+  emitHeapFreeRoutine();
+  const size_t reallocOffset = code_.size();
+  emitHeapReallocRoutine(allocOffset, freeOffset);
+  for (const auto &[fixupIndex, routine] : heapRuntimeCalls_) {
+    switch (routine) {
+      case HeapRoutine::Alloc:
+        patchJumpTo(fixupIndex, allocOffset);
+        break;
+      case HeapRoutine::Free:
+        patchJumpTo(fixupIndex, freeOffset);
+        break;
+      case HeapRoutine::Realloc:
+        patchJumpTo(fixupIndex, reallocOffset);
+        break;
+    }
+  }
+  heapRuntimeCalls_.clear();
+}
+
+// rdi = slot count -> rax = address of slot 0, or 0 for a zero count or a
+// failed mmap. Class blocks come off the free list or the bump chunk;
+// anything above HeapMaxClassBytes gets its own page-rounded mapping.
+inline void X64Emitter::emitHeapAllocRoutine() {
+  emitCmpRegImm32(7, 0);
+  const size_t zeroSlots = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegReg(0, 7); // rax = block bytes = (slotCount+1)*IrSlotBytes
+  emitAddRegImm32(0, 1);
+  emitMovRegImm64(1, IrSlotBytes);
+  emitImulRegReg(0, 1);
+  emitCmpRegImm32(0, static_cast<int32_t>(HeapMaxClassBytes));
+  const size_t largeBranch = emitCondJumpPlaceholder(CondCode::Above);
+
+  // rcx = class block bytes, rdx = &freeList[class].
+  emitMovRegImm64(1, HeapMinBlockBytes);
+  emitHeapStateBase(6);
+  emitMovRegReg(2, 6);
+  const size_t classLoop = code_.size();
+  emitCmpRegReg(1, 0);
+  const size_t classFound = emitCondJumpPlaceholder(CondCode::AboveEq);
+  emitAddRegReg(1, 1);
+  emitAddRegImm32(2, 8);
+  patchJumpTo(emitJumpPlaceholderRaw(), classLoop);
+  patchCondJumpHere(classFound);
+
+  emitLoadMem(0, 2, 0);
+  emitCmpRegImm32(0, 0);
+  const size_t emptyList = emitCondJumpPlaceholder(CondCode::Eq);
+  emitLoadMem(8, 0, static_cast<int32_t>(IrSlotBytes)); // next link lives in slot 0
+  emitStoreMem(2, 0, 8);
+  emitMovRegImm64(8, 0);
+  emitStoreMem(0, static_cast<int32_t>(IrSlotBytes), 8);
+  emitMovRegImm64(8, HeapArenaMagic);
+  emitStoreMem(0, 0, 8);
+  emitAddRegImm32(0, static_cast<int32_t>(IrSlotBytes));
+  emitRet();
 
-  patchCondJumpHere(jumpNonZeroSlots);
-  // reg0 = oldAddr, reg1 = newSlotCount. Validate the header at oldAddr-16.
-  emitMovRegReg(2, 0);
-  emitSubRegImm32(2, IrSlotBytes); // reg2 = mmap base
-  emitLoadMem(3, 2, 0);            // reg3 = magic
-  emitMovRegImm64(6, HeapHeaderMagic);
-  emitCmpRegReg(3, 6);
-  const size_t jumpInvalidAddress = emitCondJumpPlaceholder(CondCode::Ne);
-  emitLoadMem(3, 2, 8); // reg3 = old mmap length
-
-  // reg1 (newSlotCount) survives emitHeapAllocFromSlotCountReg untouched
-  // (it only ever reads its slotCountReg parameter); oldAddr and
-  // oldMmapLength don't survive the mmap syscall inside that call, so
-  // save them on the real value stack first.
-  emitPushReg(0); // save oldAddr
-  emitPushReg(3); // save oldMmapLength
-  emitHeapAllocFromSlotCountReg(1, 0); // reg0 = newPtr or 0
+  patchCondJumpHere(emptyList);
+  const size_t bump = code_.size();
+  emitLoadMem(0, 6, static_cast<int32_t>(HeapStateBumpOffset));
+  emitMovRegReg(8, 0);
+  emitAddRegReg(8, 1);
+  emitLoadMem(9, 6, static_cast<int32_t>(HeapStateEndOffset));
+  emitCmpRegReg(8, 9);
+  const size_t refillBranch = emitCondJumpPlaceholder(CondCode::Above);
+  emitStoreMem(6, static_cast<int32_t>(HeapStateBumpOffset), 8);
+  emitMovRegImm64(8, HeapArenaMagic);
+  emitStoreMem(0, 0, 8);
+  emitStoreMem(0, 8, 1);
+  emitAddRegImm32(0, static_cast<int32_t>(IrSlotBytes));
+  emitRet();
+
+  // The chunk tail left behind is abandoned; chunks are never unmapped.
+  patchCondJumpHere(refillBranch);
+  emitPushReg64(1);
+  emitPushReg64(6);
+  emitMovRegImm64(7, 0);
+  emitMovRegImm64(6, HeapArenaChunkBytes);
+  emitMovRegImm64(2, LinuxMmapProtReadWrite);
+  emitMovRegImm64(10, LinuxMmapFlagsPrivateAnon);
+  emitMovRegImm64(8, ~0ull);
+  emitMovRegImm64(9, 0);
+  emitMovRegImm64(0, LinuxSysMmap);
+  emitSyscall();
+  emitPopReg64(6);
+  emitPopReg64(1);
   emitCmpRegImm32(0, 0);
-  const size_t jumpAllocSucceeded = emitCondJumpPlaceholder(CondCode::Ne);
-  // Alloc failed: discard the 2 saved temporaries, return null.
-  emitPopReg(3);
-  emitPopReg(3);
-  emitPushReg(0);
-  const size_t jumpDoneAfterAllocFailure = emitJumpPlaceholderRaw();
-
-  patchCondJumpHere(jumpAllocSucceeded);
-  emitMovRegReg(2, 0); // reg2 = newPtr
-  emitPopReg(3);       // reg3 = oldMmapLength (LIFO: pushed last, popped first)
-  emitPopReg(0);       // reg0 = oldAddr
-  // reg0=oldAddr, reg1=newSlotCount, reg2=newPtr, reg3=oldMmapLength - move
-  // oldAddr/newPtr somewhere that survives the division below (which uses
-  // rax/rdx) and, for oldAddr specifically, somewhere that survives being
-  // used as a mutable copy-loop cursor too.
-  emitMovRegReg(8, 0); // r8 = oldAddr (preserved)
-  emitMovRegReg(9, 2); // r9 = newPtr (preserved)
-
-  emitMovRegReg(0, 3);              // rax = oldMmapLength
-  emitMovRegImm64(10, IrSlotBytes); // r10 = divisor
-  emitMovRegImm64(2, 0);            // rdx = 0
-  emitDivReg(10);
-  emitSubRegImm32(0, 1); // rax = oldSlotCount
-  emitCmpRegReg(0, 1);   // oldSlotCount - newSlotCount
-  const size_t jumpKeepOldSlots = emitCondJumpPlaceholder(CondCode::BelowEq);
-  emitMovRegReg(0, 1); // oldSlotCount > newSlotCount: copy count = newSlotCount
-  patchCondJumpHere(jumpKeepOldSlots);
-  // rax = slots to copy = min(oldSlotCount, newSlotCount).
+  const size_t refillFailed = emitCondJumpPlaceholder(CondCode::Lt);
+  emitStoreMem(6, static_cast<int32_t>(HeapStateBumpOffset), 0);
+  emitAddRegImm32(0, static_cast<int32_t>(HeapArenaChunkBytes));
+  emitStoreMem(6, static_cast<int32_t>(HeapStateEndOffset), 0);
+  patchJumpTo(emitJumpPlaceholderRaw(), bump);
+
+  patchCondJumpHere(largeBranch);
+  emitAddRegImm32(0, static_cast<int32_t>(PageSize - 1));
+  emitMovRegImm64(2, 0);
+  emitMovRegImm64(1, PageSize);
+  emitDivReg(1);
+  emitImulRegReg(0, 1); // rax = mapping length, rounded up to whole pages
+  emitPushReg64(0);
+  emitMovRegImm64(7, 0);
+  emitMovRegReg(6, 0);
+  emitMovRegImm64(2, LinuxMmapProtReadWrite);
+  emitMovRegImm64(10, LinuxMmapFlagsPrivateAnon);
+  emitMovRegImm64(8, ~0ull);
+  emitMovRegImm64(9, 0);
+  emitMovRegImm64(0, LinuxSysMmap);
+  emitSyscall();
+  emitPopReg64(1);
   emitCmpRegImm32(0, 0);
-  const size_t jumpSkipCopy = emitCondJumpPlaceholder(CondCode::Eq);
-  emitMovRegImm64(10, IrSlotBytes);
-  emitImulRegReg(0, 10); // rax = bytes to copy
-  emitMovRegReg(6, 8);   // rsi = src cursor (copy of oldAddr)
-  emitMovRegReg(7, 9);   // rdi = dst cursor (copy of newPtr)
-  {
-    const size_t copyLoop = code_.size();
-    emitLoadMem(2, 6, 0);
-    emitStoreMem(7, 0, 2);
-    emitAddRegImm32(6, 8);
-    emitAddRegImm32(7, 8);
-    emitSubRegImm32(0, 8);
-    emitCmpRegImm32(0, 0);
-    const size_t jumpCopyLoop = emitCondJumpPlaceholder(CondCode::Ne);
-    patchU32(jumpCopyLoop,
-             static_cast<uint32_t>(static_cast<int32_t>(copyLoop) - static_cast<int32_t>(jumpCopyLoop + 4)));
-  }
+  const size_t largeFailed = emitCondJumpPlaceholder(CondCode::Lt);
+  emitMovRegImm64(8, HeapHeaderMagic);
+  emitStoreMem(0, 0, 8);
+  emitStoreMem(0, 8, 1);
+  emitAddRegImm32(0, static_cast<int32_t>(IrSlotBytes));
+  emitRet();
 
-  patchCondJumpHere(jumpSkipCopy);
-  // munmap(oldAddr - IrSlotBytes, oldMmapLength), using the preserved r8
-  // (untouched by the copy loop, which only mutated rsi/rdi's copies)
-  // and reg3 (oldMmapLength, untouched since the division read it into
-  // rax before clobbering anything).
-  emitMovRegReg(7, 8);
-  emitSubRegImm32(7, IrSlotBytes); // rdi = mmap base
-  emitMovRegReg(6, 3);             // rsi = oldMmapLength
+  patchCondJumpHere(zeroSlots);
+  patchCondJumpHere(refillFailed);
+  patchCondJumpHere(largeFailed);
+  emitMovRegImm64(0, 0);
+  emitRet();
+}
+
+// rdi = address from the alloc routine (0 and unknown headers are ignored).
+inline void X64Emitter::emitHeapFreeRoutine() {
+  emitCmpRegImm32(7, 0);
+  const size_t nullAddress = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegReg(0, 7);
+  emitSubRegImm32(0, static_cast<int32_t>(IrSlotBytes)); // rax = block base
+  emitLoadMem(1, 0, 0);
+  emitMovRegImm64(2, HeapArenaMagic);
+  emitCmpRegReg(1, 2);
+  const size_t classBlock = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegImm64(2, HeapHeaderMagic);
+  emitCmpRegReg(1, 2);
+  const size_t unknownBlock = emitCondJumpPlaceholder(CondCode::Ne);
+  emitLoadMem(6, 0, 8); // rsi = mapping length
+  emitMovRegReg(7, 0);
   emitMovRegImm64(0, LinuxSysMunmap);
   emitSyscall();
-  emitMovRegReg(0, 9); // rax = newPtr (r9 survives: munmap never touches it)
-  emitPushReg(0);
-  const size_t jumpDoneAfterCopy = emitJumpPlaceholderRaw();
+  emitRet();
 
-  patchCondJumpHere(jumpInvalidAddress);
+  // Zero the payload so the next owner sees fresh slots, then push the
+  // block onto its class list.
+  patchCondJumpHere(classBlock);
+  emitLoadMem(1, 0, 8); // rcx = block bytes
+  emitMovRegReg(2, 0);
+  emitAddRegImm32(2, static_cast<int32_t>(IrSlotBytes));
+  emitMovRegReg(8, 0);
+  emitAddRegReg(8, 1);
+  emitMovRegImm64(9, 0);
+  const size_t zeroLoop = code_.size();
+  emitCmpRegReg(2, 8);
+  const size_t zeroDone = emitCondJumpPlaceholder(CondCode::AboveEq);
+  emitStoreMem(2, 0, 9);
+  emitAddRegImm32(2, 8);
+  patchJumpTo(emitJumpPlaceholderRaw(), zeroLoop);
+  patchCondJumpHere(zeroDone);
+
+  emitMovRegImm64(10, HeapMinBlockBytes);
+  emitHeapStateBase(2);
+  const size_t classLoop = code_.size();
+  emitCmpRegReg(10, 1);
+  const size_t classFound = emitCondJumpPlaceholder(CondCode::AboveEq);
+  emitAddRegReg(10, 10);
+  emitAddRegImm32(2, 8);
+  patchJumpTo(emitJumpPlaceholderRaw(), classLoop);
+  patchCondJumpHere(classFound);
+  emitLoadMem(8, 2, 0);
+  emitStoreMem(0, static_cast<int32_t>(IrSlotBytes), 8);
+  emitStoreMem(2, 0, 0);
+  emitMovRegImm64(8, HeapArenaFreeMagic);
+  emitStoreMem(0, 0, 8);
+
+  patchCondJumpHere(nullAddress);
+  patchCondJumpHere(unknownBlock);
+  emitRet();
+}
+
+// rdi = old address, rsi = new slot count -> rax = new address (or 0).
+// Requests that still fit the block (its size class, or the page-rounded
+// mapping of a large block) are served in place with the tail re-zeroed;
+// otherwise the payload moves to a fresh block and the old one is freed.
+inline void X64Emitter::emitHeapReallocRoutine(size_t allocOffset, size_t freeOffset) {
+  emitCmpRegImm32(7, 0);
+  const size_t oldNonNull = emitCondJumpPlaceholder(CondCode::Ne);
+  emitMovRegReg(7, 6);
+  patchJumpTo(emitJumpPlaceholderRaw(), allocOffset);
+
+  patchCondJumpHere(oldNonNull);
+  emitCmpRegImm32(6, 0);
+  const size_t nonZeroSlots = emitCondJumpPlaceholder(CondCode::Ne);
+  patchJumpTo(emitCallPlaceholder(), freeOffset);
   emitMovRegImm64(0, 0);
-  emitPushReg(0);
+  emitRet();
 
-  patchJumpHere(jumpDoneAfterAllocFailure);
-  patchJumpHere(jumpDoneAfterCopy);
-  patchJumpHere(jumpDoneAfterFree);
-  patchJumpHere(jumpDone);
+  patchCondJumpHere(nonZeroSlots);
+  emitMovRegReg(0, 7);
+  emitSubRegImm32(0, static_cast<int32_t>(IrSlotBytes)); // rax = block base
+  emitLoadMem(1, 0, 0);
+  emitMovRegImm64(2, HeapArenaMagic);
+  emitCmpRegReg(1, 2);
+  const size_t knownClass = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegImm64(2, HeapHeaderMagic);
+  emitCmpRegReg(1, 2);
+  const size_t knownLarge = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegImm64(0, 0);
+  emitRet();
+
+  patchCondJumpHere(knownClass);
+  patchCondJumpHere(knownLarge);
+  emitLoadMem(1, 0, 8); // rcx = block bytes
+  emitMovRegReg(2, 6);  // rdx = requested block bytes
+  emitAddRegImm32(2, 1);
+  emitMovRegImm64(8, IrSlotBytes);
+  emitImulRegReg(2, 8);
+  emitCmpRegReg(2, 1);
+  const size_t moveBranch = emitCondJumpPlaceholder(CondCode::Above);
+  emitMovRegReg(8, 0);
+  emitAddRegReg(8, 2);
+  emitMovRegReg(9, 0);
+  emitAddRegReg(9, 1);
+  emitMovRegImm64(10, 0);
+  const size_t zeroLoop = code_.size();
+  emitCmpRegReg(8, 9);
+  const size_t zeroDone = emitCondJumpPlaceholder(CondCode::AboveEq);
+  emitStoreMem(8, 0, 10);
+  emitAddRegImm32(8, 8);
+  patchJumpTo(emitJumpPlaceholderRaw(), zeroLoop);
+  patchCondJumpHere(zeroDone);
+  emitMovRegReg(0, 7);
+  emitRet();
+
+  patchCondJumpHere(moveBranch);
+  emitPushReg64(7);
+  emitPushReg64(1);
+  emitMovRegReg(7, 6);
+  patchJumpTo(emitCallPlaceholder(), allocOffset);
+  emitPopReg64(1);
+  emitPopReg64(7);
+  emitCmpRegImm32(0, 0);
+  const size_t allocFailed = emitCondJumpPlaceholder(CondCode::Eq);
+  // Growing past the block: copy its whole payload (slots past the old
+  // count are zero), then release it.
+  emitMovRegReg(2, 1);
+  emitSubRegImm32(2, static_cast<int32_t>(IrSlotBytes));
+  emitMovRegReg(6, 7);
+  emitMovRegReg(8, 0);
+  const size_t copyLoop = code_.size();
+  emitCmpRegImm32(2, 0);
+  const size_t copyDone = emitCondJumpPlaceholder(CondCode::Eq);
+  emitLoadMem(9, 6, 0);
+  emitStoreMem(8, 0, 9);
+  emitAddRegImm32(6, 8);
+  emitAddRegImm32(8, 8);
+  emitSubRegImm32(2, 8);
+  patchJumpTo(emitJumpPlaceholderRaw(), copyLoop);
+  patchCondJumpHere(copyDone);
+  emitPushReg64(0);
+  patchJumpTo(emitCallPlaceholder(), freeOffset);
+  emitPopReg64(0);
+
+  patchCondJumpHere(allocFailed);
+  emitRet();
 }
 
 inline void X64Emitter::emitExitSyscall() {
@@ -342,6 +342,190 @@ inline void X64Emitter::emitFileReadByte(uint32_t localIndex, uint32_t scratchOf
   emitPushReg(0);
 }
 
+// FileWriteBytes/FileReadBytes: [fd, address, count] -> status. IR bytes
+// live one per 16-byte slot, so each chunk is packed into (or expanded
+// from) a FileBytesChunkBytes buffer carved below rsp for the duration of
+// the routine, keeping it clear of locals and the value stack.
+// Registers: r8 = remaining count, r9 = slot cursor, r10 = fd, rbx = status.
+inline void X64Emitter::emitFileWriteBytes() {
+  emitPopReg(8);  // count
+  emitPopReg(9);  // address of the first byte slot
+  emitPopReg(10); // fd
+  emitMovRegImm64(3, 0);
+  emitSubRegImm32(4, FileBytesChunkBytes);
+
+  const size_t chunkLoop = code_.size();
+  emitCmpRegImm32(8, 0);
+  const size_t doneBranch = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegReg(2, 8); // rdx = min(count, chunk)
+  emitCmpRegImm32(2, FileBytesChunkBytes);
+  const size_t smallBranch = emitCondJumpPlaceholder(CondCode::BelowEq);
+  emitMovRegImm64(2, FileBytesChunkBytes);
+  patchCondJumpHere(smallBranch);
+  emitSubRegReg(8, 2);
+
+  emitMovRegReg(7, 4);
+  emitMovRegReg(1, 2);
+  const size_t packLoop = code_.size();
+  emitLoadMemByte(0, 9, 0);
+  emitStoreMemByte(7, 0, 0);
+  emitAddRegImm32(9, static_cast<int32_t>(IrSlotBytes));
+  emitAddRegImm32(7, 1);
+  emitSubRegImm32(1, 1);
+  patchJumpTo(emitCondJumpPlaceholder(CondCode::Ne), packLoop);
+
+  emitMovRegReg(6, 4);
+  const size_t writeLoop = code_.size();
+  emitWriteSyscallReg(10, 6, 2); // rax = bytes written, or a negative errno
+  emitCmpRegImm32(0, 0);
+  const size_t errorBranch = emitCondJumpPlaceholder(CondCode::Le);
+  emitAddRegReg(6, 0);
+  emitSubRegReg(2, 0);
+  patchJumpTo(emitCondJumpPlaceholder(CondCode::Ne), writeLoop);
+  patchJumpTo(emitJumpPlaceholderRaw(), chunkLoop);
+
+  patchCondJumpHere(errorBranch);
+  emitMovRegImm64(3, 5); // a zero-byte write reports EIO
+  const size_t zeroBranch = emitCondJumpPlaceholder(CondCode::Eq);
+  emitNegReg(0);
+  emitMovRegReg(3, 0);
+  patchCondJumpHere(zeroBranch);
+
+  patchCondJumpHere(doneBranch);
+  emitAddRegImm32(4, FileBytesChunkBytes);
+  emitPushReg(3);
+}
+
+inline void X64Emitter::emitFileReadBytes() {
+  emitPopReg(8);  // count
+  emitPopReg(9);  // address of the first byte slot
+  emitPopReg(10); // fd
+  emitMovRegImm64(3, 0);
+  emitSubRegImm32(4, FileBytesChunkBytes);
+
+  const size_t chunkLoop = code_.size();
+  emitCmpRegImm32(8, 0);
+  const size_t doneBranch = emitCondJumpPlaceholder(CondCode::Eq);
+  emitMovRegReg(2, 8);
+  emitCmpRegImm32(2, FileBytesChunkBytes);
+  const size_t smallBranch = emitCondJumpPlaceholder(CondCode::BelowEq);
+  emitMovRegImm64(2, FileBytesChunkBytes);
+  patchCondJumpHere(smallBranch);
+  emitMovRegReg(6, 4);
+  emitReadSyscallReg(10, 6, 2); // rax = bytes read, 0 at EOF, or a negative errno
+  emitCmpRegImm32(0, 0);
+  const size_t stopBranch = emitCondJumpPlaceholder(CondCode::Le);
+
+  emitSubRegReg(8, 0);
+  emitMovRegReg(1, 0);
+  emitMovRegReg(6, 4);
+  const size_t expandLoop = code_.size();
+  emitLoadMemByte(0, 6, 0);
+  emitStoreMem(9, 0, 0);
+  emitAddRegImm32(6, 1);
+  emitAddRegImm32(9, static_cast<int32_t>(IrSlotBytes));
+  emitSubRegImm32(1, 1);
+  patchJumpTo(emitCondJumpPlaceholder(CondCode::Ne), expandLoop);
+  patchJumpTo(emitJumpPlaceholderRaw(), chunkLoop);
+
+  patchCondJumpHere(stopBranch);
+  emitMovRegImm64(3, FileReadEofCode);
+  const size_t eofBranch = emitCondJumpPlaceholder(CondCode::Eq);
+  emitNegReg(0);
+  emitMovRegReg(3, 0);
+  patchCondJumpHere(eofBranch);
+
+  patchCondJumpHere(doneBranch);
+  emitAddRegImm32(4, FileBytesChunkBytes);
+  emitPushReg(3);
+}
+
+inline void X64Emitter::emitFileMapBytes(uint32_t localIndex) {
+  // Native code has no tagged view addresses for LoadIndirect to special-case,
+  // so the file is mapped once and expanded into a fresh heap array (count
+  // slot, then one byte per slot); the mapping is released straight away.
+  emitPopReg(7); // rdi = fd
+  emitSubRegImm32(4, LinuxStatBytes);
+  emitMovRegReg(6, 4);
+  emitMovRegImm64(0, LinuxSysFstat);
+  emitSyscall();
+  emitLoadMemByte(1, 6, LinuxStatModeHighByteOffset);
+  emitLoadMem(9, 6, LinuxStatSizeOffset);
+  emitAddRegImm32(4, LinuxStatBytes);
+  emitCmpRegImm32(0, 0);
+  const size_t statFailedBranch = emitCondJumpPlaceholder(CondCode::Lt);
+  emitSubRegImm32(1, 0x80); // S_IFREG sits in the high nibble of this byte
+  emitCmpRegImm32(1, 0x10);
+  const size_t notRegularBranch = emitCondJumpPlaceholder(CondCode::AboveEq);
+
+  emitPushReg64(7);
+  emitPushReg64(9);
+  emitMovRegReg(1, 9);
+  emitAddRegImm32(1, 1);
+  emitHeapAllocFromSlotCountReg(1, 0);
+  emitMovRegReg(3, 0); // rbx = array base
+  emitPopReg64(6);     // rsi = size
+  emitPopReg64(8);     // r8 = fd
+  emitCmpRegImm32(3, 0);
+  const size_t allocFailedBranch = emitCondJumpPlaceholder(CondCode::Eq);
+  emitStoreMem(3, 0, 6);
+  emitCmpRegImm32(6, 0);
+  const size_t emptyBranch = emitCondJumpPlaceholder(CondCode::Eq);
+
+  emitMovRegImm64(7, 0);
+  emitMovRegImm64(2, LinuxMmapProtRead);
+  emitMovRegImm64(10, LinuxMmapFlagsPrivate);
+  emitMovRegImm64(9, 0);
+  emitMovRegImm64(0, LinuxSysMmap);
+  emitSyscall();
+  emitCmpRegImm32(0, 0);
+  const size_t mapFailedBranch = emitCondJumpPlaceholder(CondCode::Lt);
+
+  emitMovRegReg(2, 0);
+  emitMovRegReg(7, 3);
+  emitAddRegImm32(7, static_cast<int32_t>(IrSlotBytes));
+  emitMovRegReg(1, 6);
+  const size_t expandLoop = code_.size();
+  emitLoadMemByte(9, 2, 0);
+  emitStoreMem(7, 0, 9);
+  emitAddRegImm32(2, 1);
+  emitAddRegImm32(7, static_cast<int32_t>(IrSlotBytes));
+  emitSubRegImm32(1, 1);
+  patchJumpTo(emitCondJumpPlaceholder(CondCode::Ne), expandLoop);
+  emitMovRegReg(7, 0); // rsi still holds the mapping length
+  emitMovRegImm64(0, LinuxSysMunmap);
+  emitSyscall();
+
+  patchCondJumpHere(emptyBranch);
+  emitStoreLocalFromReg(localIndex, 3);
+  emitMovRegImm64(0, 0);
+  const size_t doneBranch = emitJumpPlaceholderRaw();
+
+  patchCondJumpHere(mapFailedBranch);
+  emitNegReg(0);
+  emitPushReg64(0); // the heap runtime clobbers every scratch register
+  emitHeapFreeFromAddressReg(3);
+  emitPopReg64(0);
+  const size_t mapFailedDone = emitJumpPlaceholderRaw();
+
+  patchCondJumpHere(allocFailedBranch);
+  emitMovRegImm64(0, 12); // ENOMEM
+  const size_t allocFailedDone = emitJumpPlaceholderRaw();
+
+  patchCondJumpHere(notRegularBranch);
+  emitMovRegImm64(0, 19); // ENODEV
+  const size_t notRegularDone = emitJumpPlaceholderRaw();
+
+  patchCondJumpHere(statFailedBranch);
+  emitNegReg(0);
+
+  patchJumpHere(notRegularDone);
+  patchJumpHere(allocFailedDone);
+  patchJumpHere(mapFailedDone);
+  patchJumpHere(doneBranch);
+  emitPushReg(0);
+}
+
 inline void X64Emitter::emitFileWriteNewline(uint32_t scratchOffset) {
   emitPopReg(3); // fd
   emitWriteNewlineReg(3, scratchOffset);
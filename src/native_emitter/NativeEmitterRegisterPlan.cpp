@@ -0,0 +1,75 @@
+#include "NativeEmitterEmitInternal.h"
+
+#include "primec/IrVirtualRegisterAllocator.h"
+#include "primec/IrVirtualRegisterLiveness.h"
+#include "primec/IrVirtualRegisterSpillInsertion.h"
+
+#include <utility>
+
+namespace primec::native_emitter {
+
+bool buildNativeEmitterRegisterPlan(const IrModule &module,
+                                    size_t functionIndex,
+                                    uint32_t physicalRegisterCount,
+                                    NativeEmitterRegisterPlan &out,
+                                    std::string &error) {
+  error.clear();
+  out = {};
+
+  // The vreg passes all work module-at-a-time; wrap the one function so a
+  // failure here only sends this function back to stack mode.
+  IrVirtualRegisterModule virtualModule;
+  virtualModule.entryIndex = 0;
+  virtualModule.functions.resize(1);
+  if (!lowerIrFunctionToBlockVirtualRegisters(module, functionIndex, virtualModule.functions.front(), error)) {
+    return false;
+  }
+  const IrVirtualRegisterFunction &function = virtualModule.functions.front();
+  for (const auto &block : function.blocks) {
+    if (block.instructions.size() != block.endInstructionIndex - block.startInstructionIndex) {
+      error = "native register plan found block instruction count mismatch";
+      return false;
+    }
+  }
+
+  IrVirtualRegisterModuleLiveness liveness;
+  if (!buildIrVirtualRegisterLiveness(virtualModule, liveness, error)) {
+    return false;
+  }
+  IrLinearScanAllocatorOptions allocatorOptions;
+  allocatorOptions.physicalRegisterCount = physicalRegisterCount;
+  IrLinearScanModuleAllocation allocation;
+  if (!allocateIrVirtualRegistersLinearScan(liveness, allocatorOptions, allocation, error)) {
+    return false;
+  }
+  IrVirtualRegisterSpillPlan spillPlan;
+  if (!insertIrVirtualRegisterSpills(virtualModule, allocation, spillPlan, error) ||
+      !verifyIrVirtualRegisterSpillPlan(virtualModule, allocation, spillPlan, error)) {
+    return false;
+  }
+
+  const IrLinearScanFunctionAllocation &functionAllocation = allocation.functions.front();
+  out.locations.resize(function.nextVirtualRegister);
+  for (const auto &assignment : functionAllocation.assignments) {
+    if (assignment.virtualRegister >= out.locations.size()) {
+      error = "native register plan found out-of-range virtual register";
+      return false;
+    }
+    NativeEmitterRegisterLocation &location = out.locations[assignment.virtualRegister];
+    if (assignment.spilled) {
+      location.kind = NativeEmitterRegisterLocation::Kind::SpillSlot;
+      location.index = assignment.spillSlot;
+    } else {
+      location.kind = NativeEmitterRegisterLocation::Kind::Register;
+      location.index = assignment.physicalRegister;
+    }
+    location.startPosition = assignment.startPosition;
+    location.endPosition = assignment.endPosition;
+  }
+  out.spillSlotCount = functionAllocation.spillSlotCount;
+  out.function = std::move(virtualModule.functions.front());
+  out.enabled = true;
+  return true;
+}
+
+} // namespace primec::native_emitter
@@ -391,7 +391,7 @@ int main(int argc, char **argv) {
                    "[--debug-json] [--debug-json-snapshots [none|stop|all]] [--debug-trace <path>] [--debug-dap] "
                    "[--debug-replay <trace>] [--debug-replay-sequence <n>] "
                    "[--collect-diagnostics] "
-                   "[--default-effects <list>] [--ir-inline] "
+                   "[--default-effects <list>] [--ir-inline] [-O0|-O1|-O2] [--ir-opt-report] [--vm-engine checked|fast] "
                    "[--dump-stage pre_ast|ast|ast-semantic|semantic-product|type-graph|ir] "
                    "[-- <program args...>]\n"
                    "Dump-stage note: lowering-facing dumps now include semantic-product between ast-semantic and ir.\n";
@@ -494,7 +494,7 @@ int main(int argc, char **argv) {
     pipelineOutput.semanticProgram = {};
   }
 
-  primec::Vm vm;
+  primec::Vm vm(options.vmEngine);
   std::vector<std::string_view> args;
   args.reserve(1 + options.programArgs.size());
   args.push_back(options.inputPath);
@@ -226,12 +226,13 @@ VmDebugSnapshotPayload VmDebugSession::snapshotPayload() const {
   out.frameLocals.reserve(frames_.size());
   for (const Frame &frame : frames_) {
     out.callStack.push_back({frame.functionIndex, frame.ip});
-    out.frameLocals.push_back(frame.locals);
+    out.frameLocals.emplace_back(localSlots_.begin() + static_cast<std::ptrdiff_t>(frame.localsBase),
+                                 localSlots_.begin() + static_cast<std::ptrdiff_t>(frame.localsBase + frame.localCount));
   }
   if (!frames_.empty()) {
     const Frame &frame = frames_.back();
     out.instructionPointer = frame.ip;
-    out.currentFrameLocals = frame.locals;
+    out.currentFrameLocals = out.frameLocals.back();
   }
   return out;
 }
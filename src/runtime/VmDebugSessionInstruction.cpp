@@ -5,6 +5,8 @@
 #include "VmIoHelpers.h"
 #include "VmDebugSessionInstructionNumeric.h"
 
+#include <span>
+
 namespace primec {
 
 VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error) {
@@ -20,7 +22,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
   }
   Frame &frame = frames_.back();
   const IrFunction &fn = *frame.function;
-  std::vector<uint64_t> &locals = frame.locals;
+  const std::span<uint64_t> locals(localSlots_.data() + frame.localsBase, frame.localCount);
   size_t &ip = frame.ip;
   if (ip >= fn.instructions.size()) {
     if (frames_.size() == 1) {
@@ -59,6 +61,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
     return outcome;
   };
   auto finishFault = [&]() {
+    files_.flushAll();
     appendMappedStackTrace(error);
     if (hooks_.fault) {
       VmDebugFaultHookEvent event;
@@ -99,9 +102,11 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
     Frame calleeFrame;
     calleeFrame.functionIndex = controlFlowOutcome.targetFunctionIndex;
     calleeFrame.function = &module_->functions[controlFlowOutcome.targetFunctionIndex];
-    calleeFrame.locals.assign(localCounts_[controlFlowOutcome.targetFunctionIndex], 0);
+    calleeFrame.localsBase = localSlots_.size();
+    calleeFrame.localCount = localCounts_[controlFlowOutcome.targetFunctionIndex];
     calleeFrame.returnValueToCaller = controlFlowOutcome.returnValueToCaller;
-    frames_.push_back(std::move(calleeFrame));
+    localSlots_.resize(calleeFrame.localsBase + calleeFrame.localCount, 0);
+    frames_.push_back(calleeFrame);
     emitCallHook(hooks_.callPush,
                  controlFlowOutcome.targetFunctionIndex,
                  controlFlowOutcome.returnValueToCaller);
@@ -111,6 +116,8 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
     const size_t poppedFunctionIndex = frame.functionIndex;
     result_ = controlFlowOutcome.returnValue;
     frames_.clear();
+    localSlots_.clear();
+    files_.flushAll();
     emitCallHook(hooks_.callPop,
                  poppedFunctionIndex,
                  controlFlowOutcome.returnValueToCaller);
@@ -118,6 +125,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
   }
   if (controlFlowOutcome.result == vm_detail::VmControlFlowOpcodeResult::Return) {
     const size_t poppedFunctionIndex = frame.functionIndex;
+    localSlots_.resize(frame.localsBase);
     frames_.pop_back();
     if (controlFlowOutcome.returnValueToCaller) {
       stack_.push_back(controlFlowOutcome.returnValue);
@@ -186,11 +194,11 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
       }
       const uint64_t address = stack_.back();
       stack_.pop_back();
-      uint64_t *slot = nullptr;
-      if (!vm_detail::resolveIndirectAddress(address, kSlotBytes, locals, heapSlots_, heapAllocations_, slot, error)) {
+      uint64_t value = 0;
+      if (!vm_detail::loadIndirectValue(address, locals, heap_, files_, value, error)) {
         return finishFault();
       }
-      stack_.push_back(*slot);
+      stack_.push_back(value);
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
@@ -204,7 +212,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
       const uint64_t address = stack_.back();
       stack_.pop_back();
       uint64_t *slot = nullptr;
-      if (!vm_detail::resolveIndirectAddress(address, kSlotBytes, locals, heapSlots_, heapAllocations_, slot, error)) {
+      if (!vm_detail::resolveIndirectAddress(address, kSlotBytes, locals, heap_, slot, error)) {
         return finishFault();
       }
       *slot = value;
@@ -220,7 +228,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
       const uint64_t slotCount = stack_.back();
       stack_.pop_back();
       uint64_t address = 0;
-      if (!vm_detail::allocateVmHeapSlots(slotCount, kSlotBytes, heapSlots_, heapAllocations_, address, error)) {
+      if (!vm_detail::allocateVmHeapSlots(slotCount, kSlotBytes, heap_, address, error)) {
         return finishFault();
       }
       stack_.push_back(address);
@@ -234,7 +242,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
       }
       const uint64_t address = stack_.back();
       stack_.pop_back();
-      if (!vm_detail::freeVmHeapSlots(address, kSlotBytes, heapSlots_, heapAllocations_, error)) {
+      if (!vm_detail::freeVmHeapSlots(address, kSlotBytes, heap_, error)) {
         return finishFault();
       }
       ip += 1;
@@ -253,8 +261,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
       if (!vm_detail::reallocVmHeapSlots(address,
                                          slotCount,
                                          kSlotBytes,
-                                         heapSlots_,
-                                         heapAllocations_,
+                                         heap_,
                                          newAddress,
                                          error)) {
         return finishFault();
@@ -333,7 +340,7 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
     case IrOpcode::FileOpenRead:
     case IrOpcode::FileOpenWrite:
     case IrOpcode::FileOpenAppend: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
@@ -342,77 +349,86 @@ VmDebugSession::StepOutcome VmDebugSession::stepInstruction(std::string &error)
     case IrOpcode::FileOpenReadDynamic:
     case IrOpcode::FileOpenWriteDynamic:
     case IrOpcode::FileOpenAppendDynamic: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileClose: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileReadByte: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileFlush: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteI32: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteI64: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteU64: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteString: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteStringDynamic: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteByte: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
       return finishStep(StepOutcome::Continue);
     }
     case IrOpcode::FileWriteNewline: {
-      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, error)) {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
+        return finishFault();
+      }
+      ip += 1;
+      return finishStep(StepOutcome::Continue);
+    }
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes:
+    case IrOpcode::FileMapBytes: {
+      if (!vm_detail::handleFileOpcode(*module_, inst, stack_, locals, heap_, files_, error)) {
         return finishFault();
       }
       ip += 1;
@@ -40,8 +40,9 @@ bool VmDebugSession::initFromModule(const IrModule &module,
   argvViews_ = args;
   localCounts_.assign(module.functions.size(), 0);
   stack_.clear();
-  heapSlots_.clear();
-  heapAllocations_.clear();
+  localSlots_.clear();
+  heap_.clear();
+  files_.clear();
   frames_.clear();
   result_ = 0;
   pauseRequested_ = false;
@@ -55,8 +56,9 @@ bool VmDebugSession::initFromModule(const IrModule &module,
   Frame entryFrame;
   entryFrame.functionIndex = static_cast<size_t>(module.entryIndex);
   entryFrame.function = &module.functions[entryFrame.functionIndex];
-  entryFrame.locals.assign(localCounts_[entryFrame.functionIndex], 0);
-  frames_.push_back(std::move(entryFrame));
+  entryFrame.localCount = localCounts_[entryFrame.functionIndex];
+  localSlots_.assign(entryFrame.localCount, 0);
+  frames_.push_back(entryFrame);
 
   const VmDebugTransitionResult startTransition =
       vmDebugApplyCommand(VmDebugSessionState::Idle, VmDebugSessionCommand::Start);
@@ -3,7 +3,9 @@
 #include "VmHeapHelpers.h"
 #include "VmIoHelpers.h"
 #include "primec/VmExecutionKernel.h"
+#include "primec/VmFastExecutionKernel.h"
 
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -24,25 +26,30 @@ public:
   size_t maxCallDepth() const override { return 4096; }
 
   bool resolveIndirectAddress(uint64_t address,
-                              std::vector<uint64_t> &locals,
+                              std::span<uint64_t> locals,
                               uint64_t *&slot,
                               std::string &error) override {
     return vm_detail::resolveIndirectAddress(address,
                                              slotBytes(),
                                              locals,
-                                             heapSlots_,
-                                             heapAllocations_,
+                                             heap_,
                                              slot,
                                              error);
   }
 
+  bool loadIndirectValue(uint64_t address,
+                         std::span<uint64_t> locals,
+                         uint64_t &value,
+                         std::string &error) override {
+    return vm_detail::loadIndirectValue(address, locals, heap_, files_, value, error);
+  }
+
   bool allocateHeapSlots(uint64_t slotCount,
                          uint64_t &address,
                          std::string &error) override {
     return allocateVmHeapSlots(slotCount,
                                slotBytes(),
-                               heapSlots_,
-                               heapAllocations_,
+                               heap_,
                                address,
                                error);
   }
@@ -50,8 +57,7 @@ public:
   bool freeHeapSlots(uint64_t address, std::string &error) override {
     return freeVmHeapSlots(address,
                            slotBytes(),
-                           heapSlots_,
-                           heapAllocations_,
+                           heap_,
                            error);
   }
 
@@ -62,8 +68,7 @@ public:
     return reallocVmHeapSlots(address,
                               slotCount,
                               slotBytes(),
-                              heapSlots_,
-                              heapAllocations_,
+                              heap_,
                               newAddress,
                               error);
   }
@@ -78,16 +83,17 @@ public:
   bool handleFileInstruction(const IrModule &module,
                              const IrInstruction &inst,
                              std::vector<uint64_t> &stack,
-                             std::vector<uint64_t> &locals,
+                             std::span<uint64_t> locals,
                              std::string &error) override {
-    return handleFileOpcode(module, inst, stack, locals, error);
+    return handleFileOpcode(module, inst, stack, locals, heap_, files_, error);
   }
 
 private:
   uint64_t argCount_ = 0;
   const std::vector<std::string_view> *args_ = nullptr;
-  std::vector<uint64_t> heapSlots_;
-  std::vector<VmDebugSession::HeapAllocation> heapAllocations_;
+  VmHeap heap_;
+  // Declared last so buffered writes drain before anything else is torn down.
+  VmFileBuffers files_;
 };
 
 } // namespace
@@ -96,8 +102,12 @@ bool executeVmModule(const IrModule &module,
                      uint64_t &result,
                      std::string &error,
                      uint64_t argCount,
-                     const std::vector<std::string_view> *args) {
+                     const std::vector<std::string_view> *args,
+                     VmEngineMode engine) {
   RuntimeVmKernelHost host(argCount, args);
+  if (engine == VmEngineMode::Fast) {
+    return executeVmFastKernel(module, host, result, error);
+  }
   return executeVmKernel(module, host, result, error);
 }
 
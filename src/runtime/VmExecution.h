@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "primec/Ir.h"
+#include "primec/Options.h"
 
 namespace primec::vm_detail {
 
@@ -12,6 +13,7 @@ bool executeVmModule(const IrModule &module,
                      uint64_t &result,
                      std::string &error,
                      uint64_t argCount,
-                     const std::vector<std::string_view> *args);
+                     const std::vector<std::string_view> *args,
+                     VmEngineMode engine = VmEngineMode::Checked);
 
 } // namespace primec::vm_detail
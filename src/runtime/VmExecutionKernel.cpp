@@ -5,16 +5,24 @@
 #include "primec/VmKernelBoundary.h"
 
 #include <algorithm>
+#include <span>
 #include <utility>
 
 namespace primec::vm_detail {
 
 namespace {
 
+constexpr size_t kVmKernelInitialLocalSlots = 1024;
+constexpr size_t kVmKernelInitialStackSlots = 256;
+
+// Frames own a window [localsBase, localsBase + localCount) of the shared
+// local-slot stack instead of a vector of their own, so calls and returns
+// only move the slot-stack top.
 struct VmKernelFrame {
   const IrFunction *function = nullptr;
   size_t functionIndex = 0;
-  std::vector<uint64_t> locals;
+  size_t localsBase = 0;
+  size_t localCount = 0;
   size_t ip = 0;
   bool returnValueToCaller = false;
 };
@@ -69,6 +77,9 @@ bool isVmKernelFileOpcode(IrOpcode op) {
   case IrOpcode::FileWriteStringDynamic:
   case IrOpcode::FileWriteByte:
   case IrOpcode::FileWriteNewline:
+  case IrOpcode::FileReadBytes:
+  case IrOpcode::FileWriteBytes:
+  case IrOpcode::FileMapBytes:
     return true;
   default:
     return false;
@@ -91,18 +102,22 @@ bool executeVmKernel(const IrModule &module,
   }
 
   std::vector<uint64_t> stack;
+  stack.reserve(kVmKernelInitialStackSlots);
+  std::vector<uint64_t> localSlots;
+  localSlots.reserve(kVmKernelInitialLocalSlots);
   std::vector<VmKernelFrame> frames;
   frames.reserve(64);
   VmKernelFrame entryFrame;
   entryFrame.functionIndex = static_cast<size_t>(module.entryIndex);
   entryFrame.function = &module.functions[entryFrame.functionIndex];
-  entryFrame.locals.assign(localCounts[entryFrame.functionIndex], 0);
-  frames.push_back(std::move(entryFrame));
+  entryFrame.localCount = localCounts[entryFrame.functionIndex];
+  localSlots.assign(entryFrame.localCount, 0);
+  frames.push_back(entryFrame);
 
   while (!frames.empty()) {
     VmKernelFrame &frame = frames.back();
     const IrFunction &fn = *frame.function;
-    std::vector<uint64_t> &locals = frame.locals;
+    const std::span<uint64_t> locals(localSlots.data() + frame.localsBase, frame.localCount);
     size_t &ip = frame.ip;
     if (ip >= fn.instructions.size()) {
       if (frames.size() == 1) {
@@ -134,9 +149,11 @@ bool executeVmKernel(const IrModule &module,
       VmKernelFrame calleeFrame;
       calleeFrame.functionIndex = controlFlowOutcome.targetFunctionIndex;
       calleeFrame.function = &module.functions[controlFlowOutcome.targetFunctionIndex];
-      calleeFrame.locals.assign(localCounts[controlFlowOutcome.targetFunctionIndex], 0);
+      calleeFrame.localsBase = localSlots.size();
+      calleeFrame.localCount = localCounts[controlFlowOutcome.targetFunctionIndex];
       calleeFrame.returnValueToCaller = controlFlowOutcome.returnValueToCaller;
-      frames.push_back(std::move(calleeFrame));
+      localSlots.resize(calleeFrame.localsBase + calleeFrame.localCount, 0);
+      frames.push_back(calleeFrame);
       continue;
     }
     if (controlFlowOutcome.result == VmControlFlowOpcodeResult::Exit) {
@@ -145,6 +162,7 @@ bool executeVmKernel(const IrModule &module,
     }
     if (controlFlowOutcome.result == VmControlFlowOpcodeResult::Return) {
       const bool returnToCaller = controlFlowOutcome.returnValueToCaller;
+      localSlots.resize(frame.localsBase);
       frames.pop_back();
       if (returnToCaller) {
         stack.push_back(controlFlowOutcome.returnValue);
@@ -209,11 +227,11 @@ bool executeVmKernel(const IrModule &module,
       }
       const uint64_t address = stack.back();
       stack.pop_back();
-      uint64_t *slot = nullptr;
-      if (!host.resolveIndirectAddress(address, locals, slot, error)) {
+      uint64_t value = 0;
+      if (!host.loadIndirectValue(address, locals, value, error)) {
         return false;
       }
-      stack.push_back(*slot);
+      stack.push_back(value);
       ip += 1;
       break;
     }
@@ -0,0 +1,1142 @@
+#include "primec/VmFastExecutionKernel.h"
+
+#include "VmNumericHelpers.h"
+#include "primec/VmKernelBoundary.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <span>
+#include <utility>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PRIMESTRUCT_VM_FAST_THREADED 1
+#else
+#define PRIMESTRUCT_VM_FAST_THREADED 0
+#endif
+
+namespace primec::vm_detail {
+
+namespace {
+
+// Decoded operation kinds. Push/argc/address-of-local opcodes collapse into
+// `PushConst`, and integer opcodes that share raw 64-bit semantics in the
+// checked kernel share one handler here.
+#define PRIMESTRUCT_VM_FAST_OPS(X)                                                                  \
+  X(Invalid)                                                                                        \
+  X(PushConst)                                                                                      \
+  X(LoadLocal)                                                                                      \
+  X(StoreLocal)                                                                                     \
+  X(LoadIndirect)                                                                                   \
+  X(StoreIndirect)                                                                                  \
+  X(HeapAlloc)                                                                                      \
+  X(HeapFree)                                                                                       \
+  X(HeapRealloc)                                                                                    \
+  X(Dup)                                                                                            \
+  X(Pop)                                                                                            \
+  X(LoadStringByte)                                                                                 \
+  X(LoadStringLength)                                                                               \
+  X(AddI)                                                                                           \
+  X(SubI)                                                                                           \
+  X(MulI)                                                                                           \
+  X(DivI)                                                                                           \
+  X(DivU64)                                                                                         \
+  X(NegI)                                                                                           \
+  X(AddF32)                                                                                         \
+  X(SubF32)                                                                                         \
+  X(MulF32)                                                                                         \
+  X(DivF32)                                                                                         \
+  X(NegF32)                                                                                         \
+  X(AddF64)                                                                                         \
+  X(SubF64)                                                                                         \
+  X(MulF64)                                                                                         \
+  X(DivF64)                                                                                         \
+  X(NegF64)                                                                                         \
+  X(CmpEq)                                                                                          \
+  X(CmpNe)                                                                                          \
+  X(CmpLtI)                                                                                         \
+  X(CmpLeI)                                                                                         \
+  X(CmpGtI)                                                                                         \
+  X(CmpGeI)                                                                                         \
+  X(CmpLtU)                                                                                         \
+  X(CmpLeU)                                                                                         \
+  X(CmpGtU)                                                                                         \
+  X(CmpGeU)                                                                                         \
+  X(CmpEqF32)                                                                                       \
+  X(CmpNeF32)                                                                                       \
+  X(CmpLtF32)                                                                                       \
+  X(CmpLeF32)                                                                                       \
+  X(CmpGtF32)                                                                                       \
+  X(CmpGeF32)                                                                                       \
+  X(CmpEqF64)                                                                                       \
+  X(CmpNeF64)                                                                                       \
+  X(CmpLtF64)                                                                                       \
+  X(CmpLeF64)                                                                                       \
+  X(CmpGtF64)                                                                                       \
+  X(CmpGeF64)                                                                                       \
+  X(ConvertI32ToF32)                                                                                \
+  X(ConvertI64ToF32)                                                                                \
+  X(ConvertU64ToF32)                                                                                \
+  X(ConvertI32ToF64)                                                                                \
+  X(ConvertI64ToF64)                                                                                \
+  X(ConvertU64ToF64)                                                                                \
+  X(ConvertF32ToI32)                                                                                \
+  X(ConvertF32ToI64)                                                                                \
+  X(ConvertF32ToU64)                                                                                \
+  X(ConvertF64ToI32)                                                                                \
+  X(ConvertF64ToI64)                                                                                \
+  X(ConvertF64ToU64)                                                                                \
+  X(ConvertF32ToF64)                                                                                \
+  X(ConvertF64ToF32)                                                                                \
+  X(MathUnaryF32)                                                                                   \
+  X(MathUnaryF64)                                                                                   \
+  X(MathBinaryF32)                                                                                  \
+  X(MathBinaryF64)                                                                                  \
+  X(Jump)                                                                                           \
+  X(JumpIfZero)                                                                                     \
+  X(Call)                                                                                           \
+  X(CallVoid)                                                                                       \
+  X(ReturnVoid)                                                                                     \
+  X(ReturnI32)                                                                                      \
+  X(ReturnI64)                                                                                      \
+  X(ReturnF32)                                                                                      \
+  X(HostPrint)                                                                                      \
+  X(HostFile)
+
+enum class FastOpKind : uint8_t {
+#define PRIMESTRUCT_VM_FAST_OP_ENUM(name) name,
+  PRIMESTRUCT_VM_FAST_OPS(PRIMESTRUCT_VM_FAST_OP_ENUM)
+#undef PRIMESTRUCT_VM_FAST_OP_ENUM
+};
+
+struct FastOp {
+#if PRIMESTRUCT_VM_FAST_THREADED
+  const void *handler = nullptr;
+#endif
+  FastOpKind kind = FastOpKind::Invalid;
+  uint64_t imm = 0;
+};
+
+struct FastFunction {
+  std::vector<FastOp> code;
+  size_t localCount = 0;
+  // Operand slots one activation may occupy above its entry depth, including
+  // the value a returning callee pushes back.
+  size_t frameSlots = 0;
+};
+
+// Locals live in one contiguous slot stack shared by all frames; a frame
+// only records its window into it.
+struct FastFrame {
+  size_t functionIndex = 0;
+  const FastOp *resumePc = nullptr;
+  bool returnValueToCaller = false;
+  size_t localsBase = 0;
+  size_t localCount = 0;
+};
+
+struct FastStackEffect {
+  int pops = 0;
+  int pushes = 0;
+  bool supported = false;
+};
+
+constexpr int64_t kUnsetHeight = std::numeric_limits<int64_t>::min();
+
+size_t computeFastLocalCount(const IrFunction &function) {
+  size_t localCount = 0;
+  for (const auto &inst : function.instructions) {
+    if (inst.op == IrOpcode::LoadLocal || inst.op == IrOpcode::StoreLocal ||
+        inst.op == IrOpcode::AddressOfLocal) {
+      localCount = std::max(localCount, static_cast<size_t>(inst.imm) + 1);
+    }
+  }
+  return localCount;
+}
+
+bool isUnaryNumericOpcode(IrOpcode op) {
+  switch (op) {
+  case IrOpcode::NegI32:
+  case IrOpcode::NegI64:
+  case IrOpcode::NegF32:
+  case IrOpcode::NegF64:
+  case IrOpcode::ConvertI32ToF32:
+  case IrOpcode::ConvertI64ToF32:
+  case IrOpcode::ConvertU64ToF32:
+  case IrOpcode::ConvertI32ToF64:
+  case IrOpcode::ConvertI64ToF64:
+  case IrOpcode::ConvertU64ToF64:
+  case IrOpcode::ConvertF32ToI32:
+  case IrOpcode::ConvertF32ToI64:
+  case IrOpcode::ConvertF32ToU64:
+  case IrOpcode::ConvertF64ToI32:
+  case IrOpcode::ConvertF64ToI64:
+  case IrOpcode::ConvertF64ToU64:
+  case IrOpcode::ConvertF32ToF64:
+  case IrOpcode::ConvertF64ToF32:
+  case IrOpcode::MathUnaryF32:
+  case IrOpcode::MathUnaryF64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Operand-stack effect of every straight-line opcode. Control flow, calls
+// and returns are modeled separately by the verifier.
+FastStackEffect fastStackEffect(IrOpcode op) {
+  if (vm_kernel::isPureNumericOpcode(op)) {
+    return isUnaryNumericOpcode(op) ? FastStackEffect{1, 1, true} : FastStackEffect{2, 1, true};
+  }
+  switch (op) {
+  case IrOpcode::PushI32:
+  case IrOpcode::PushI64:
+  case IrOpcode::PushF32:
+  case IrOpcode::PushF64:
+  case IrOpcode::PushArgc:
+  case IrOpcode::LoadLocal:
+  case IrOpcode::AddressOfLocal:
+  case IrOpcode::FileOpenRead:
+  case IrOpcode::FileOpenWrite:
+  case IrOpcode::FileOpenAppend:
+    return {0, 1, true};
+  case IrOpcode::PrintString:
+    return {0, 0, true};
+  case IrOpcode::StoreLocal:
+  case IrOpcode::Pop:
+  case IrOpcode::HeapFree:
+  case IrOpcode::PrintI32:
+  case IrOpcode::PrintI64:
+  case IrOpcode::PrintU64:
+  case IrOpcode::PrintStringDynamic:
+  case IrOpcode::PrintArgv:
+  case IrOpcode::PrintArgvUnsafe:
+    return {1, 0, true};
+  case IrOpcode::LoadIndirect:
+  case IrOpcode::HeapAlloc:
+  case IrOpcode::LoadStringByte:
+  case IrOpcode::LoadStringLength:
+  case IrOpcode::FileOpenReadDynamic:
+  case IrOpcode::FileOpenWriteDynamic:
+  case IrOpcode::FileOpenAppendDynamic:
+  case IrOpcode::FileClose:
+  case IrOpcode::FileReadByte:
+  case IrOpcode::FileMapBytes:
+  case IrOpcode::FileFlush:
+  case IrOpcode::FileWriteString:
+  case IrOpcode::FileWriteNewline:
+    return {1, 1, true};
+  case IrOpcode::Dup:
+    return {1, 2, true};
+  case IrOpcode::StoreIndirect:
+  case IrOpcode::HeapRealloc:
+  case IrOpcode::FileWriteI32:
+  case IrOpcode::FileWriteI64:
+  case IrOpcode::FileWriteU64:
+  case IrOpcode::FileWriteStringDynamic:
+  case IrOpcode::FileWriteByte:
+    return {2, 1, true};
+  case IrOpcode::FileReadBytes:
+  case IrOpcode::FileWriteBytes:
+    return {3, 1, true};
+  default:
+    return {};
+  }
+}
+
+enum class FastAnalysisResult { Verified, Rejected };
+
+struct FastFunctionAnalysis {
+  VmFastFunctionSignature signature;
+  bool reachesPendingCall = false;
+};
+
+// Abstract interpretation of one function's operand-stack heights, using the
+// current callee signatures for Call/CallVoid. Calls into callees whose
+// signature is not known yet stop that path and mark the analysis pending;
+// the module-level fixpoint re-runs it once more callees are known.
+FastAnalysisResult analyzeFastFunction(const IrModule &module,
+                                       size_t functionIndex,
+                                       const std::vector<VmFastFunctionSignature> &signatures,
+                                       FastFunctionAnalysis &out,
+                                       std::string &reason) {
+  const IrFunction &fn = module.functions[functionIndex];
+  const size_t instructionCount = fn.instructions.size();
+  const size_t localCount = computeFastLocalCount(fn);
+  out = {};
+  std::vector<int64_t> heights(instructionCount, kUnsetHeight);
+  std::vector<size_t> worklist;
+  bool sawReturn = false;
+
+  auto reject = [&](size_t ip, const std::string &why) {
+    reason = "function " + fn.name + " instruction " + std::to_string(ip) + ": " + why;
+    return FastAnalysisResult::Rejected;
+  };
+  auto merge = [&](size_t target, int64_t height) {
+    if (target >= instructionCount) {
+      return false;
+    }
+    if (heights[target] == kUnsetHeight) {
+      heights[target] = height;
+      worklist.push_back(target);
+      return true;
+    }
+    return heights[target] == height;
+  };
+
+  if (instructionCount == 0) {
+    return reject(0, "missing return");
+  }
+  heights[0] = 0;
+  worklist.push_back(0);
+  while (!worklist.empty()) {
+    const size_t ip = worklist.back();
+    worklist.pop_back();
+    const IrInstruction &inst = fn.instructions[ip];
+    const int64_t height = heights[ip];
+    switch (inst.op) {
+    case IrOpcode::Jump:
+      if (!merge(static_cast<size_t>(std::min<uint64_t>(inst.imm, instructionCount)), height)) {
+        return reject(ip, "jump target falls off the function or disagrees on stack height");
+      }
+      continue;
+    case IrOpcode::JumpIfZero: {
+      const int64_t after = height - 1;
+      out.signature.minHeight = std::min(out.signature.minHeight, after);
+      if (!merge(static_cast<size_t>(std::min<uint64_t>(inst.imm, instructionCount)), after) ||
+          !merge(ip + 1, after)) {
+        return reject(ip, "branch target falls off the function or disagrees on stack height");
+      }
+      continue;
+    }
+    case IrOpcode::Call:
+    case IrOpcode::CallVoid: {
+      if (inst.imm >= module.functions.size()) {
+        return reject(ip, "invalid call target");
+      }
+      const VmFastFunctionSignature &callee = signatures[static_cast<size_t>(inst.imm)];
+      if (!callee.returns) {
+        out.reachesPendingCall = true;
+        continue;
+      }
+      out.signature.minHeight = std::min(out.signature.minHeight, height + callee.minHeight);
+      const int64_t after = height + callee.netHeight + (inst.op == IrOpcode::Call ? 1 : 0);
+      out.signature.maxHeight = std::max(out.signature.maxHeight, after);
+      if (!merge(ip + 1, after)) {
+        return reject(ip, "call falls off the function or disagrees on stack height");
+      }
+      continue;
+    }
+    case IrOpcode::ReturnVoid:
+    case IrOpcode::ReturnI32:
+    case IrOpcode::ReturnI64:
+    case IrOpcode::ReturnF32:
+    case IrOpcode::ReturnF64: {
+      const int64_t net = inst.op == IrOpcode::ReturnVoid ? height : height - 1;
+      out.signature.minHeight = std::min(out.signature.minHeight, net);
+      if (sawReturn && out.signature.netHeight != net) {
+        return reject(ip, "returns disagree on stack height");
+      }
+      sawReturn = true;
+      out.signature.netHeight = net;
+      continue;
+    }
+    default:
+      break;
+    }
+
+    const FastStackEffect effect = fastStackEffect(inst.op);
+    if (!effect.supported) {
+      return reject(ip, "unsupported opcode");
+    }
+    if ((inst.op == IrOpcode::FileReadByte || inst.op == IrOpcode::FileMapBytes) && inst.imm >= localCount) {
+      return reject(ip, "invalid local index");
+    }
+    if ((inst.op == IrOpcode::LoadStringByte || inst.op == IrOpcode::FileOpenRead ||
+         inst.op == IrOpcode::FileOpenWrite || inst.op == IrOpcode::FileOpenAppend ||
+         inst.op == IrOpcode::FileWriteString) &&
+        inst.imm >= module.stringTable.size()) {
+      return reject(ip, "invalid string index");
+    }
+    if (inst.op == IrOpcode::PrintString && decodePrintStringIndex(inst.imm) >= module.stringTable.size()) {
+      return reject(ip, "invalid string index");
+    }
+    const int64_t popped = height - effect.pops;
+    const int64_t pushed = popped + effect.pushes;
+    out.signature.minHeight = std::min(out.signature.minHeight, popped);
+    out.signature.maxHeight = std::max(out.signature.maxHeight, pushed);
+    if (!merge(ip + 1, pushed)) {
+      return reject(ip, "falls off the function or disagrees on stack height");
+    }
+  }
+  out.signature.returns = sawReturn;
+  return FastAnalysisResult::Verified;
+}
+
+std::vector<size_t> collectFastReachableFunctions(const IrModule &module) {
+  std::vector<bool> seen(module.functions.size(), false);
+  std::vector<size_t> order;
+  std::deque<size_t> pending;
+  const size_t entryIndex = static_cast<size_t>(module.entryIndex);
+  seen[entryIndex] = true;
+  pending.push_back(entryIndex);
+  while (!pending.empty()) {
+    const size_t index = pending.front();
+    pending.pop_front();
+    order.push_back(index);
+    for (const auto &inst : module.functions[index].instructions) {
+      if ((inst.op != IrOpcode::Call && inst.op != IrOpcode::CallVoid) ||
+          inst.imm >= module.functions.size() || seen[static_cast<size_t>(inst.imm)]) {
+        continue;
+      }
+      seen[static_cast<size_t>(inst.imm)] = true;
+      pending.push_back(static_cast<size_t>(inst.imm));
+    }
+  }
+  return order;
+}
+
+FastOpKind decodeFastOpKind(IrOpcode op) {
+  switch (op) {
+  case IrOpcode::PushI32:
+  case IrOpcode::PushI64:
+  case IrOpcode::PushF32:
+  case IrOpcode::PushF64:
+  case IrOpcode::PushArgc:
+  case IrOpcode::AddressOfLocal:
+    return FastOpKind::PushConst;
+  case IrOpcode::LoadLocal:
+    return FastOpKind::LoadLocal;
+  case IrOpcode::StoreLocal:
+    return FastOpKind::StoreLocal;
+  case IrOpcode::LoadIndirect:
+    return FastOpKind::LoadIndirect;
+  case IrOpcode::StoreIndirect:
+    return FastOpKind::StoreIndirect;
+  case IrOpcode::HeapAlloc:
+    return FastOpKind::HeapAlloc;
+  case IrOpcode::HeapFree:
+    return FastOpKind::HeapFree;
+  case IrOpcode::HeapRealloc:
+    return FastOpKind::HeapRealloc;
+  case IrOpcode::Dup:
+    return FastOpKind::Dup;
+  case IrOpcode::Pop:
+    return FastOpKind::Pop;
+  case IrOpcode::LoadStringByte:
+    return FastOpKind::LoadStringByte;
+  case IrOpcode::LoadStringLength:
+    return FastOpKind::LoadStringLength;
+  case IrOpcode::AddI32:
+  case IrOpcode::AddI64:
+    return FastOpKind::AddI;
+  case IrOpcode::SubI32:
+  case IrOpcode::SubI64:
+    return FastOpKind::SubI;
+  case IrOpcode::MulI32:
+  case IrOpcode::MulI64:
+    return FastOpKind::MulI;
+  case IrOpcode::DivI32:
+  case IrOpcode::DivI64:
+    return FastOpKind::DivI;
+  case IrOpcode::DivU64:
+    return FastOpKind::DivU64;
+  case IrOpcode::NegI32:
+  case IrOpcode::NegI64:
+    return FastOpKind::NegI;
+  case IrOpcode::AddF32:
+    return FastOpKind::AddF32;
+  case IrOpcode::SubF32:
+    return FastOpKind::SubF32;
+  case IrOpcode::MulF32:
+    return FastOpKind::MulF32;
+  case IrOpcode::DivF32:
+    return FastOpKind::DivF32;
+  case IrOpcode::NegF32:
+    return FastOpKind::NegF32;
+  case IrOpcode::AddF64:
+    return FastOpKind::AddF64;
+  case IrOpcode::SubF64:
+    return FastOpKind::SubF64;
+  case IrOpcode::MulF64:
+    return FastOpKind::MulF64;
+  case IrOpcode::DivF64:
+    return FastOpKind::DivF64;
+  case IrOpcode::NegF64:
+    return FastOpKind::NegF64;
+  case IrOpcode::CmpEqI32:
+  case IrOpcode::CmpEqI64:
+    return FastOpKind::CmpEq;
+  case IrOpcode::CmpNeI32:
+  case IrOpcode::CmpNeI64:
+    return FastOpKind::CmpNe;
+  case IrOpcode::CmpLtI32:
+  case IrOpcode::CmpLtI64:
+    return FastOpKind::CmpLtI;
+  case IrOpcode::CmpLeI32:
+  case IrOpcode::CmpLeI64:
+    return FastOpKind::CmpLeI;
+  case IrOpcode::CmpGtI32:
+  case IrOpcode::CmpGtI64:
+    return FastOpKind::CmpGtI;
+  case IrOpcode::CmpGeI32:
+  case IrOpcode::CmpGeI64:
+    return FastOpKind::CmpGeI;
+  case IrOpcode::CmpLtU64:
+    return FastOpKind::CmpLtU;
+  case IrOpcode::CmpLeU64:
+    return FastOpKind::CmpLeU;
+  case IrOpcode::CmpGtU64:
+    return FastOpKind::CmpGtU;
+  case IrOpcode::CmpGeU64:
+    return FastOpKind::CmpGeU;
+  case IrOpcode::CmpEqF32:
+    return FastOpKind::CmpEqF32;
+  case IrOpcode::CmpNeF32:
+    return FastOpKind::CmpNeF32;
+  case IrOpcode::CmpLtF32:
+    return FastOpKind::CmpLtF32;
+  case IrOpcode::CmpLeF32:
+    return FastOpKind::CmpLeF32;
+  case IrOpcode::CmpGtF32:
+    return FastOpKind::CmpGtF32;
+  case IrOpcode::CmpGeF32:
+    return FastOpKind::CmpGeF32;
+  case IrOpcode::CmpEqF64:
+    return FastOpKind::CmpEqF64;
+  case IrOpcode::CmpNeF64:
+    return FastOpKind::CmpNeF64;
+  case IrOpcode::CmpLtF64:
+    return FastOpKind::CmpLtF64;
+  case IrOpcode::CmpLeF64:
+    return FastOpKind::CmpLeF64;
+  case IrOpcode::CmpGtF64:
+    return FastOpKind::CmpGtF64;
+  case IrOpcode::CmpGeF64:
+    return FastOpKind::CmpGeF64;
+  case IrOpcode::ConvertI32ToF32:
+    return FastOpKind::ConvertI32ToF32;
+  case IrOpcode::ConvertI64ToF32:
+    return FastOpKind::ConvertI64ToF32;
+  case IrOpcode::ConvertU64ToF32:
+    return FastOpKind::ConvertU64ToF32;
+  case IrOpcode::ConvertI32ToF64:
+    return FastOpKind::ConvertI32ToF64;
+  case IrOpcode::ConvertI64ToF64:
+    return FastOpKind::ConvertI64ToF64;
+  case IrOpcode::ConvertU64ToF64:
+    return FastOpKind::ConvertU64ToF64;
+  case IrOpcode::ConvertF32ToI32:
+    return FastOpKind::ConvertF32ToI32;
+  case IrOpcode::ConvertF32ToI64:
+    return FastOpKind::ConvertF32ToI64;
+  case IrOpcode::ConvertF32ToU64:
+    return FastOpKind::ConvertF32ToU64;
+  case IrOpcode::ConvertF64ToI32:
+    return FastOpKind::ConvertF64ToI32;
+  case IrOpcode::ConvertF64ToI64:
+    return FastOpKind::ConvertF64ToI64;
+  case IrOpcode::ConvertF64ToU64:
+    return FastOpKind::ConvertF64ToU64;
+  case IrOpcode::ConvertF32ToF64:
+    return FastOpKind::ConvertF32ToF64;
+  case IrOpcode::ConvertF64ToF32:
+    return FastOpKind::ConvertF64ToF32;
+  case IrOpcode::MathUnaryF32:
+    return FastOpKind::MathUnaryF32;
+  case IrOpcode::MathUnaryF64:
+    return FastOpKind::MathUnaryF64;
+  case IrOpcode::MathBinaryF32:
+    return FastOpKind::MathBinaryF32;
+  case IrOpcode::MathBinaryF64:
+    return FastOpKind::MathBinaryF64;
+  case IrOpcode::Jump:
+    return FastOpKind::Jump;
+  case IrOpcode::JumpIfZero:
+    return FastOpKind::JumpIfZero;
+  case IrOpcode::Call:
+    return FastOpKind::Call;
+  case IrOpcode::CallVoid:
+    return FastOpKind::CallVoid;
+  case IrOpcode::ReturnVoid:
+    return FastOpKind::ReturnVoid;
+  case IrOpcode::ReturnI32:
+    return FastOpKind::ReturnI32;
+  case IrOpcode::ReturnI64:
+  case IrOpcode::ReturnF64:
+    return FastOpKind::ReturnI64;
+  case IrOpcode::ReturnF32:
+    return FastOpKind::ReturnF32;
+  default:
+    if (isVmKernelPrintOpcode(op)) {
+      return FastOpKind::HostPrint;
+    }
+    if (isVmKernelFileOpcode(op)) {
+      return FastOpKind::HostFile;
+    }
+    return FastOpKind::Invalid;
+  }
+}
+
+// Pre-decodes every reachable function into a compact operation array.
+// Immediates that only depend on the host (argc, slot size) are folded in
+// here so the hot loop never consults the host for them.
+std::vector<FastFunction> decodeFastModule(const IrModule &module,
+                                           const std::vector<VmFastFunctionSignature> &signatures,
+                                           const std::vector<size_t> &reachable,
+                                           VmKernelHost &host) {
+  std::vector<FastFunction> functions(module.functions.size());
+  const uint64_t argcValue =
+      static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(host.argumentCount())));
+  for (const size_t functionIndex : reachable) {
+    const IrFunction &fn = module.functions[functionIndex];
+    FastFunction &decoded = functions[functionIndex];
+    decoded.localCount = computeFastLocalCount(fn);
+    decoded.frameSlots = static_cast<size_t>(signatures[functionIndex].maxHeight) + 1;
+    decoded.code.resize(fn.instructions.size());
+    for (size_t ip = 0; ip < fn.instructions.size(); ++ip) {
+      const IrInstruction &inst = fn.instructions[ip];
+      FastOp &op = decoded.code[ip];
+      op.kind = decodeFastOpKind(inst.op);
+      op.imm = inst.imm;
+      switch (inst.op) {
+      case IrOpcode::PushI32:
+        op.imm = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(inst.imm)));
+        break;
+      case IrOpcode::PushArgc:
+        op.imm = argcValue;
+        break;
+      case IrOpcode::AddressOfLocal:
+        op.imm = inst.imm * host.slotBytes();
+        break;
+      case IrOpcode::Jump:
+      case IrOpcode::JumpIfZero:
+        op.imm = std::min<uint64_t>(inst.imm, fn.instructions.size());
+        break;
+      case IrOpcode::MathUnaryF32:
+      case IrOpcode::MathUnaryF64:
+      case IrOpcode::MathBinaryF32:
+      case IrOpcode::MathBinaryF64:
+        if (!isValidIrMathFunctionImm(inst.op, inst.imm)) {
+          op.kind = FastOpKind::Invalid;
+        }
+        break;
+      default:
+        if (op.kind == FastOpKind::HostPrint || op.kind == FastOpKind::HostFile) {
+          // Host opcodes keep their source instruction index so the handler
+          // can forward the original IR instruction unchanged.
+          op.imm = ip;
+        }
+        break;
+      }
+    }
+  }
+  return functions;
+}
+
+// Grows the operand stack so at least `slots` values fit above `sp` and
+// returns the rebased stack pointer. Only reached on calls whose callee frame
+// would overflow the current storage.
+// Grows the local-slot stack so `slots` locals fit at `base`. Frames address
+// their window by offset, so only the active `locals` pointer is rebased.
+void growFastLocalSlots(std::vector<uint64_t> &storage, size_t base, size_t slots) {
+  storage.resize(std::max(storage.size() * 2, base + slots + 64), 0);
+}
+
+uint64_t *growFastStack(std::vector<uint64_t> &storage,
+                        uint64_t *&base,
+                        uint64_t *&end,
+                        uint64_t *sp,
+                        size_t slots) {
+  const size_t used = static_cast<size_t>(sp - base);
+  storage.resize(std::max(storage.size() * 2, used + slots + 16), 0);
+  base = storage.data();
+  end = base + storage.size();
+  return base + used;
+}
+
+// Forwards one print/file instruction to the host through a scratch vector
+// holding exactly the operands it pops, then copies its results back.
+uint64_t *runFastHostInstruction(const IrModule &module,
+                                 VmKernelHost &host,
+                                 const IrInstruction &inst,
+                                 bool print,
+                                 std::span<uint64_t> locals,
+                                 std::vector<uint64_t> &scratch,
+                                 uint64_t *sp,
+                                 std::string &error) {
+  const FastStackEffect effect = fastStackEffect(inst.op);
+  scratch.assign(sp - effect.pops, sp);
+  sp -= effect.pops;
+  const bool ok = print ? host.handlePrintInstruction(module, inst, scratch, error)
+                        : host.handleFileInstruction(module, inst, scratch, locals, error);
+  if (!ok) {
+    return nullptr;
+  }
+  for (const uint64_t value : scratch) {
+    *sp++ = value;
+  }
+  return sp;
+}
+
+#if PRIMESTRUCT_VM_FAST_THREADED
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+bool runFastThreadedCode(const IrModule &module,
+                         VmKernelHost &host,
+                         std::vector<FastFunction> &functions,
+                         uint64_t &result,
+                         std::string &error) {
+#if PRIMESTRUCT_VM_FAST_THREADED
+#define PRIMESTRUCT_VM_FAST_LABEL_ADDRESS(name) &&fast_op_##name,
+  static const void *const kHandlers[] = {PRIMESTRUCT_VM_FAST_OPS(PRIMESTRUCT_VM_FAST_LABEL_ADDRESS)};
+#undef PRIMESTRUCT_VM_FAST_LABEL_ADDRESS
+  for (auto &function : functions) {
+    for (auto &op : function.code) {
+      op.handler = kHandlers[static_cast<size_t>(op.kind)];
+    }
+  }
+#define PRIMESTRUCT_VM_FAST_CASE(name) fast_op_##name:
+#define PRIMESTRUCT_VM_FAST_DISPATCH() goto *pc->handler
+#else
+#define PRIMESTRUCT_VM_FAST_CASE(name) case FastOpKind::name:
+#define PRIMESTRUCT_VM_FAST_DISPATCH() continue
+#endif
+
+  const size_t maxCallDepth = host.maxCallDepth();
+  const size_t entryIndex = static_cast<size_t>(module.entryIndex);
+
+  std::vector<uint64_t> stackStorage(functions[entryIndex].frameSlots + 16, 0);
+  uint64_t *stackBase = stackStorage.data();
+  uint64_t *stackEnd = stackBase + stackStorage.size();
+  uint64_t *sp = stackBase;
+  std::vector<uint64_t> hostStack;
+
+  std::vector<uint64_t> localSlots(std::max<size_t>(functions[entryIndex].localCount, 256), 0);
+  std::vector<FastFrame> frames;
+  frames.reserve(std::min<size_t>(maxCallDepth, 64));
+  frames.emplace_back();
+  frames.back().functionIndex = entryIndex;
+  frames.back().localCount = functions[entryIndex].localCount;
+  size_t depth = 1;
+  FastFrame *frame = &frames.back();
+  const FastOp *code = functions[entryIndex].code.data();
+  const FastOp *pc = code;
+  uint64_t *locals = localSlots.data();
+  uint64_t returnValue = 0;
+
+#define PRIMESTRUCT_VM_FAST_BINARY(expr)                                                             \
+  {                                                                                                 \
+    const uint64_t rhs = sp[-1];                                                                    \
+    const uint64_t lhs = sp[-2];                                                                    \
+    (void)lhs;                                                                                      \
+    (void)rhs;                                                                                      \
+    --sp;                                                                                           \
+    sp[-1] = (expr);                                                                                \
+    ++pc;                                                                                           \
+    PRIMESTRUCT_VM_FAST_DISPATCH();                                                                 \
+  }
+#define PRIMESTRUCT_VM_FAST_UNARY(expr)                                                              \
+  {                                                                                                 \
+    const uint64_t value = sp[-1];                                                                  \
+    sp[-1] = (expr);                                                                                \
+    ++pc;                                                                                           \
+    PRIMESTRUCT_VM_FAST_DISPATCH();                                                                 \
+  }
+
+#if PRIMESTRUCT_VM_FAST_THREADED
+  PRIMESTRUCT_VM_FAST_DISPATCH();
+  {
+#else
+  for (;;) {
+    switch (pc->kind) {
+#endif
+    PRIMESTRUCT_VM_FAST_CASE(Invalid) {
+      error = "unknown IR opcode";
+      return false;
+    }
+    PRIMESTRUCT_VM_FAST_CASE(PushConst) {
+      *sp++ = pc->imm;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(LoadLocal) {
+      *sp++ = locals[pc->imm];
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(StoreLocal) {
+      locals[pc->imm] = *--sp;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(LoadIndirect) {
+      if (!host.loadIndirectValue(sp[-1], {locals, frame->localCount}, sp[-1], error)) {
+        return false;
+      }
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(StoreIndirect) {
+      const uint64_t value = sp[-1];
+      uint64_t *slot = nullptr;
+      if (!host.resolveIndirectAddress(sp[-2], {locals, frame->localCount}, slot, error)) {
+        return false;
+      }
+      *slot = value;
+      --sp;
+      sp[-1] = value;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(HeapAlloc) {
+      uint64_t address = 0;
+      if (!host.allocateHeapSlots(sp[-1], address, error)) {
+        return false;
+      }
+      sp[-1] = address;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(HeapFree) {
+      if (!host.freeHeapSlots(*--sp, error)) {
+        return false;
+      }
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(HeapRealloc) {
+      uint64_t newAddress = 0;
+      if (!host.reallocHeapSlots(sp[-2], sp[-1], newAddress, error)) {
+        return false;
+      }
+      --sp;
+      sp[-1] = newAddress;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(Dup) {
+      sp[0] = sp[-1];
+      ++sp;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(Pop) {
+      --sp;
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(LoadStringByte) {
+      const std::string &text = module.stringTable[static_cast<size_t>(pc->imm)];
+      const size_t index = static_cast<size_t>(sp[-1]);
+      if (index >= text.size()) {
+        error = "string index out of bounds in IR";
+        return false;
+      }
+      sp[-1] = static_cast<uint64_t>(
+          static_cast<int64_t>(static_cast<int32_t>(static_cast<uint8_t>(text[index]))));
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(LoadStringLength) {
+      const uint64_t stringIndex = sp[-1];
+      if (stringIndex >= module.stringTable.size()) {
+        error = "invalid string index in IR";
+        return false;
+      }
+      sp[-1] = static_cast<uint64_t>(module.stringTable[static_cast<size_t>(stringIndex)].size());
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(AddI) PRIMESTRUCT_VM_FAST_BINARY(lhs + rhs)
+    PRIMESTRUCT_VM_FAST_CASE(SubI) PRIMESTRUCT_VM_FAST_BINARY(lhs - rhs)
+    PRIMESTRUCT_VM_FAST_CASE(MulI) PRIMESTRUCT_VM_FAST_BINARY(lhs * rhs)
+    PRIMESTRUCT_VM_FAST_CASE(DivI) {
+      if (sp[-1] == 0) {
+        error = "division by zero in IR";
+        return false;
+      }
+      PRIMESTRUCT_VM_FAST_BINARY(static_cast<uint64_t>(static_cast<int64_t>(lhs) / static_cast<int64_t>(rhs)))
+    }
+    PRIMESTRUCT_VM_FAST_CASE(DivU64) {
+      if (sp[-1] == 0) {
+        error = "division by zero in IR";
+        return false;
+      }
+      PRIMESTRUCT_VM_FAST_BINARY(lhs / rhs)
+    }
+    PRIMESTRUCT_VM_FAST_CASE(NegI) PRIMESTRUCT_VM_FAST_UNARY(static_cast<uint64_t>(-static_cast<int64_t>(value)))
+    PRIMESTRUCT_VM_FAST_CASE(AddF32) PRIMESTRUCT_VM_FAST_BINARY(f32ToBits(bitsToF32(lhs) + bitsToF32(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(SubF32) PRIMESTRUCT_VM_FAST_BINARY(f32ToBits(bitsToF32(lhs) - bitsToF32(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(MulF32) PRIMESTRUCT_VM_FAST_BINARY(f32ToBits(bitsToF32(lhs) * bitsToF32(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(DivF32) PRIMESTRUCT_VM_FAST_BINARY(f32ToBits(bitsToF32(lhs) / bitsToF32(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(NegF32) PRIMESTRUCT_VM_FAST_UNARY(f32ToBits(-bitsToF32(value)))
+    PRIMESTRUCT_VM_FAST_CASE(AddF64) PRIMESTRUCT_VM_FAST_BINARY(f64ToBits(bitsToF64(lhs) + bitsToF64(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(SubF64) PRIMESTRUCT_VM_FAST_BINARY(f64ToBits(bitsToF64(lhs) - bitsToF64(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(MulF64) PRIMESTRUCT_VM_FAST_BINARY(f64ToBits(bitsToF64(lhs) * bitsToF64(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(DivF64) PRIMESTRUCT_VM_FAST_BINARY(f64ToBits(bitsToF64(lhs) / bitsToF64(rhs)))
+    PRIMESTRUCT_VM_FAST_CASE(NegF64) PRIMESTRUCT_VM_FAST_UNARY(f64ToBits(-bitsToF64(value)))
+    PRIMESTRUCT_VM_FAST_CASE(CmpEq) PRIMESTRUCT_VM_FAST_BINARY(lhs == rhs ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpNe) PRIMESTRUCT_VM_FAST_BINARY(lhs != rhs ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLtI)
+    PRIMESTRUCT_VM_FAST_BINARY(static_cast<int64_t>(lhs) < static_cast<int64_t>(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLeI)
+    PRIMESTRUCT_VM_FAST_BINARY(static_cast<int64_t>(lhs) <= static_cast<int64_t>(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGtI)
+    PRIMESTRUCT_VM_FAST_BINARY(static_cast<int64_t>(lhs) > static_cast<int64_t>(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGeI)
+    PRIMESTRUCT_VM_FAST_BINARY(static_cast<int64_t>(lhs) >= static_cast<int64_t>(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLtU) PRIMESTRUCT_VM_FAST_BINARY(lhs < rhs ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLeU) PRIMESTRUCT_VM_FAST_BINARY(lhs <= rhs ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGtU) PRIMESTRUCT_VM_FAST_BINARY(lhs > rhs ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGeU) PRIMESTRUCT_VM_FAST_BINARY(lhs >= rhs ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpEqF32) PRIMESTRUCT_VM_FAST_BINARY(bitsToF32(lhs) == bitsToF32(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpNeF32) PRIMESTRUCT_VM_FAST_BINARY(bitsToF32(lhs) != bitsToF32(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLtF32) PRIMESTRUCT_VM_FAST_BINARY(bitsToF32(lhs) < bitsToF32(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLeF32) PRIMESTRUCT_VM_FAST_BINARY(bitsToF32(lhs) <= bitsToF32(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGtF32) PRIMESTRUCT_VM_FAST_BINARY(bitsToF32(lhs) > bitsToF32(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGeF32) PRIMESTRUCT_VM_FAST_BINARY(bitsToF32(lhs) >= bitsToF32(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpEqF64) PRIMESTRUCT_VM_FAST_BINARY(bitsToF64(lhs) == bitsToF64(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpNeF64) PRIMESTRUCT_VM_FAST_BINARY(bitsToF64(lhs) != bitsToF64(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLtF64) PRIMESTRUCT_VM_FAST_BINARY(bitsToF64(lhs) < bitsToF64(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpLeF64) PRIMESTRUCT_VM_FAST_BINARY(bitsToF64(lhs) <= bitsToF64(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGtF64) PRIMESTRUCT_VM_FAST_BINARY(bitsToF64(lhs) > bitsToF64(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(CmpGeF64) PRIMESTRUCT_VM_FAST_BINARY(bitsToF64(lhs) >= bitsToF64(rhs) ? 1u : 0u)
+    PRIMESTRUCT_VM_FAST_CASE(ConvertI32ToF32)
+    PRIMESTRUCT_VM_FAST_UNARY(f32ToBits(static_cast<float>(static_cast<int32_t>(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertI64ToF32)
+    PRIMESTRUCT_VM_FAST_UNARY(f32ToBits(static_cast<float>(static_cast<int64_t>(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertU64ToF32) PRIMESTRUCT_VM_FAST_UNARY(f32ToBits(static_cast<float>(value)))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertI32ToF64)
+    PRIMESTRUCT_VM_FAST_UNARY(f64ToBits(static_cast<double>(static_cast<int32_t>(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertI64ToF64)
+    PRIMESTRUCT_VM_FAST_UNARY(f64ToBits(static_cast<double>(static_cast<int64_t>(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertU64ToF64) PRIMESTRUCT_VM_FAST_UNARY(f64ToBits(static_cast<double>(value)))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF32ToI32)
+    PRIMESTRUCT_VM_FAST_UNARY(
+        static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(bitsToF32(value)))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF32ToI64)
+    PRIMESTRUCT_VM_FAST_UNARY(static_cast<uint64_t>(static_cast<int64_t>(bitsToF32(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF32ToU64) PRIMESTRUCT_VM_FAST_UNARY(static_cast<uint64_t>(bitsToF32(value)))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF64ToI32)
+    PRIMESTRUCT_VM_FAST_UNARY(
+        static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(bitsToF64(value)))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF64ToI64)
+    PRIMESTRUCT_VM_FAST_UNARY(static_cast<uint64_t>(static_cast<int64_t>(bitsToF64(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF64ToU64) PRIMESTRUCT_VM_FAST_UNARY(static_cast<uint64_t>(bitsToF64(value)))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF32ToF64)
+    PRIMESTRUCT_VM_FAST_UNARY(f64ToBits(static_cast<double>(bitsToF32(value))))
+    PRIMESTRUCT_VM_FAST_CASE(ConvertF64ToF32)
+    PRIMESTRUCT_VM_FAST_UNARY(f32ToBits(static_cast<float>(bitsToF64(value))))
+    PRIMESTRUCT_VM_FAST_CASE(MathUnaryF32)
+    PRIMESTRUCT_VM_FAST_UNARY(f32ToBits(applyMathFunction(static_cast<IrMathFunction>(pc->imm), bitsToF32(value))))
+    PRIMESTRUCT_VM_FAST_CASE(MathUnaryF64)
+    PRIMESTRUCT_VM_FAST_UNARY(f64ToBits(applyMathFunction(static_cast<IrMathFunction>(pc->imm), bitsToF64(value))))
+    PRIMESTRUCT_VM_FAST_CASE(MathBinaryF32)
+    PRIMESTRUCT_VM_FAST_BINARY(
+        f32ToBits(applyMathFunction(static_cast<IrMathFunction>(pc->imm), bitsToF32(lhs), bitsToF32(rhs))))
+    PRIMESTRUCT_VM_FAST_CASE(MathBinaryF64)
+    PRIMESTRUCT_VM_FAST_BINARY(
+        f64ToBits(applyMathFunction(static_cast<IrMathFunction>(pc->imm), bitsToF64(lhs), bitsToF64(rhs))))
+    PRIMESTRUCT_VM_FAST_CASE(Jump) {
+      pc = code + pc->imm;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(JumpIfZero) {
+      pc = *--sp == 0 ? code + pc->imm : pc + 1;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(Call)
+    PRIMESTRUCT_VM_FAST_CASE(CallVoid) {
+      if (depth >= maxCallDepth) {
+        error = "VM call stack overflow";
+        return false;
+      }
+      const size_t targetIndex = static_cast<size_t>(pc->imm);
+      const FastFunction &callee = functions[targetIndex];
+      frame->resumePc = pc + 1;
+      if (static_cast<size_t>(stackEnd - sp) < callee.frameSlots) {
+        sp = growFastStack(stackStorage, stackBase, stackEnd, sp, callee.frameSlots);
+      }
+      const size_t localsBase = frame->localsBase + frame->localCount;
+      if (localSlots.size() - localsBase < callee.localCount) {
+        growFastLocalSlots(localSlots, localsBase, callee.localCount);
+      }
+      if (depth == frames.size()) {
+        frames.emplace_back();
+      }
+      frame = &frames[depth++];
+      frame->functionIndex = targetIndex;
+      frame->returnValueToCaller = pc->kind == FastOpKind::Call;
+      frame->localsBase = localsBase;
+      frame->localCount = callee.localCount;
+      locals = localSlots.data() + localsBase;
+      std::fill_n(locals, callee.localCount, 0);
+      code = callee.code.data();
+      pc = code;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(ReturnVoid) {
+      returnValue = 0;
+      goto fast_return;
+    }
+    PRIMESTRUCT_VM_FAST_CASE(ReturnI32) {
+      returnValue = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(*--sp)));
+      goto fast_return;
+    }
+    PRIMESTRUCT_VM_FAST_CASE(ReturnI64) {
+      returnValue = *--sp;
+      goto fast_return;
+    }
+    PRIMESTRUCT_VM_FAST_CASE(ReturnF32) {
+      returnValue = static_cast<uint64_t>(static_cast<uint32_t>(*--sp));
+      goto fast_return;
+    }
+    PRIMESTRUCT_VM_FAST_CASE(HostPrint) {
+      sp = runFastHostInstruction(module,
+                                  host,
+                                  module.functions[frame->functionIndex].instructions[pc->imm],
+                                  true,
+                                  {locals, frame->localCount},
+                                  hostStack,
+                                  sp,
+                                  error);
+      if (sp == nullptr) {
+        return false;
+      }
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+    PRIMESTRUCT_VM_FAST_CASE(HostFile) {
+      sp = runFastHostInstruction(module,
+                                  host,
+                                  module.functions[frame->functionIndex].instructions[pc->imm],
+                                  false,
+                                  {locals, frame->localCount},
+                                  hostStack,
+                                  sp,
+                                  error);
+      if (sp == nullptr) {
+        return false;
+      }
+      ++pc;
+      PRIMESTRUCT_VM_FAST_DISPATCH();
+    }
+#if !PRIMESTRUCT_VM_FAST_THREADED
+    }
+    continue;
+#endif
+  fast_return : {
+    if (depth == 1) {
+      result = returnValue;
+      return true;
+    }
+    const bool returnToCaller = frame->returnValueToCaller;
+    frame = &frames[--depth - 1];
+    code = functions[frame->functionIndex].code.data();
+    pc = frame->resumePc;
+    locals = localSlots.data() + frame->localsBase;
+    if (returnToCaller) {
+      *sp++ = returnValue;
+    }
+    PRIMESTRUCT_VM_FAST_DISPATCH();
+  }
+  }
+
+#undef PRIMESTRUCT_VM_FAST_UNARY
+#undef PRIMESTRUCT_VM_FAST_BINARY
+#undef PRIMESTRUCT_VM_FAST_DISPATCH
+#undef PRIMESTRUCT_VM_FAST_CASE
+}
+
+#if PRIMESTRUCT_VM_FAST_THREADED
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace
+
+bool verifyVmFastKernelModule(const IrModule &module,
+                              std::vector<VmFastFunctionSignature> &signatures,
+                              std::string &reason) {
+  signatures.assign(module.functions.size(), VmFastFunctionSignature{});
+  if (module.entryIndex < 0 || static_cast<size_t>(module.entryIndex) >= module.functions.size()) {
+    reason = "invalid IR entry index";
+    return false;
+  }
+  const std::vector<size_t> reachable = collectFastReachableFunctions(module);
+
+  // Signatures only move one way (a callee becomes known, its min height
+  // drops, its max height grows), so the fixpoint converges unless some
+  // recursion consumes caller stack on every level; the iteration cap turns
+  // that case into a verification failure.
+  const size_t maxIterations = 4 * reachable.size() + 8;
+  for (size_t iteration = 0;; ++iteration) {
+    if (iteration >= maxIterations) {
+      reason = "operand stack does not stabilize across recursive calls";
+      return false;
+    }
+    bool changed = false;
+    bool pending = false;
+    for (const size_t functionIndex : reachable) {
+      FastFunctionAnalysis analysis;
+      if (analyzeFastFunction(module, functionIndex, signatures, analysis, reason) ==
+          FastAnalysisResult::Rejected) {
+        return false;
+      }
+      pending = pending || analysis.reachesPendingCall;
+      VmFastFunctionSignature &current = signatures[functionIndex];
+      if (!analysis.signature.returns) {
+        continue;
+      }
+      if (current.returns && current.netHeight != analysis.signature.netHeight) {
+        reason = "function " + module.functions[functionIndex].name + " changes its return stack height";
+        return false;
+      }
+      if (!current.returns || current.minHeight != analysis.signature.minHeight ||
+          current.maxHeight != analysis.signature.maxHeight) {
+        current = analysis.signature;
+        changed = true;
+      }
+    }
+    if (changed) {
+      continue;
+    }
+    if (pending) {
+      reason = "call target never returns";
+      return false;
+    }
+    break;
+  }
+
+  // The entry frame starts on an empty operand stack, so it may not pop
+  // below its own base; callee minimums are folded into their callers above.
+  FastFunctionAnalysis entryAnalysis;
+  if (analyzeFastFunction(module, static_cast<size_t>(module.entryIndex), signatures, entryAnalysis, reason) ==
+      FastAnalysisResult::Rejected) {
+    return false;
+  }
+  if (entryAnalysis.signature.minHeight < 0) {
+    reason = "entry function pops below an empty operand stack";
+    return false;
+  }
+  signatures[static_cast<size_t>(module.entryIndex)] = entryAnalysis.signature;
+  return true;
+}
+
+bool executeVmFastKernel(const IrModule &module,
+                         VmKernelHost &host,
+                         uint64_t &result,
+                         std::string &error) {
+  std::vector<VmFastFunctionSignature> signatures;
+  std::string reason;
+  if (!verifyVmFastKernelModule(module, signatures, reason)) {
+    return executeVmKernel(module, host, result, error);
+  }
+  std::vector<FastFunction> functions =
+      decodeFastModule(module, signatures, collectFastReachableFunctions(module), host);
+  return runFastThreadedCode(module, host, functions, result, error);
+}
+
+} // namespace primec::vm_detail
@@ -1,190 +1,362 @@
 #include "VmHeapHelpers.h"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 
-namespace primec::vm_detail {
+namespace primec {
 namespace {
 
-constexpr uint64_t kVmHeapAddressTag = 1ull << 63;
+size_t vmHeapSizeClassShift(uint64_t slotCount) {
+  size_t shift = 0;
+  while ((uint64_t{1} << shift) < slotCount) {
+    ++shift;
+  }
+  return shift;
+}
 
-bool isVmHeapAddress(uint64_t address) {
-  return (address & kVmHeapAddressTag) != 0;
+uint64_t vmHeapMaxAddressableIndex(uint64_t slotBytes) {
+  return (std::numeric_limits<uint64_t>::max() - VmHeap::AddressTag) / slotBytes;
 }
 
 } // namespace
 
-bool resolveIndirectAddress(uint64_t address,
-                            uint64_t slotBytes,
-                            std::vector<uint64_t> &locals,
-                            std::vector<uint64_t> &heapSlots,
-                            std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
-                            uint64_t *&slotOut,
-                            std::string &error) {
-  if (address % slotBytes != 0) {
-    error = "unaligned indirect address in IR: " + std::to_string(address);
+bool VmHeap::findBlock(size_t baseIndex, BlockRef &out) const {
+  const size_t page = baseIndex >> PageShift;
+  if (page >= pages_.size()) {
     return false;
   }
-  if (isVmHeapAddress(address)) {
-    const uint64_t heapAddress = address & ~kVmHeapAddressTag;
-    const uint64_t index = heapAddress / slotBytes;
-    if (index >= heapSlots.size()) {
-      error = "invalid indirect address in IR: " + std::to_string(address);
+  const Page &info = pages_[page];
+  if (info.blockSlots == 0) {
+    return false;
+  }
+  if (info.large) {
+    if (baseIndex != (info.runFirstPage << PageShift)) {
       return false;
     }
-    for (const auto &allocation : heapAllocations) {
-      if (!allocation.live) {
-        continue;
-      }
-      const uint64_t baseIndex = static_cast<uint64_t>(allocation.baseIndex);
-      const uint64_t endIndex = baseIndex + static_cast<uint64_t>(allocation.slotCount);
-      if (index >= baseIndex && index < endIndex) {
-        slotOut = &heapSlots[static_cast<size_t>(index)];
-        return true;
-      }
+    out = {baseIndex, info.blockSlots, info.metaIndex, true};
+  } else {
+    const size_t offset = baseIndex & (PageSlots - 1);
+    if ((offset & (info.blockSlots - 1)) != 0) {
+      return false;
     }
-    error = "invalid indirect address in IR: " + std::to_string(address);
-    return false;
+    out = {baseIndex, info.blockSlots, info.metaIndex + static_cast<uint32_t>(offset >> info.blockShift), false};
   }
-  const uint64_t index = address / slotBytes;
-  if (index >= locals.size()) {
-    error = "invalid indirect address in IR: " + std::to_string(address);
+  return blockSlotCounts_[out.metaIndex] != 0;
+}
+
+bool VmHeap::acquirePages(size_t pageCount, size_t &firstPageOut, bool &reusedOut) {
+  for (auto it = freeRuns_.begin(); it != freeRuns_.end(); ++it) {
+    if (it->second < pageCount) {
+      continue;
+    }
+    firstPageOut = it->first;
+    const size_t remaining = it->second - pageCount;
+    freeRuns_.erase(it);
+    if (remaining != 0) {
+      freeRuns_.emplace(firstPageOut + pageCount, remaining);
+    }
+    reusedOut = true;
+    return true;
+  }
+  const size_t firstPage = pages_.size();
+  if (pageCount > slots_.max_size() / PageSlots - firstPage) {
     return false;
   }
-  slotOut = &locals[static_cast<size_t>(index)];
+  pages_.resize(firstPage + pageCount);
+  slots_.resize((firstPage + pageCount) * PageSlots, 0);
+  firstPageOut = firstPage;
+  reusedOut = false;
   return true;
 }
 
-bool allocateVmHeapSlots(uint64_t slotCount,
-                         uint64_t slotBytes,
-                         std::vector<uint64_t> &heapSlots,
-                         std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
-                         uint64_t &addressOut,
-                         std::string &error) {
+void VmHeap::releasePages(size_t firstPage, size_t pageCount) {
+  std::fill(pages_.begin() + static_cast<std::ptrdiff_t>(firstPage),
+            pages_.begin() + static_cast<std::ptrdiff_t>(firstPage + pageCount),
+            Page{});
+  auto next = freeRuns_.lower_bound(firstPage);
+  if (next != freeRuns_.end() && next->first == firstPage + pageCount) {
+    pageCount += next->second;
+    next = freeRuns_.erase(next);
+  }
+  if (next != freeRuns_.begin()) {
+    auto previous = std::prev(next);
+    if (previous->first + previous->second == firstPage) {
+      firstPage = previous->first;
+      pageCount += previous->second;
+      freeRuns_.erase(previous);
+    }
+  }
+  if (firstPage + pageCount == pages_.size()) {
+    // A run that reaches the top of the heap is returned instead of kept.
+    pages_.resize(firstPage);
+    slots_.resize(firstPage * PageSlots);
+    return;
+  }
+  freeRuns_.emplace(firstPage, pageCount);
+}
+
+uint32_t VmHeap::acquireLargeMeta() {
+  if (!freeLargeMetas_.empty()) {
+    const uint32_t meta = freeLargeMetas_.back();
+    freeLargeMetas_.pop_back();
+    return meta;
+  }
+  blockSlotCounts_.push_back(0);
+  return static_cast<uint32_t>(blockSlotCounts_.size() - 1);
+}
+
+void VmHeap::noteAllocated(uint64_t slotCount, uint64_t slotBytes, bool reused) {
+  stats_.liveBytes += slotCount * slotBytes;
+  stats_.peakBytes = std::max(stats_.peakBytes, stats_.liveBytes);
+  stats_.allocationCount += 1;
+  if (reused) {
+    stats_.reusedAllocationCount += 1;
+  }
+}
+
+bool VmHeap::allocate(uint64_t slotCount, uint64_t slotBytes, uint64_t &addressOut, std::string &error) {
   if (slotCount == 0) {
     addressOut = 0;
     return true;
   }
-  if (slotCount > static_cast<uint64_t>(std::numeric_limits<size_t>::max())) {
+  const uint64_t maxAddressableIndex = vmHeapMaxAddressableIndex(slotBytes);
+  if (slotCount > static_cast<uint64_t>(std::numeric_limits<size_t>::max()) || slotCount > maxAddressableIndex) {
     error = "VM heap allocation overflow";
     return false;
   }
-  const size_t baseIndex = heapSlots.size();
-  const size_t allocationSlots = static_cast<size_t>(slotCount);
-  if (allocationSlots > heapSlots.max_size() - baseIndex) {
+  // Growth never reaches past the tagged address range, even if every page
+  // needed has to come from the top of the heap.
+  const uint64_t pagesNeeded = slotCount <= PageSlots / 2 ? 1 : (slotCount + PageSlots - 1) >> PageShift;
+  if (pages_.size() + pagesNeeded > maxAddressableIndex / PageSlots) {
     error = "VM heap allocation overflow";
     return false;
   }
-  const uint64_t maxAddressableIndex = (std::numeric_limits<uint64_t>::max() - kVmHeapAddressTag) / slotBytes;
-  if (baseIndex > maxAddressableIndex) {
-    error = "VM heap allocation overflow";
-    return false;
+
+  size_t baseIndex = 0;
+  bool reused = false;
+  if (slotCount <= PageSlots / 2) {
+    const size_t shift = vmHeapSizeClassShift(slotCount);
+    std::vector<size_t> &freeList = freeBlocks_[shift];
+    if (freeList.empty()) {
+      size_t page = 0;
+      bool pageReused = false;
+      if (!acquirePages(1, page, pageReused)) {
+        error = "VM heap allocation overflow";
+        return false;
+      }
+      const size_t blockSlots = size_t{1} << shift;
+      const size_t blockCount = PageSlots >> shift;
+      Page &info = pages_[page];
+      info.blockSlots = blockSlots;
+      info.blockShift = shift;
+      info.runFirstPage = page;
+      info.metaIndex = static_cast<uint32_t>(blockSlotCounts_.size());
+      info.large = false;
+      blockSlotCounts_.resize(blockSlotCounts_.size() + blockCount, 0);
+      for (size_t block = blockCount; block-- > 0;) {
+        freeList.push_back((page << PageShift) + block * blockSlots);
+      }
+      if (!pageReused) {
+        freshBlockCounts_[shift] += blockCount;
+      }
+    }
+    reused = freeList.size() > freshBlockCounts_[shift];
+    if (!reused) {
+      freshBlockCounts_[shift] -= 1;
+    }
+    baseIndex = freeList.back();
+    freeList.pop_back();
+    const Page &info = pages_[baseIndex >> PageShift];
+    blockSlotCounts_[info.metaIndex + ((baseIndex & (PageSlots - 1)) >> shift)] = slotCount;
+  } else {
+    const size_t pageCount = static_cast<size_t>(pagesNeeded);
+    size_t firstPage = 0;
+    if (!acquirePages(pageCount, firstPage, reused)) {
+      error = "VM heap allocation overflow";
+      return false;
+    }
+    const uint32_t meta = acquireLargeMeta();
+    for (size_t page = firstPage; page < firstPage + pageCount; ++page) {
+      pages_[page] = {pageCount << PageShift, 0, firstPage, meta, true};
+    }
+    blockSlotCounts_[meta] = slotCount;
+    baseIndex = firstPage << PageShift;
   }
-  heapSlots.resize(baseIndex + allocationSlots, 0);
-  heapAllocations.push_back({baseIndex, allocationSlots, true});
-  addressOut = kVmHeapAddressTag + static_cast<uint64_t>(baseIndex) * slotBytes;
+  std::fill_n(slots_.begin() + static_cast<std::ptrdiff_t>(baseIndex), static_cast<size_t>(slotCount), 0);
+  noteAllocated(slotCount, slotBytes, reused);
+  addressOut = AddressTag + static_cast<uint64_t>(baseIndex) * slotBytes;
   return true;
 }
 
-bool freeVmHeapSlots(uint64_t address,
-                     uint64_t slotBytes,
-                     std::vector<uint64_t> &heapSlots,
-                     std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
-                     std::string &error) {
+bool VmHeap::free(uint64_t address, uint64_t slotBytes, std::string &error) {
   if (address == 0) {
     return true;
   }
-  if (!isVmHeapAddress(address) || address % slotBytes != 0) {
+  BlockRef block;
+  if ((address & AddressTag) == 0 || address % slotBytes != 0 ||
+      !findBlock(static_cast<size_t>((address & ~AddressTag) / slotBytes), block)) {
     error = "invalid heap free address in IR: " + std::to_string(address);
     return false;
   }
-  const uint64_t heapAddress = address & ~kVmHeapAddressTag;
-  const uint64_t baseIndex = heapAddress / slotBytes;
-  for (auto &allocation : heapAllocations) {
-    if (allocation.baseIndex != baseIndex) {
-      continue;
-    }
-    if (!allocation.live) {
-      error = "invalid heap free address in IR: " + std::to_string(address);
-      return false;
-    }
-    const size_t endIndex = allocation.baseIndex + allocation.slotCount;
-    if (endIndex > heapSlots.size()) {
-      error = "invalid heap free address in IR: " + std::to_string(address);
-      return false;
-    }
-    for (size_t index = allocation.baseIndex; index < endIndex; ++index) {
-      heapSlots[index] = 0;
-    }
-    allocation.live = false;
-    return true;
+  stats_.liveBytes -= blockSlotCounts_[block.metaIndex] * slotBytes;
+  blockSlotCounts_[block.metaIndex] = 0;
+  if (block.large) {
+    freeLargeMetas_.push_back(block.metaIndex);
+    releasePages(block.baseIndex >> PageShift, block.capacitySlots >> PageShift);
+  } else {
+    freeBlocks_[vmHeapSizeClassShift(block.capacitySlots)].push_back(block.baseIndex);
   }
-  error = "invalid heap free address in IR: " + std::to_string(address);
-  return false;
+  return true;
 }
 
-bool reallocVmHeapSlots(uint64_t address,
+bool VmHeap::reallocate(uint64_t address,
                         uint64_t slotCount,
                         uint64_t slotBytes,
-                        std::vector<uint64_t> &heapSlots,
-                        std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
                         uint64_t &addressOut,
                         std::string &error) {
   if (address == 0) {
-    return allocateVmHeapSlots(slotCount, slotBytes, heapSlots, heapAllocations, addressOut, error);
+    return allocate(slotCount, slotBytes, addressOut, error);
   }
   if (slotCount == 0) {
-    if (!freeVmHeapSlots(address, slotBytes, heapSlots, heapAllocations, error)) {
+    if (!free(address, slotBytes, error)) {
       return false;
     }
     addressOut = 0;
     return true;
   }
-  if (!isVmHeapAddress(address) || address % slotBytes != 0) {
+  BlockRef block;
+  if ((address & AddressTag) == 0 || address % slotBytes != 0 ||
+      !findBlock(static_cast<size_t>((address & ~AddressTag) / slotBytes), block)) {
     error = "invalid heap realloc address in IR: " + std::to_string(address);
     return false;
   }
-  const uint64_t heapAddress = address & ~kVmHeapAddressTag;
-  const uint64_t baseIndex = heapAddress / slotBytes;
-  for (auto &allocation : heapAllocations) {
-    if (allocation.baseIndex != baseIndex) {
-      continue;
-    }
-    if (!allocation.live) {
-      error = "invalid heap realloc address in IR: " + std::to_string(address);
-      return false;
-    }
-    const size_t endIndex = allocation.baseIndex + allocation.slotCount;
-    if (endIndex > heapSlots.size()) {
-      error = "invalid heap realloc address in IR: " + std::to_string(address);
-      return false;
+  const uint64_t oldSlotCount = blockSlotCounts_[block.metaIndex];
+  if (slotCount <= block.capacitySlots) {
+    // The block already has room: grow or shrink in place and zero the slots
+    // that become visible.
+    if (slotCount > oldSlotCount) {
+      std::fill(slots_.begin() + static_cast<std::ptrdiff_t>(block.baseIndex + oldSlotCount),
+                slots_.begin() + static_cast<std::ptrdiff_t>(block.baseIndex + slotCount),
+                0);
     }
-    const size_t oldBaseIndex = allocation.baseIndex;
-    const size_t oldSlotCount = allocation.slotCount;
+    blockSlotCounts_[block.metaIndex] = slotCount;
+    stats_.liveBytes = stats_.liveBytes - oldSlotCount * slotBytes + slotCount * slotBytes;
+    stats_.peakBytes = std::max(stats_.peakBytes, stats_.liveBytes);
+    addressOut = address;
+    return true;
+  }
+  uint64_t newAddress = 0;
+  if (!allocate(slotCount, slotBytes, newAddress, error)) {
+    return false;
+  }
+  const size_t newBaseIndex = static_cast<size_t>((newAddress & ~AddressTag) / slotBytes);
+  std::copy_n(slots_.begin() + static_cast<std::ptrdiff_t>(block.baseIndex),
+              static_cast<size_t>(std::min(oldSlotCount, slotCount)),
+              slots_.begin() + static_cast<std::ptrdiff_t>(newBaseIndex));
+  free(address, slotBytes, error);
+  addressOut = newAddress;
+  return true;
+}
+
+uint64_t *VmHeap::resolve(uint64_t address, uint64_t slotBytes, uint64_t slotCount) {
+  const size_t index = static_cast<size_t>((address & ~AddressTag) / slotBytes);
+  const size_t page = index >> PageShift;
+  if (page >= pages_.size()) {
+    return nullptr;
+  }
+  const Page &info = pages_[page];
+  if (info.blockSlots == 0) {
+    return nullptr;
+  }
+  size_t baseIndex = 0;
+  uint32_t meta = info.metaIndex;
+  if (info.large) {
+    baseIndex = info.runFirstPage << PageShift;
+  } else {
+    baseIndex = index & ~(info.blockSlots - 1);
+    meta += static_cast<uint32_t>((index & (PageSlots - 1)) >> info.blockShift);
+  }
+  const uint64_t liveSlots = blockSlotCounts_[meta];
+  const uint64_t offset = index - baseIndex;
+  if (offset >= liveSlots || slotCount > liveSlots - offset) {
+    return nullptr;
+  }
+  return &slots_[index];
+}
+
+void VmHeap::clear() {
+  slots_.clear();
+  pages_.clear();
+  blockSlotCounts_.clear();
+  freeLargeMetas_.clear();
+  for (auto &freeList : freeBlocks_) {
+    freeList.clear();
+  }
+  freshBlockCounts_ = {};
+  freeRuns_.clear();
+  stats_ = {};
+}
+
+namespace vm_detail {
+
+bool resolveIndirectAddress(uint64_t address,
+                            uint64_t slotBytes,
+                            std::span<uint64_t> locals,
+                            VmHeap &heap,
+                            uint64_t *&slotOut,
+                            std::string &error) {
+  return resolveIndirectRange(address, 1, slotBytes, locals, heap, slotOut, error);
+}
 
-    uint64_t newAddress = 0;
-    if (!allocateVmHeapSlots(slotCount, slotBytes, heapSlots, heapAllocations, newAddress, error)) {
+bool resolveIndirectRange(uint64_t address,
+                          uint64_t slotCount,
+                          uint64_t slotBytes,
+                          std::span<uint64_t> locals,
+                          VmHeap &heap,
+                          uint64_t *&slotOut,
+                          std::string &error) {
+  if (address % slotBytes != 0) {
+    error = "unaligned indirect address in IR: " + std::to_string(address);
+    return false;
+  }
+  if ((address & VmHeap::AddressTag) != 0) {
+    slotOut = heap.resolve(address, slotBytes, slotCount);
+    if (slotOut == nullptr) {
+      error = "invalid indirect address in IR: " + std::to_string(address);
       return false;
     }
-    const uint64_t newBaseIndex = (newAddress & ~kVmHeapAddressTag) / slotBytes;
-    const size_t copySlots = std::min(oldSlotCount, static_cast<size_t>(slotCount));
-    for (size_t index = 0; index < copySlots; ++index) {
-      heapSlots[static_cast<size_t>(newBaseIndex) + index] = heapSlots[oldBaseIndex + index];
-    }
-    for (size_t index = oldBaseIndex; index < endIndex; ++index) {
-      heapSlots[index] = 0;
-    }
-    for (auto &candidate : heapAllocations) {
-      if (candidate.baseIndex == oldBaseIndex) {
-        candidate.live = false;
-        break;
-      }
-    }
-    addressOut = newAddress;
     return true;
   }
-  error = "invalid heap realloc address in IR: " + std::to_string(address);
-  return false;
+  const uint64_t index = address / slotBytes;
+  if (index >= locals.size() || slotCount > locals.size() - index) {
+    error = "invalid indirect address in IR: " + std::to_string(address);
+    return false;
+  }
+  slotOut = &locals[static_cast<size_t>(index)];
+  return true;
+}
+
+bool allocateVmHeapSlots(uint64_t slotCount,
+                         uint64_t slotBytes,
+                         VmHeap &heap,
+                         uint64_t &addressOut,
+                         std::string &error) {
+  return heap.allocate(slotCount, slotBytes, addressOut, error);
+}
+
+bool freeVmHeapSlots(uint64_t address, uint64_t slotBytes, VmHeap &heap, std::string &error) {
+  return heap.free(address, slotBytes, error);
+}
+
+bool reallocVmHeapSlots(uint64_t address,
+                        uint64_t slotCount,
+                        uint64_t slotBytes,
+                        VmHeap &heap,
+                        uint64_t &addressOut,
+                        std::string &error) {
+  return heap.reallocate(address, slotCount, slotBytes, addressOut, error);
 }
 
-} // namespace primec::vm_detail
+} // namespace vm_detail
+} // namespace primec
@@ -1,39 +1,42 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string>
-#include <vector>
 
-#include "primec/Vm.h"
+#include "primec/VmHeap.h"
 
 namespace primec::vm_detail {
 
 bool resolveIndirectAddress(uint64_t address,
                             uint64_t slotBytes,
-                            std::vector<uint64_t> &locals,
-                            std::vector<uint64_t> &heapSlots,
-                            std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
+                            std::span<uint64_t> locals,
+                            VmHeap &heap,
                             uint64_t *&slotOut,
                             std::string &error);
 
+// Resolves `slotCount` consecutive slots starting at `address`; the whole
+// range must sit inside the current locals or one live heap allocation.
+bool resolveIndirectRange(uint64_t address,
+                          uint64_t slotCount,
+                          uint64_t slotBytes,
+                          std::span<uint64_t> locals,
+                          VmHeap &heap,
+                          uint64_t *&slotOut,
+                          std::string &error);
+
 bool allocateVmHeapSlots(uint64_t slotCount,
                          uint64_t slotBytes,
-                         std::vector<uint64_t> &heapSlots,
-                         std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
+                         VmHeap &heap,
                          uint64_t &addressOut,
                          std::string &error);
 
-bool freeVmHeapSlots(uint64_t address,
-                     uint64_t slotBytes,
-                     std::vector<uint64_t> &heapSlots,
-                     std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
-                     std::string &error);
+bool freeVmHeapSlots(uint64_t address, uint64_t slotBytes, VmHeap &heap, std::string &error);
 
 bool reallocVmHeapSlots(uint64_t address,
                         uint64_t slotCount,
                         uint64_t slotBytes,
-                        std::vector<uint64_t> &heapSlots,
-                        std::vector<VmDebugSession::HeapAllocation> &heapAllocations,
+                        VmHeap &heap,
                         uint64_t &addressOut,
                         std::string &error);
 
@@ -1,8 +1,14 @@
 #include "VmIoHelpers.h"
 
+#include "VmHeapHelpers.h"
+
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cstdio>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 namespace primec::vm_detail {
@@ -82,6 +88,10 @@ uint64_t packFileHandle(int fd) {
   return static_cast<uint64_t>(static_cast<uint32_t>(fd));
 }
 
+bool isWritableFileOpen(IrOpcode opcode) {
+  return opcode != IrOpcode::FileOpenRead && opcode != IrOpcode::FileOpenReadDynamic;
+}
+
 int resolveFileOpenFlags(IrOpcode opcode) {
   switch (opcode) {
     case IrOpcode::FileOpenWrite:
@@ -100,6 +110,249 @@ int resolveFileOpenFlags(IrOpcode opcode) {
 
 } // namespace
 
+} // namespace primec::vm_detail
+
+namespace primec {
+
+VmFileBuffers::~VmFileBuffers() {
+  flushAll();
+  unmapAll();
+}
+
+void VmFileBuffers::track(int fd, bool writable) {
+  if (fd < 0) {
+    return;
+  }
+  if (static_cast<size_t>(fd) >= buffers_.size()) {
+    buffers_.resize(static_cast<size_t>(fd) + 1);
+  }
+  Buffer &buffer = buffers_[static_cast<size_t>(fd)];
+  buffer.tracked = true;
+  buffer.writable = writable;
+  buffer.begin = 0;
+  buffer.end = 0;
+}
+
+VmFileBuffers::Buffer *VmFileBuffers::find(int fd) {
+  if (fd < 0 || static_cast<size_t>(fd) >= buffers_.size()) {
+    return nullptr;
+  }
+  Buffer &buffer = buffers_[static_cast<size_t>(fd)];
+  return buffer.tracked ? &buffer : nullptr;
+}
+
+uint32_t VmFileBuffers::drain(int fd, Buffer &buffer) {
+  if (!buffer.writable || buffer.end == 0) {
+    return 0;
+  }
+  const int rc = vm_detail::writeAll(fd, buffer.bytes.data(), buffer.end);
+  buffer.end = 0;
+  return static_cast<uint32_t>(rc);
+}
+
+uint32_t VmFileBuffers::readByte(int fd, uint8_t &value) {
+  size_t count = 0;
+  return read(fd, &value, 1, count);
+}
+
+uint32_t VmFileBuffers::read(int fd, uint8_t *data, size_t size, size_t &readOut) {
+  readOut = 0;
+  Buffer *buffer = find(fd);
+  if (buffer != nullptr && buffer->writable) {
+    buffer = nullptr;
+  }
+  while (readOut < size) {
+    if (buffer != nullptr && buffer->begin != buffer->end) {
+      const size_t take = std::min(size - readOut, buffer->end - buffer->begin);
+      std::copy_n(buffer->bytes.begin() + static_cast<std::ptrdiff_t>(buffer->begin), take, data + readOut);
+      buffer->begin += take;
+      readOut += take;
+      continue;
+    }
+    const size_t remaining = size - readOut;
+    ssize_t rc = 0;
+    if (buffer != nullptr && remaining < BufferBytes) {
+      if (buffer->bytes.size() < BufferBytes) {
+        buffer->bytes.resize(BufferBytes);
+      }
+      rc = ::read(fd, buffer->bytes.data(), buffer->bytes.size());
+      if (rc > 0) {
+        buffer->begin = 0;
+        buffer->end = static_cast<size_t>(rc);
+        continue;
+      }
+    } else {
+      // Large reads bypass the buffer once it is empty.
+      rc = ::read(fd, data + readOut, remaining);
+      if (rc > 0) {
+        readOut += static_cast<size_t>(rc);
+        continue;
+      }
+    }
+    return rc < 0 ? vm_detail::currentIoErrorCode() : FileReadEofCode;
+  }
+  return 0;
+}
+
+uint32_t VmFileBuffers::write(int fd, const void *data, size_t size) {
+  Buffer *buffer = find(fd);
+  if (buffer == nullptr || !buffer->writable) {
+    return static_cast<uint32_t>(vm_detail::writeAll(fd, data, size));
+  }
+  if (buffer->end + size > BufferBytes) {
+    if (const uint32_t err = drain(fd, *buffer); err != 0) {
+      return err;
+    }
+    if (size >= BufferBytes) {
+      return static_cast<uint32_t>(vm_detail::writeAll(fd, data, size));
+    }
+  }
+  if (buffer->bytes.size() < BufferBytes) {
+    buffer->bytes.resize(BufferBytes);
+  }
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  std::copy(bytes, bytes + size, buffer->bytes.begin() + static_cast<std::ptrdiff_t>(buffer->end));
+  buffer->end += size;
+  return 0;
+}
+
+uint32_t VmFileBuffers::flush(int fd) {
+  uint32_t err = 0;
+  if (Buffer *buffer = find(fd)) {
+    err = drain(fd, *buffer);
+  }
+  const int rc = ::fsync(fd);
+  if (err != 0) {
+    return err;
+  }
+  return rc < 0 ? vm_detail::currentIoErrorCode() : 0u;
+}
+
+uint32_t VmFileBuffers::close(int fd) {
+  uint32_t err = 0;
+  if (Buffer *buffer = find(fd)) {
+    err = drain(fd, *buffer);
+    buffer->tracked = false;
+    buffer->begin = 0;
+    buffer->end = 0;
+  }
+  const int rc = ::close(fd);
+  if (err != 0) {
+    return err;
+  }
+  return rc < 0 ? vm_detail::currentIoErrorCode() : 0u;
+}
+
+uint32_t VmFileBuffers::map(int fd, uint64_t slotBytes, uint64_t &addressOut) {
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    return vm_detail::currentIoErrorCode();
+  }
+  if (!S_ISREG(info.st_mode)) {
+    return ENODEV;
+  }
+  const uint64_t size = static_cast<uint64_t>(info.st_size);
+  if (views_.size() >= (MappedAddressTag >> MappedViewShift) ||
+      size >= (uint64_t{1} << MappedViewShift) / slotBytes - 1) {
+    return EFBIG;
+  }
+  MappedView view;
+  view.size = static_cast<size_t>(size);
+  if (view.size != 0) {
+    // Empty files cannot be mapped; their view is just the zero count slot.
+    void *data = ::mmap(nullptr, view.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      return vm_detail::currentIoErrorCode();
+    }
+    view.data = static_cast<const uint8_t *>(data);
+  }
+  addressOut = MappedAddressTag | (static_cast<uint64_t>(views_.size()) << MappedViewShift);
+  views_.push_back(view);
+  return 0;
+}
+
+const VmFileBuffers::MappedView *VmFileBuffers::findView(uint64_t address,
+                                                         uint64_t &slotIndexOut,
+                                                         uint64_t slotBytes) const {
+  if (!isMappedAddress(address)) {
+    return nullptr;
+  }
+  const uint64_t viewIndex = (address & ~MappedAddressTag) >> MappedViewShift;
+  const uint64_t offset = address & ((uint64_t{1} << MappedViewShift) - 1);
+  if (viewIndex >= views_.size() || offset % slotBytes != 0) {
+    return nullptr;
+  }
+  slotIndexOut = offset / slotBytes;
+  return &views_[static_cast<size_t>(viewIndex)];
+}
+
+bool VmFileBuffers::loadMapped(uint64_t address, uint64_t slotBytes, uint64_t &valueOut) const {
+  uint64_t slotIndex = 0;
+  const MappedView *view = findView(address, slotIndex, slotBytes);
+  if (view == nullptr || slotIndex > view->size) {
+    return false;
+  }
+  valueOut = slotIndex == 0 ? static_cast<uint64_t>(view->size) : view->data[slotIndex - 1];
+  return true;
+}
+
+const uint8_t *VmFileBuffers::mappedBytes(uint64_t address, uint64_t slotBytes, uint64_t count) const {
+  uint64_t slotIndex = 0;
+  const MappedView *view = findView(address, slotIndex, slotBytes);
+  if (view == nullptr || slotIndex == 0 || count > view->size || slotIndex - 1 > view->size - count) {
+    return nullptr;
+  }
+  return view->data + (slotIndex - 1);
+}
+
+void VmFileBuffers::unmapAll() {
+  for (const MappedView &view : views_) {
+    if (view.data != nullptr) {
+      ::munmap(const_cast<uint8_t *>(view.data), view.size);
+    }
+  }
+  views_.clear();
+}
+
+void VmFileBuffers::flushAll() {
+  for (size_t fd = 0; fd < buffers_.size(); ++fd) {
+    if (buffers_[fd].tracked) {
+      drain(static_cast<int>(fd), buffers_[fd]);
+    }
+  }
+}
+
+void VmFileBuffers::clear() {
+  flushAll();
+  buffers_.clear();
+  unmapAll();
+}
+
+} // namespace primec
+
+namespace primec::vm_detail {
+
+bool loadIndirectValue(uint64_t address,
+                       std::span<uint64_t> locals,
+                       VmHeap &heap,
+                       const VmFileBuffers &files,
+                       uint64_t &valueOut,
+                       std::string &error) {
+  if (VmFileBuffers::isMappedAddress(address)) {
+    if (!files.loadMapped(address, IrSlotBytes, valueOut)) {
+      error = "invalid indirect address in IR: " + std::to_string(address);
+      return false;
+    }
+    return true;
+  }
+  uint64_t *slot = nullptr;
+  if (!resolveIndirectAddress(address, IrSlotBytes, locals, heap, slot, error)) {
+    return false;
+  }
+  valueOut = *slot;
+  return true;
+}
+
 bool handlePrintOpcode(const IrModule &module,
                        const IrInstruction &inst,
                        std::vector<uint64_t> &stack,
@@ -184,7 +437,9 @@ bool handlePrintOpcode(const IrModule &module,
 bool handleFileOpcode(const IrModule &module,
                       const IrInstruction &inst,
                       std::vector<uint64_t> &stack,
-                      std::vector<uint64_t> &locals,
+                      std::span<uint64_t> locals,
+                      VmHeap &heap,
+                      VmFileBuffers &files,
                       std::string &error) {
   switch (inst.op) {
     case IrOpcode::FileOpenRead:
@@ -195,6 +450,7 @@ bool handleFileOpcode(const IrModule &module,
         return false;
       }
       const int fd = ::open(path->c_str(), resolveFileOpenFlags(inst.op), 0644);
+      files.track(fd, isWritableFileOpen(inst.op));
       stack.push_back(packFileHandle(fd));
       return true;
     }
@@ -210,6 +466,7 @@ bool handleFileOpcode(const IrModule &module,
         return false;
       }
       const int fd = ::open(path->c_str(), resolveFileOpenFlags(inst.op), 0644);
+      files.track(fd, isWritableFileOpen(inst.op));
       stack.push_back(packFileHandle(fd));
       return true;
     }
@@ -219,8 +476,7 @@ bool handleFileOpcode(const IrModule &module,
         return false;
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
-      const int rc = ::close(fd);
-      stack.push_back((rc < 0) ? static_cast<uint64_t>(currentIoErrorCode()) : 0u);
+      stack.push_back(static_cast<uint64_t>(files.close(fd)));
       return true;
     }
     case IrOpcode::FileReadByte: {
@@ -234,26 +490,87 @@ bool handleFileOpcode(const IrModule &module,
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
       uint8_t value = 0;
-      const ssize_t rc = ::read(fd, &value, 1);
-      uint32_t err = 0u;
-      if (rc < 0) {
-        err = currentIoErrorCode();
-      } else if (rc == 0) {
-        err = FileReadEofCode;
-      } else {
+      const uint32_t err = files.readByte(fd, value);
+      if (err == 0) {
         locals[static_cast<size_t>(inst.imm)] = static_cast<uint64_t>(value);
       }
       stack.push_back(static_cast<uint64_t>(err));
       return true;
     }
+    case IrOpcode::FileMapBytes: {
+      uint64_t handle = 0;
+      if (!popStackValue(stack, "IR stack underflow on file map", error, handle)) {
+        return false;
+      }
+      if (inst.imm >= locals.size()) {
+        error = "invalid local index in IR";
+        return false;
+      }
+      const int fd = static_cast<int>(handle & 0xffffffffu);
+      uint64_t address = 0;
+      const uint32_t err = files.map(fd, IrSlotBytes, address);
+      if (err == 0) {
+        locals[static_cast<size_t>(inst.imm)] = address;
+      }
+      stack.push_back(static_cast<uint64_t>(err));
+      return true;
+    }
+    case IrOpcode::FileReadBytes:
+    case IrOpcode::FileWriteBytes: {
+      const bool isRead = inst.op == IrOpcode::FileReadBytes;
+      const char *underflow = isRead ? "IR stack underflow on file read" : "IR stack underflow on file write";
+      uint64_t count = 0;
+      uint64_t handle = 0;
+      uint64_t address = 0;
+      if (!popStackValue(stack, underflow, error, count) ||
+          !popStackPair(stack, underflow, error, handle, address)) {
+        return false;
+      }
+      const int fd = static_cast<int>(handle & 0xffffffffu);
+      if (!isRead && count != 0 && VmFileBuffers::isMappedAddress(address)) {
+        // Mapped views already hold packed bytes; write them straight through.
+        const uint8_t *bytes = files.mappedBytes(address, IrSlotBytes, count);
+        if (bytes == nullptr) {
+          error = "invalid indirect address in IR: " + std::to_string(address);
+          return false;
+        }
+        stack.push_back(static_cast<uint64_t>(files.write(fd, bytes, static_cast<size_t>(count))));
+        return true;
+      }
+      uint64_t *slots = nullptr;
+      if (count != 0 && !resolveIndirectRange(address, count, IrSlotBytes, locals, heap, slots, error)) {
+        return false;
+      }
+      // Bytes live one per slot; stage them through a fixed chunk so large
+      // ranges never allocate.
+      std::array<uint8_t, 4096> chunk{};
+      uint32_t err = 0;
+      for (uint64_t offset = 0; offset < count && err == 0; offset += chunk.size()) {
+        const size_t size = static_cast<size_t>(std::min<uint64_t>(chunk.size(), count - offset));
+        uint64_t *chunkSlots = slots + offset;
+        if (isRead) {
+          size_t readCount = 0;
+          err = files.read(fd, chunk.data(), size, readCount);
+          for (size_t i = 0; i < readCount; ++i) {
+            chunkSlots[i] = static_cast<uint64_t>(chunk[i]);
+          }
+        } else {
+          for (size_t i = 0; i < size; ++i) {
+            chunk[i] = static_cast<uint8_t>(chunkSlots[i] & 0xffu);
+          }
+          err = files.write(fd, chunk.data(), size);
+        }
+      }
+      stack.push_back(static_cast<uint64_t>(err));
+      return true;
+    }
     case IrOpcode::FileFlush: {
       uint64_t handle = 0;
       if (!popStackValue(stack, "IR stack underflow on file flush", error, handle)) {
         return false;
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
-      const int rc = ::fsync(fd);
-      stack.push_back((rc < 0) ? static_cast<uint64_t>(currentIoErrorCode()) : 0u);
+      stack.push_back(static_cast<uint64_t>(files.flush(fd)));
       return true;
     }
     case IrOpcode::FileWriteI32: {
@@ -264,7 +581,7 @@ bool handleFileOpcode(const IrModule &module,
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
       const std::string text = std::to_string(static_cast<int64_t>(static_cast<int32_t>(rawValue)));
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, text.data(), text.size())));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, text.data(), text.size())));
       return true;
     }
     case IrOpcode::FileWriteI64: {
@@ -275,7 +592,7 @@ bool handleFileOpcode(const IrModule &module,
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
       const std::string text = std::to_string(static_cast<int64_t>(rawValue));
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, text.data(), text.size())));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, text.data(), text.size())));
       return true;
     }
     case IrOpcode::FileWriteU64: {
@@ -286,7 +603,7 @@ bool handleFileOpcode(const IrModule &module,
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
       const std::string text = std::to_string(static_cast<unsigned long long>(rawValue));
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, text.data(), text.size())));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, text.data(), text.size())));
       return true;
     }
     case IrOpcode::FileWriteString: {
@@ -299,7 +616,7 @@ bool handleFileOpcode(const IrModule &module,
         return false;
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, text->data(), text->size())));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, text->data(), text->size())));
       return true;
     }
     case IrOpcode::FileWriteStringDynamic: {
@@ -313,7 +630,7 @@ bool handleFileOpcode(const IrModule &module,
         return false;
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, text->data(), text->size())));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, text->data(), text->size())));
       return true;
     }
     case IrOpcode::FileWriteByte: {
@@ -324,7 +641,7 @@ bool handleFileOpcode(const IrModule &module,
       }
       const uint8_t value = static_cast<uint8_t>(rawValue & 0xffu);
       const int fd = static_cast<int>(handle & 0xffffffffu);
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, &value, 1)));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, &value, 1)));
       return true;
     }
     case IrOpcode::FileWriteNewline: {
@@ -334,7 +651,7 @@ bool handleFileOpcode(const IrModule &module,
       }
       const int fd = static_cast<int>(handle & 0xffffffffu);
       const char newline = '\n';
-      stack.push_back(static_cast<uint64_t>(writeAll(fd, &newline, 1)));
+      stack.push_back(static_cast<uint64_t>(files.write(fd, &newline, 1)));
       return true;
     }
     default:
@@ -1,13 +1,25 @@
 #pragma once
 
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "primec/Vm.h"
+#include "primec/VmFileBuffers.h"
+#include "primec/VmHeap.h"
 
 namespace primec::vm_detail {
 
+// `LoadIndirect` for every address kind: locals, heap slots, and read-only
+// `FileMapBytes` views.
+bool loadIndirectValue(uint64_t address,
+                       std::span<uint64_t> locals,
+                       VmHeap &heap,
+                       const VmFileBuffers &files,
+                       uint64_t &valueOut,
+                       std::string &error);
+
 bool handlePrintOpcode(const IrModule &module,
                        const IrInstruction &inst,
                        std::vector<uint64_t> &stack,
@@ -17,7 +29,9 @@ bool handlePrintOpcode(const IrModule &module,
 bool handleFileOpcode(const IrModule &module,
                       const IrInstruction &inst,
                       std::vector<uint64_t> &stack,
-                      std::vector<uint64_t> &locals,
+                      std::span<uint64_t> locals,
+                      VmHeap &heap,
+                      VmFileBuffers &files,
                       std::string &error);
 
 } // namespace primec::vm_detail
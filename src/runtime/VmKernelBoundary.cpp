@@ -81,6 +81,10 @@ bool isPureNumericOpcode(IrOpcode op) {
   case IrOpcode::ConvertF64ToU64:
   case IrOpcode::ConvertF32ToF64:
   case IrOpcode::ConvertF64ToF32:
+  case IrOpcode::MathUnaryF32:
+  case IrOpcode::MathUnaryF64:
+  case IrOpcode::MathBinaryF32:
+  case IrOpcode::MathBinaryF64:
     return true;
   default:
     return false;
@@ -512,6 +516,33 @@ PureOpcodeResult executePureNumericOpcode(const IrInstruction &inst,
     stack.push_back(f32ToBits(out));
     return PureOpcodeResult::Continue;
   }
+  case IrOpcode::MathUnaryF32:
+  case IrOpcode::MathUnaryF64:
+  case IrOpcode::MathBinaryF32:
+  case IrOpcode::MathBinaryF64: {
+    const bool isBinary = inst.op == IrOpcode::MathBinaryF32 || inst.op == IrOpcode::MathBinaryF64;
+    if (!isValidIrMathFunctionImm(inst.op, inst.imm)) {
+      error = "invalid math function in IR";
+      return PureOpcodeResult::Fault;
+    }
+    if (stack.size() < (isBinary ? 2u : 1u)) {
+      error = "IR stack underflow on math";
+      return PureOpcodeResult::Fault;
+    }
+    const IrMathFunction fn = static_cast<IrMathFunction>(inst.imm);
+    const std::uint64_t rhs = isBinary ? stack.back() : 0;
+    if (isBinary) {
+      stack.pop_back();
+    }
+    const std::uint64_t lhs = stack.back();
+    stack.pop_back();
+    if (inst.op == IrOpcode::MathUnaryF32 || inst.op == IrOpcode::MathBinaryF32) {
+      stack.push_back(f32ToBits(applyMathFunction(fn, bitsToF32(lhs), bitsToF32(rhs))));
+    } else {
+      stack.push_back(f64ToBits(applyMathFunction(fn, bitsToF64(lhs), bitsToF64(rhs))));
+    }
+    return PureOpcodeResult::Continue;
+  }
   default:
     return PureOpcodeResult::NotHandled;
   }
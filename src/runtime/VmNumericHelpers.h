@@ -1,5 +1,8 @@
 #pragma once
 
+#include "primec/Ir.h"
+
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 
@@ -30,4 +33,31 @@ inline uint64_t f64ToBits(double value) {
   return bits;
 }
 
+template <typename T>
+inline T applyMathFunction(IrMathFunction fn, T value, T exponent = T{}) {
+  switch (fn) {
+  case IrMathFunction::Sqrt:
+    return std::sqrt(value);
+  case IrMathFunction::Sin:
+    return std::sin(value);
+  case IrMathFunction::Cos:
+    return std::cos(value);
+  case IrMathFunction::Tan:
+    return std::tan(value);
+  case IrMathFunction::Exp:
+    return std::exp(value);
+  case IrMathFunction::Exp2:
+    return std::exp2(value);
+  case IrMathFunction::Log:
+    return std::log(value);
+  case IrMathFunction::Log2:
+    return std::log2(value);
+  case IrMathFunction::Log10:
+    return std::log10(value);
+  case IrMathFunction::Pow:
+    return std::pow(value, exponent);
+  }
+  return value;
+}
+
 } // namespace primec
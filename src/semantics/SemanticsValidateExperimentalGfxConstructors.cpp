@@ -132,6 +132,12 @@ bool rewriteExperimentalGfxConstructors(Program &program, std::string &error) {
     if (methodName == "writeBytes") {
       return std::string("write_bytes");
     }
+    if (methodName == "readBytes") {
+      return std::string("read_bytes");
+    }
+    if (methodName == "mapBytes") {
+      return std::string("map_bytes");
+    }
     return methodName;
   };
   auto resolveIndexedArgsPackElementTypeText =
@@ -411,6 +417,22 @@ bool rewriteExperimentalGfxConstructors(Program &program, std::string &error) {
         expr.templateArgs.clear();
         return true;
       }
+      if ((expr.name == "/File/read_bytes" || expr.name == "/File/readBytes") &&
+          hasImportedDefinitionPath("/File/read_bytes")) {
+        expr.isMethodCall = true;
+        expr.name = "read_bytes";
+        expr.namespacePrefix.clear();
+        expr.templateArgs.clear();
+        return true;
+      }
+      if ((expr.name == "/File/map_bytes" || expr.name == "/File/mapBytes") &&
+          hasImportedDefinitionPath("/File/map_bytes")) {
+        expr.isMethodCall = true;
+        expr.name = "map_bytes";
+        expr.namespacePrefix.clear();
+        expr.templateArgs.clear();
+        return true;
+      }
       if (expr.name == "/File/flush" && hasImportedDefinitionPath("/File/flush")) {
         expr.isMethodCall = true;
         expr.name = "flush";
@@ -59,6 +59,12 @@ std::string_view normalizeFileLateFallbackMethodName(std::string_view methodName
   if (methodName == "writeBytes") {
     return "write_bytes";
   }
+  if (methodName == "readBytes") {
+    return "read_bytes";
+  }
+  if (methodName == "mapBytes") {
+    return "map_bytes";
+  }
   return methodName;
 }
 
@@ -318,7 +324,9 @@ bool SemanticsValidator::validateExprLateUnknownTargetFallbacks(
   if (expr.isMethodCall &&
       (normalizedFileMethodName == "write" || normalizedFileMethodName == "write_line" ||
        normalizedFileMethodName == "write_byte" || normalizedFileMethodName == "read_byte" ||
-       normalizedFileMethodName == "write_bytes" || normalizedFileMethodName == "flush" ||
+       normalizedFileMethodName == "write_bytes" || normalizedFileMethodName == "read_bytes" ||
+       normalizedFileMethodName == "map_bytes" ||
+       normalizedFileMethodName == "flush" ||
        normalizedFileMethodName == "close") &&
       !expr.args.empty()) {
     auto normalizedTypeLeafName = [](std::string value) {
@@ -26,6 +26,12 @@ std::string_view normalizeFileMethodLeaf(std::string_view methodName) {
   if (methodName == "writeBytes") {
     return "write_bytes";
   }
+  if (methodName == "readBytes") {
+    return "read_bytes";
+  }
+  if (methodName == "mapBytes") {
+    return "map_bytes";
+  }
   return methodName;
 }
 
@@ -33,7 +39,8 @@ bool isFileBuiltinMethodLeaf(std::string_view methodName) {
   methodName = normalizeFileMethodLeaf(methodName);
   return methodName == "write" || methodName == "write_line" ||
          methodName == "write_byte" || methodName == "read_byte" ||
-         methodName == "write_bytes" || methodName == "flush" ||
+         methodName == "write_bytes" || methodName == "read_bytes" || methodName == "map_bytes" ||
+         methodName == "flush" ||
          methodName == "close";
 }
 
@@ -157,8 +157,10 @@ bool isFileMethodName(std::string_view methodName) {
   return methodName == "write" || methodName == "writeLine" ||
          methodName == "write_line" || methodName == "writeByte" ||
          methodName == "write_byte" || methodName == "readByte" ||
-         methodName == "read_byte" || methodName == "writeBytes" ||
-         methodName == "write_bytes" || methodName == "flush" ||
+         methodName == "read_byte" || methodName == "writeBytes" || methodName == "readBytes" ||
+         methodName == "mapBytes" ||
+         methodName == "write_bytes" || methodName == "read_bytes" || methodName == "map_bytes" ||
+         methodName == "flush" ||
          methodName == "close";
 }
 
@@ -18,6 +18,12 @@ std::string_view normalizeFileBuiltinHelperName(std::string_view helperName) {
   if (helperName == "writeBytes") {
     return "write_bytes";
   }
+  if (helperName == "readBytes") {
+    return "read_bytes";
+  }
+  if (helperName == "mapBytes") {
+    return "map_bytes";
+  }
   return helperName;
 }
 
@@ -321,7 +327,9 @@ bool SemanticsValidator::validateExprResultFileBuiltins(
     if (expr.args.empty()) {
       return failResultFileDiagnostic("file method missing receiver");
     }
-    const bool requiresRead = fileHelperName == "read_byte" || fileHelperName == "close";
+    const bool requiresRead =
+        fileHelperName == "read_byte" || fileHelperName == "read_bytes" || fileHelperName == "map_bytes" ||
+        fileHelperName == "close";
     const char *requiredEffect = requiresRead ? "file_read" : "file_write";
     if (currentValidationState_.context.activeEffects.count(requiredEffect) == 0) {
       return failResultFileDiagnostic(std::string("file operations require ") + requiredEffect +
@@ -499,6 +507,29 @@ bool SemanticsValidator::validateExprResultFileBuiltins(
       }
       return true;
     }
+    if (fileHelperName == "read_bytes" || fileHelperName == "map_bytes") {
+      handledOut = true;
+      if (expr.args.size() != 2) {
+        return failResultFileDiagnostic(fileHelperName + " requires exactly one argument");
+      }
+      if (!validateExpr(params, locals, expr.args[1])) {
+        return false;
+      }
+      if (expr.args[1].kind != Expr::Kind::Name || !isMutableBinding(expr.args[1].name)) {
+        return failResultFileDiagnostic(fileHelperName + " requires mutable array binding");
+      }
+      bool ok = false;
+      if (const BindingInfo *paramBinding = findParamBinding(params, expr.args[1].name)) {
+        ok = (paramBinding->typeName == "array");
+      } else {
+        auto itLocal = locals.find(expr.args[1].name);
+        ok = (itLocal != locals.end() && itLocal->second.typeName == "array");
+      }
+      if (!ok) {
+        return failResultFileDiagnostic(fileHelperName + " requires mutable array binding");
+      }
+      return true;
+    }
     if (fileHelperName == "flush" || fileHelperName == "close") {
       handledOut = true;
       if (expr.args.size() != 1) {
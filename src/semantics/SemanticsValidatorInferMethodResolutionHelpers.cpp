@@ -119,6 +119,12 @@ std::string_view normalizeFileHelperName(std::string_view helperName) {
   if (helperName == "writeBytes") {
     return "write_bytes";
   }
+  if (helperName == "readBytes") {
+    return "read_bytes";
+  }
+  if (helperName == "mapBytes") {
+    return "map_bytes";
+  }
   return helperName;
 }
 
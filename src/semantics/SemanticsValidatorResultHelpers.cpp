@@ -180,6 +180,12 @@ std::string_view normalizeFileResultMethodName(std::string_view methodName) {
   if (methodName == "writeBytes") {
     return "write_bytes";
   }
+  if (methodName == "readBytes") {
+    return "read_bytes";
+  }
+  if (methodName == "mapBytes") {
+    return "map_bytes";
+  }
   return methodName;
 }
 
@@ -933,7 +939,9 @@ bool SemanticsValidator::resolveResultTypeForExpr(const Expr &expr,
         std::string(normalizeFileResultMethodName(expr.name));
     if (normalizedMethodName == "write" || normalizedMethodName == "write_line" ||
         normalizedMethodName == "write_byte" || normalizedMethodName == "read_byte" ||
-        normalizedMethodName == "write_bytes" || normalizedMethodName == "flush" ||
+        normalizedMethodName == "write_bytes" || normalizedMethodName == "read_bytes" ||
+        normalizedMethodName == "map_bytes" ||
+        normalizedMethodName == "flush" ||
         normalizedMethodName == "close") {
       out.isResult = true;
       out.hasValue = false;
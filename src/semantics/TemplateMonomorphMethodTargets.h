@@ -43,8 +43,10 @@ bool resolveMethodCallTemplateTarget(const Expr &expr,
     return methodName == "write" || methodName == "writeLine" ||
            methodName == "write_line" || methodName == "writeByte" ||
            methodName == "write_byte" || methodName == "readByte" ||
-           methodName == "read_byte" || methodName == "writeBytes" ||
-           methodName == "write_bytes" || methodName == "flush" ||
+           methodName == "read_byte" || methodName == "writeBytes" || methodName == "readBytes" ||
+           methodName == "mapBytes" ||
+           methodName == "write_bytes" || methodName == "read_bytes" || methodName == "map_bytes" ||
+           methodName == "flush" ||
            methodName == "close";
   };
   auto normalizeFileMethodName = [](std::string_view methodName) {
@@ -60,6 +62,12 @@ bool resolveMethodCallTemplateTarget(const Expr &expr,
     if (methodName == "writeBytes") {
       return std::string("write_bytes");
     }
+    if (methodName == "readBytes") {
+      return std::string("read_bytes");
+    }
+    if (methodName == "mapBytes") {
+      return std::string("map_bytes");
+    }
     return std::string(methodName);
   };
   auto normalizeFileErrorMethodName = [](std::string_view methodName) {
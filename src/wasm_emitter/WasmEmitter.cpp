@@ -68,11 +68,13 @@ constexpr uint8_t WasmOpF32Sub = 0x93;
 constexpr uint8_t WasmOpF32Mul = 0x94;
 constexpr uint8_t WasmOpF32Div = 0x95;
 constexpr uint8_t WasmOpF32Neg = 0x8c;
+constexpr uint8_t WasmOpF32Sqrt = 0x91;
 constexpr uint8_t WasmOpF64Add = 0xa0;
 constexpr uint8_t WasmOpF64Sub = 0xa1;
 constexpr uint8_t WasmOpF64Mul = 0xa2;
 constexpr uint8_t WasmOpF64Div = 0xa3;
 constexpr uint8_t WasmOpF64Neg = 0x9a;
+constexpr uint8_t WasmOpF64Sqrt = 0x9f;
 constexpr uint8_t WasmOpI32TruncF32S = 0xa8;
 constexpr uint8_t WasmOpI32TruncF64S = 0xaa;
 constexpr uint8_t WasmOpI64TruncF32S = 0xae;
@@ -269,6 +271,24 @@ bool emitSimpleInstructionImpl(const IrInstruction &inst,
     case IrOpcode::NegF64:
       out.push_back(WasmOpF64Neg);
       return true;
+    case IrOpcode::MathUnaryF32:
+    case IrOpcode::MathUnaryF64:
+    case IrOpcode::MathBinaryF32:
+    case IrOpcode::MathBinaryF64: {
+      if (!isValidIrMathFunctionImm(inst.op, inst.imm)) {
+        error = "wasm emitter invalid math function in function: " + functionName;
+        return false;
+      }
+      const bool isF64 = inst.op == IrOpcode::MathUnaryF64 || inst.op == IrOpcode::MathBinaryF64;
+      const IrMathFunction fn = static_cast<IrMathFunction>(inst.imm);
+      if (fn == IrMathFunction::Sqrt) {
+        out.push_back(isF64 ? WasmOpF64Sqrt : WasmOpF32Sqrt);
+        return true;
+      }
+      out.push_back(WasmOpCall);
+      appendU32Leb(runtime.mathImportIndexes[wasmMathImportSlot(isF64, fn)], out);
+      return true;
+    }
     case IrOpcode::CmpEqF32:
       out.push_back(WasmOpF32Eq);
       return true;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -18,6 +19,8 @@ inline constexpr uint8_t WasmSectionMemory = 5;
 inline constexpr uint8_t WasmSectionExport = 7;
 inline constexpr uint8_t WasmSectionCode = 10;
 inline constexpr uint8_t WasmSectionData = 11;
+inline constexpr size_t WasmMathFunctionCount = static_cast<size_t>(IrMathFunction::Pow) + 1;
+inline constexpr char WasmMathImportModule[] = "primestruct_math";
 
 struct WasmFunctionType {
   std::vector<uint8_t> params;
@@ -94,6 +97,9 @@ struct WasmRuntimeContext {
   uint32_t fdCloseImportIndex = 0;
   uint32_t fdSyncImportIndex = 0;
   uint32_t pathOpenImportIndex = 0;
+  // Imported host math functions, f32 entries first; only meaningful for
+  // (precision, function) pairs some MathUnary/MathBinary instruction uses.
+  std::array<uint32_t, 2 * WasmMathFunctionCount> mathImportIndexes{};
   uint32_t argcAddr = 0;
   uint32_t argvBufSizeAddr = 0;
   uint32_t nwrittenAddr = 0;
@@ -206,6 +212,17 @@ bool buildWasiRuntimeContext(const IrModule &module,
                              WasmRuntimeContext &runtime,
                              std::string &error);
 
+// Imports every non-sqrt math function the module uses from
+// `WasmMathImportModule`; sqrt lowers to the native f32/f64.sqrt instruction.
+void appendMathImports(const IrModule &module,
+                       std::vector<WasmImport> &imports,
+                       std::vector<WasmFunctionType> &types,
+                       WasmRuntimeContext &runtime);
+
+inline size_t wasmMathImportSlot(bool isF64, IrMathFunction fn) {
+  return (isF64 ? WasmMathFunctionCount : 0) + static_cast<size_t>(fn);
+}
+
 void emitWasiWritePtrLen(uint32_t fd,
                          uint32_t ptrLocal,
                          uint32_t lenLocal,
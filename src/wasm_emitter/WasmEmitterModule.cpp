@@ -119,9 +119,8 @@ bool WasmEmitter::emitModule(const IrModule &module, std::vector<uint8_t> &out,
   if (!buildWasiRuntimeContext(module, imports, types, runtime, error)) {
     return false;
   }
-  if (!runtime.enabled) {
-    runtime.functionIndexOffset = 0;
-  }
+  appendMathImports(module, imports, types, runtime);
+  runtime.functionIndexOffset = static_cast<uint32_t>(imports.size());
 
   std::vector<uint32_t> functionTypeIndexes;
   std::vector<WasmCodeBody> codeBodies;
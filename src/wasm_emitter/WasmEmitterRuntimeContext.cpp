@@ -6,6 +6,8 @@ namespace {
 
 constexpr uint8_t WasmValueTypeI32 = 0x7f;
 constexpr uint8_t WasmValueTypeI64 = 0x7e;
+constexpr uint8_t WasmValueTypeF32 = 0x7d;
+constexpr uint8_t WasmValueTypeF64 = 0x7c;
 constexpr uint8_t WasmOpEnd = 0x0b;
 constexpr uint8_t WasmOpI32Const = 0x41;
 constexpr uint32_t WasmNumericScratchBytes = 32u;
@@ -210,4 +212,40 @@ bool buildWasiRuntimeContext(const IrModule &module,
   return true;
 }
 
+void appendMathImports(const IrModule &module,
+                       std::vector<WasmImport> &imports,
+                       std::vector<WasmFunctionType> &types,
+                       WasmRuntimeContext &runtime) {
+  std::array<bool, 2 * WasmMathFunctionCount> used{};
+  for (const IrFunction &function : module.functions) {
+    for (const IrInstruction &inst : function.instructions) {
+      const bool isF64 = inst.op == IrOpcode::MathUnaryF64 || inst.op == IrOpcode::MathBinaryF64;
+      const bool isMath = isF64 || inst.op == IrOpcode::MathUnaryF32 || inst.op == IrOpcode::MathBinaryF32;
+      if (!isMath || !isValidIrMathFunctionImm(inst.op, inst.imm) ||
+          inst.imm == static_cast<uint64_t>(IrMathFunction::Sqrt)) {
+        continue;
+      }
+      used[wasmMathImportSlot(isF64, static_cast<IrMathFunction>(inst.imm))] = true;
+    }
+  }
+  for (size_t slot = 0; slot < used.size(); ++slot) {
+    if (!used[slot]) {
+      continue;
+    }
+    const bool isF64 = slot >= WasmMathFunctionCount;
+    const IrMathFunction fn = static_cast<IrMathFunction>(slot % WasmMathFunctionCount);
+    const uint8_t valueType = isF64 ? WasmValueTypeF64 : WasmValueTypeF32;
+    WasmFunctionType mathType;
+    mathType.params.assign(fn == IrMathFunction::Pow ? 2 : 1, valueType);
+    mathType.results = {valueType};
+    std::string name = irMathFunctionName(fn);
+    if (!isF64) {
+      name += "f";
+    }
+    runtime.mathImportIndexes[slot] = static_cast<uint32_t>(imports.size());
+    imports.push_back({WasmMathImportModule, std::move(name), WasmFunctionKind, static_cast<uint32_t>(types.size())});
+    types.push_back(std::move(mathType));
+  }
+}
+
 } // namespace primec
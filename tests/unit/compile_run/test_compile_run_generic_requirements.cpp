@@ -500,4 +500,47 @@ main() {
   expectBackendsExit("recursion_mutual_is_even_odd", source, 1);
 }
 
+// Non-recursive helpers with struct parameters and 2+ call sites also lower
+// to one shared function; each struct argument crosses the call as its flat
+// run of slots, so mixed-width fields and repeated receivers must survive.
+TEST_CASE("multi-call-site struct-parameter helper runs as a shared function") {
+  const std::string source = R"(
+[struct]
+Particle() {
+  [i64] id{0i64}
+  [f64] mass{0.0f64}
+  [i32] charge{0i32}
+}
+
+[struct]
+Vec2() {
+  [i32] x{0i32}
+  [i32] y{0i32}
+}
+
+[return<i32>]
+score([Particle] p, [i32] bias) {
+  return(plus(plus(convert<i32>(p.id), p.charge), bias))
+}
+
+[return<i32>]
+dot([Vec2] a, [Vec2] b) {
+  return(plus(multiply(a.x, b.x), multiply(a.y, b.y)))
+}
+
+[return<int>]
+main() {
+  [Particle] a{Particle(7i64, 1.5f64, 3i32)}
+  [Particle] b{Particle(10i64, 2.5f64, -2i32)}
+  [Vec2] p{Vec2(2i32, 3i32)}
+  [Vec2] q{Vec2(4i32, 5i32)}
+  [i32] scores{plus(score(a, 1i32), plus(score(b, 2i32), score(a, 0i32)))}
+  [i32] dots{plus(dot(p, q), dot(q, Vec2(1i32, 1i32)))}
+  return(plus(scores, dots))
+}
+)";
+
+  expectBackendsExit("real_call_struct_parameters", source, 63);
+}
+
 TEST_SUITE_END();
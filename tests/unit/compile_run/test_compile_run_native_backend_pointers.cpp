@@ -229,6 +229,37 @@ main() {
   CHECK(runCommand(exePath) == 13);
 }
 
+TEST_CASE("native heap recycles zeroed blocks") {
+  const std::string source = R"(
+[return<int> effects(heap_alloc)]
+main() {
+  [i32 mut] i{0i32}
+  [i32 mut] total{0i32}
+  while(less_than(i, 20000i32)) {
+    [mut] ptr{/std/intrinsics/memory/alloc<i32>(3i32)}
+    assign(total, plus(total, dereference(plus(ptr, 32i32))))
+    assign(dereference(plus(ptr, 32i32)), 7i32)
+    /std/intrinsics/memory/free(ptr)
+    assign(i, plus(i, 1i32))
+  }
+  [mut] small{/std/intrinsics/memory/alloc<i32>(1i32)}
+  assign(dereference(small), 5i32)
+  [Pointer<i32> mut] grown{/std/intrinsics/memory/realloc(small, 6000i32)}
+  assign(dereference(plus(grown, 95984i32)), 11i32)
+  [Pointer<i32> mut] shrunk{/std/intrinsics/memory/realloc(grown, 2i32)}
+  [i32] sum{plus(total, dereference(shrunk))}
+  /std/intrinsics/memory/free(shrunk)
+  return(sum)
+}
+)";
+  const std::string srcPath = writeTemp("compile_native_heap_recycle.prime", source);
+  const std::string exePath = (testScratchPath("") / "primec_native_heap_recycle").string();
+
+  const std::string compileCmd = "./primec --emit=native " + srcPath + " -o " + exePath + " --entry /main";
+  CHECK(runCommand(compileCmd) == 0);
+  CHECK(runCommand(exePath) == 5);
+}
+
 TEST_CASE("native checked memory at intrinsic") {
   const std::string source = R"(
 [return<int> effects(heap_alloc)]
@@ -476,6 +476,9 @@ TEST_CASE("primec and primevm usage prefer text transforms and import flags") {
   CHECK(primecErr.find("[--wasm-profile wasi|browser]") != std::string::npos);
   CHECK(primecErr.find("[--text-transforms <list>]") != std::string::npos);
   CHECK(primecErr.find("[--ir-inline]") != std::string::npos);
+  CHECK(primecErr.find("[-O0|-O1|-O2] [--ir-opt-report]") != std::string::npos);
+  CHECK(primecErr.find("[--vm-engine checked|fast]") != std::string::npos);
+  CHECK(primecErr.find("[--native-codegen stack|regalloc]") != std::string::npos);
   CHECK(primecErr.find("--text-filters <list>") == std::string::npos);
 
   CHECK(runCommand("./primevm --unknown-option 2> " + quoteShellArg(primevmErrPath)) == 2);
@@ -484,6 +487,8 @@ TEST_CASE("primec and primevm usage prefer text transforms and import flags") {
   CHECK(primevmErr.find("[--import-path <dir>] [-I <dir>]") != std::string::npos);
   CHECK(primevmErr.find("[--text-transforms <list>]") != std::string::npos);
   CHECK(primevmErr.find("[--ir-inline]") != std::string::npos);
+  CHECK(primevmErr.find("[-O0|-O1|-O2] [--ir-opt-report]") != std::string::npos);
+  CHECK(primevmErr.find("[--vm-engine checked|fast]") != std::string::npos);
   CHECK(primevmErr.find("[--debug-json]") != std::string::npos);
   CHECK(primevmErr.find("[--debug-json-snapshots [none|stop|all]]") != std::string::npos);
   CHECK(primevmErr.find("[--debug-trace <path>]") != std::string::npos);
@@ -511,6 +516,64 @@ main() {
   CHECK(runCommand(runVmCmd) == 7);
 }
 
+TEST_CASE("primec and primevm accept vm engine flag") {
+  const std::string source = R"(
+[return<int>]
+main() {
+  return(7i32)
+}
+)";
+  const std::string srcPath = writeTemp("vm_engine_flag.prime", source);
+  const std::string errPath = (testScratchPath("") / "vm_engine_flag_err.txt").string();
+
+  CHECK(runCommand("./primevm " + srcPath + " --entry /main --vm-engine fast") == 7);
+  CHECK(runCommand("./primevm " + srcPath + " --entry /main --vm-engine=checked") == 7);
+  CHECK(runCommand("./primec --emit=vm " + srcPath + " --entry /main --vm-engine=fast") == 7);
+  CHECK(runCommand("./primevm " + srcPath + " --entry /main --vm-engine turbo 2> " + errPath) == 2);
+  CHECK(readFile(errPath).find("unsupported --vm-engine value: turbo (expected checked|fast)") !=
+        std::string::npos);
+}
+
+TEST_CASE("primec native codegen flag selects register allocation") {
+  const std::string source = R"(
+[return<int>]
+square([i32] value) {
+  return(multiply(value, value))
+}
+
+[return<int>]
+main() {
+  [i32 mut] i{0i32}
+  [i32 mut] total{0i32}
+  while(less_than(i, 10i32)) {
+    if(equal(divide(i, 2i32), 2i32)) {
+      assign(total, plus(total, square(i)))
+    } else {
+      assign(total, plus(total, i))
+    }
+    assign(i, plus(i, 1i32))
+  }
+  return(total)
+}
+)";
+  const std::string srcPath = writeTemp("native_codegen_flag.prime", source);
+  const std::string stackExePath = (testScratchPath("") / "primec_native_codegen_stack").string();
+  const std::string regallocExePath = (testScratchPath("") / "primec_native_codegen_regalloc").string();
+  const std::string errPath = (testScratchPath("") / "native_codegen_flag_err.txt").string();
+
+  CHECK(runCommand("./primec --emit=native " + srcPath + " -o " + stackExePath +
+                   " --entry /main --native-codegen stack") == 0);
+  CHECK(runCommand("./primec --emit=native " + srcPath + " -o " + regallocExePath +
+                   " --entry /main --native-codegen=regalloc") == 0);
+  CHECK(runCommand(stackExePath) == 77);
+  CHECK(runCommand(regallocExePath) == 77);
+  CHECK(runCommand("./primevm " + srcPath + " --entry /main") == 77);
+  CHECK(runCommand("./primec --emit=native " + srcPath + " -o " + regallocExePath +
+                   " --entry /main --native-codegen registers 2> " + errPath) == 2);
+  CHECK(readFile(errPath).find("unsupported --native-codegen value: registers (expected stack|regalloc)") !=
+        std::string::npos);
+}
+
 TEST_CASE("primevm accepts explicit emit vm compatibility flag") {
   const std::string source = R"(
 [return<int>]
@@ -294,6 +294,49 @@ TEST_CASE("primec options default to wasm extension for emit kind") {
   CHECK(options.outputPath == "compile_default_wasm_output.wasm");
 }
 
+TEST_CASE("primec options parse optimization levels") {
+  auto parsePrimec = [](std::vector<std::string> args, primec::Options &options, std::string &error) {
+    std::vector<char *> argv;
+    argv.reserve(args.size());
+    for (std::string &arg : args) {
+      argv.push_back(arg.data());
+    }
+    return primec::parseOptions(
+        static_cast<int>(argv.size()), argv.data(), primec::OptionsParserMode::Primec, options, error);
+  };
+
+  {
+    primec::Options options;
+    std::string error;
+    CHECK(parsePrimec({"primec", "--emit=vm", "/tmp/input.prime"}, options, error));
+    CHECK(options.optimizationLevel == 0u);
+    CHECK_FALSE(options.irOptimizationReport);
+  }
+
+  {
+    primec::Options options;
+    std::string error;
+    CHECK(parsePrimec({"primec", "--emit=vm", "-O2", "--ir-opt-report", "/tmp/input.prime"}, options, error));
+    CHECK(error.empty());
+    CHECK(options.optimizationLevel == 2u);
+    CHECK(options.irOptimizationReport);
+  }
+
+  {
+    primec::Options options;
+    std::string error;
+    CHECK(parsePrimec({"primec", "--emit=vm", "-O2", "-O", "/tmp/input.prime"}, options, error));
+    CHECK(options.optimizationLevel == 1u);
+  }
+
+  {
+    primec::Options options;
+    std::string error;
+    CHECK_FALSE(parsePrimec({"primec", "--emit=vm", "-O3", "/tmp/input.prime"}, options, error));
+    CHECK(error.find("unsupported optimization level: -O3 (expected -O0|-O1|-O2)") != std::string::npos);
+  }
+}
+
 TEST_CASE("primec options parse wasm profile aliases and validate values") {
   auto parsePrimec = [](std::vector<std::string> args, primec::Options &options, std::string &error) {
     std::vector<char *> argv;
@@ -22,6 +22,7 @@
 #include "primec/IrLowerer.h"
 #include "primec/IrPreparation.h"
 #include "primec/SemanticValidationPlan.h"
+#include "primec/Vm.h"
 #include "primec/semantic_product/DirectCallFacts.h"
 #include "primec/semantic_product/MethodCallFacts.h"
 #include "primec/testing/CompilePipelineDumpHelpers.h"
@@ -527,7 +528,7 @@ TEST_CASE("all production primec emit kinds route through ir backend resolution"
 
 TEST_CASE("ir preparation phase manifest pins ordered handoffs") {
   const auto &manifest = primec::irPreparationPhaseManifest();
-  REQUIRE(manifest.size() == 6);
+  REQUIRE(manifest.size() == 8);
 
   std::vector<std::string_view> names;
   names.reserve(manifest.size());
@@ -544,6 +545,8 @@ TEST_CASE("ir preparation phase manifest pins ordered handoffs") {
       "validate-lowered-ir",
       "inline-ir-calls",
       "validate-inlined-ir",
+      "optimize-ir",
+      "validate-optimized-ir",
       "release-lowered-ast-bodies",
   };
   CHECK(names == expectedNames);
@@ -688,6 +691,65 @@ main() {
                     }));
 }
 
+TEST_CASE("ir preparation optimizes the module when an optimization level is set") {
+  const std::filesystem::path tempPath = makeTempIrPipelineSourcePath();
+  {
+    std::ofstream file(tempPath);
+    REQUIRE(file.good());
+    file << R"(
+[return<i32>]
+main() {
+  [i32 mut] value{6i32}
+  [i32] scale{7i32}
+  assign(value, multiply(value, scale))
+  if(less_than(scale, 2i32)) {
+    return(1i32)
+  }
+  return(value)
+}
+)";
+  }
+
+  auto prepare = [&](uint32_t level, primec::IrModule &ir) {
+    primec::Options options;
+    options.inputPath = tempPath.string();
+    options.entryPath = "/main";
+    options.emitKind = "vm";
+    options.optimizationLevel = level;
+    primec::addDefaultStdlibInclude(options.inputPath, options.importPaths);
+
+    primec::CompilePipelineOutput output;
+    primec::CompilePipelineErrorStage errorStage = primec::CompilePipelineErrorStage::None;
+    std::string error;
+    REQUIRE(primec::runCompilePipeline(options, output, errorStage, error));
+    primec::IrPreparationFailure failure;
+    REQUIRE(primec::prepareIrModule(
+        output.program, &output.semanticProgram, options, primec::IrValidationTarget::Vm, ir, failure));
+    CHECK(failure.stage == primec::IrPreparationFailureStage::None);
+  };
+
+  primec::IrModule unoptimized;
+  primec::IrModule optimized;
+  prepare(0, unoptimized);
+  prepare(2, optimized);
+  std::error_code ec;
+  std::filesystem::remove(tempPath, ec);
+
+  REQUIRE(optimized.entryIndex >= 0);
+  const auto &unoptimizedEntry = unoptimized.functions[static_cast<size_t>(unoptimized.entryIndex)];
+  const auto &optimizedEntry = optimized.functions[static_cast<size_t>(optimized.entryIndex)];
+  CHECK(optimizedEntry.instructions.size() < unoptimizedEntry.instructions.size());
+
+  primec::Vm vm;
+  std::string error;
+  uint64_t unoptimizedResult = 0;
+  uint64_t optimizedResult = 0;
+  REQUIRE(vm.execute(unoptimized, unoptimizedResult, error));
+  REQUIRE(vm.execute(optimized, optimizedResult, error));
+  CHECK(unoptimizedResult == 42u);
+  CHECK(optimizedResult == unoptimizedResult);
+}
+
 TEST_CASE("semantic-product contract rejects missing local-auto facts across entry targets") {
   const std::string source =
       "[return<T>]\n"
@@ -60,6 +60,18 @@ primec::Expr makeTryCall(primec::Expr inner) {
   return call;
 }
 
+primec::Definition makeStructDef(const std::string &fullPath,
+                                 const std::vector<std::pair<std::string, std::string>> &fields) {
+  primec::Definition def = makeDef(fullPath);
+  primec::Transform structTransform;
+  structTransform.name = "struct";
+  def.transforms.push_back(structTransform);
+  for (const auto &[name, typeName] : fields) {
+    def.statements.push_back(makeScalarParam(name, typeName));
+  }
+  return def;
+}
+
 void addReturnTransform(primec::Definition &def, const std::string &typeName) {
   primec::Transform returnTransform;
   returnTransform.name = "return";
@@ -372,4 +384,56 @@ TEST_CASE("eligibility rejects a recursive definition using try") {
   CHECK(eligible.empty());
 }
 
+TEST_CASE("eligibility accepts a multi-call-site slot-copyable struct parameter") {
+  primec::Program program;
+  primec::Definition entry = makeDef("/main/entry");
+  entry.statements.push_back(makeCall("/main/length_sq"));
+  entry.statements.push_back(makeCall("/main/length_sq"));
+  primec::Definition inner = makeStructDef("/main/Inner", {{"w", "f64"}});
+  primec::Definition vec = makeStructDef("/main/Vec2", {{"x", "i32"}, {"y", "i32"}, {"inner", "Inner"}});
+  primec::Definition lengthSq = makeDef("/main/length_sq");
+  lengthSq.namespacePrefix = "/main";
+  lengthSq.parameters.push_back(makeScalarParam("v", "Vec2"));
+  addReturnTransform(lengthSq, "i32");
+  program.definitions = {entry, inner, vec, lengthSq};
+
+  const auto eligible = primec::ir_lowerer::computeRealCallEligibleDefinitionPaths(program, "/main/entry");
+  REQUIRE(eligible.size() == 1u);
+  CHECK(eligible.count("/main/length_sq") == 1u);
+}
+
+TEST_CASE("eligibility rejects struct parameters that own resources or bind this") {
+  primec::Program program;
+  primec::Definition entry = makeDef("/main/entry");
+  for (int i = 0; i < 2; ++i) {
+    entry.statements.push_back(makeCall("/main/consume"));
+    entry.statements.push_back(makeCall("/main/Plain/scaled"));
+    entry.statements.push_back(makeCall("/main/Plain/origin_distance"));
+  }
+  primec::Definition owner = makeStructDef("/main/Owner", {{"handle", "i64"}});
+  primec::Definition ownerDestroy = makeDef("/main/Owner/Destroy");
+  primec::Definition consume = makeDef("/main/consume");
+  consume.namespacePrefix = "/main";
+  consume.parameters.push_back(makeScalarParam("value", "Owner"));
+  primec::Definition plain = makeStructDef("/main/Plain", {{"x", "i32"}});
+  primec::Definition scaled = makeDef("/main/Plain/scaled");
+  scaled.namespacePrefix = "/main/Plain";
+  scaled.isNested = true;
+  scaled.parameters.push_back(makeScalarParam("factor", "i32"));
+  addReturnTransform(scaled, "i32");
+  primec::Definition originDistance = makeDef("/main/Plain/origin_distance");
+  originDistance.namespacePrefix = "/main/Plain";
+  originDistance.isNested = true;
+  primec::Transform staticTransform;
+  staticTransform.name = "static";
+  originDistance.transforms.push_back(staticTransform);
+  originDistance.parameters.push_back(makeScalarParam("point", "Plain"));
+  addReturnTransform(originDistance, "i32");
+  program.definitions = {entry, owner, ownerDestroy, consume, plain, scaled, originDistance};
+
+  const auto eligible = primec::ir_lowerer::computeRealCallEligibleDefinitionPaths(program, "/main/entry");
+  REQUIRE(eligible.size() == 1u);
+  CHECK(eligible.count("/main/Plain/origin_distance") == 1u);
+}
+
 TEST_SUITE_END();
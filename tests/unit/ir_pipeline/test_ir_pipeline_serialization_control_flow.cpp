@@ -17,6 +17,7 @@
 #include "primec/CompilePipeline.h"
 #include "primec/IrLowerer.h"
 #include "primec/IrInliner.h"
+#include "primec/IrOptimizer.h"
 #include "primec/IrBackends.h"
 #include "primec/IrPreparation.h"
 #include "primec/IrSerializer.h"
@@ -9,6 +9,7 @@ std::filesystem::path irSerializationControlFlowPath(const std::string &relative
 
 #include "test_ir_pipeline_serialization_control_flow_core.h"
 #include "test_ir_pipeline_serialization_control_flow_vregs.h"
+#include "test_ir_pipeline_serialization_control_flow_optimizer.h"
 #include "test_ir_pipeline_serialization_control_flow_spills.h"
 #include "test_ir_pipeline_serialization_control_flow_scheduler.h"
 #include "test_ir_pipeline_serialization_control_flow_verifier.h"
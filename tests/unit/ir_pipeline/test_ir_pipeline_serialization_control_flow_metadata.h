@@ -84,7 +84,7 @@ TEST_CASE("ir serialization schema golden fixture stays stable") {
       {102u, 11u, 3u, primec::IrSourceMapProvenance::SyntheticIr, "import.prime"});
 
   const std::vector<uint8_t> expected = {
-      0x52, 0x49, 0x53, 0x50, 0x17, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+      0x52, 0x49, 0x53, 0x50, 0x19, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
       0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
       0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x01, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
       0x00, 0x2f, 0x50, 0x61, 0x69, 0x72, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00,
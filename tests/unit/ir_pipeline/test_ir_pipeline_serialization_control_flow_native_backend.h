@@ -388,6 +388,89 @@ TEST_CASE("native backend cache toggle preserves dual-mode parity") {
   CHECK(cacheOnInstrumentation.totalReloadCount < cacheOffInstrumentation.totalReloadCount);
 }
 
+TEST_CASE("native backend register allocation preserves parity across blocks and calls") {
+  primec::IrModule module;
+  module.entryIndex = 0;
+
+  primec::IrFunction mainFn;
+  mainFn.name = "/main";
+  mainFn.instructions.push_back({primec::IrOpcode::PushI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::StoreLocal, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::PushI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::StoreLocal, 1});
+  mainFn.instructions.push_back({primec::IrOpcode::LoadLocal, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::PushI32, 10});
+  mainFn.instructions.push_back({primec::IrOpcode::CmpLtI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::JumpIfZero, 19});
+  mainFn.instructions.push_back({primec::IrOpcode::LoadLocal, 1});
+  mainFn.instructions.push_back({primec::IrOpcode::LoadLocal, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::Call, 1});
+  mainFn.instructions.push_back({primec::IrOpcode::AddI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::AddI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::StoreLocal, 1});
+  mainFn.instructions.push_back({primec::IrOpcode::LoadLocal, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::PushI32, 1});
+  mainFn.instructions.push_back({primec::IrOpcode::AddI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::StoreLocal, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::Jump, 4});
+  mainFn.instructions.push_back({primec::IrOpcode::LoadLocal, 1});
+  mainFn.instructions.push_back({primec::IrOpcode::Dup, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::PushI32, 50});
+  mainFn.instructions.push_back({primec::IrOpcode::CmpGtI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::JumpIfZero, 26});
+  mainFn.instructions.push_back({primec::IrOpcode::PushI32, 2});
+  mainFn.instructions.push_back({primec::IrOpcode::SubI32, 0});
+  mainFn.instructions.push_back({primec::IrOpcode::ReturnI32, 0});
+
+  // Eight simultaneously live values exceed the allocatable register set.
+  primec::IrFunction helperFn;
+  helperFn.name = "/helper";
+  for (uint64_t value = 1; value <= 8; ++value) {
+    helperFn.instructions.push_back({primec::IrOpcode::PushI32, value});
+  }
+  for (int add = 0; add < 7; ++add) {
+    helperFn.instructions.push_back({primec::IrOpcode::AddI32, 0});
+  }
+  helperFn.instructions.push_back({primec::IrOpcode::PushF32, 0x42040000u}); // 33.0f
+  helperFn.instructions.push_back({primec::IrOpcode::ConvertF32ToI32, 0});
+  helperFn.instructions.push_back({primec::IrOpcode::SubI32, 0});
+  helperFn.instructions.push_back({primec::IrOpcode::ReturnI32, 0});
+
+  module.functions.push_back(std::move(mainFn));
+  module.functions.push_back(std::move(helperFn));
+
+  primec::Vm vm;
+  uint64_t vmResult = 0;
+  std::string error;
+  REQUIRE(vm.execute(module, vmResult, error));
+  CHECK(error.empty());
+  CHECK(vmResult == 73u);
+
+  primec::NativeEmitter emitter;
+  primec::NativeEmitterOptions stackOptions;
+  primec::NativeEmitterOptions registerOptions;
+  registerOptions.enableRegisterAllocation = true;
+  primec::NativeEmitterInstrumentation stackInstrumentation;
+  primec::NativeEmitterInstrumentation registerInstrumentation;
+  const std::string stackPath = irSerializationControlFlowPath("primec_native_ir_regalloc_stack_exec").string();
+  const std::string registerPath = irSerializationControlFlowPath("primec_native_ir_regalloc_exec").string();
+  REQUIRE(emitter.emitExecutable(module, stackPath, error, &stackInstrumentation, stackOptions));
+  CHECK(error.empty());
+  REQUIRE(emitter.emitExecutable(module, registerPath, error, &registerInstrumentation, registerOptions));
+  CHECK(error.empty());
+
+  CHECK(runIrPipelineNativeBinary(stackPath) == static_cast<int>(vmResult));
+  CHECK(runIrPipelineNativeBinary(registerPath) == static_cast<int>(vmResult));
+
+  CHECK(stackInstrumentation.registerAllocatedFunctionCount == 0u);
+  CHECK(registerInstrumentation.registerAllocatedFunctionCount == 2u);
+  REQUIRE(registerInstrumentation.perFunction.size() == 2);
+  CHECK(registerInstrumentation.perFunction[0].registerAllocated);
+  CHECK(registerInstrumentation.perFunction[1].registerAllocated);
+  CHECK(registerInstrumentation.perFunction[1].spillCount > 0u);
+  CHECK(registerInstrumentation.totalValueStackPushCount < stackInstrumentation.totalValueStackPushCount);
+}
+
 TEST_CASE("native backend cache mode regression matrix covers branches and call depth") {
   struct CacheModeCase {
     std::string name;
@@ -0,0 +1,272 @@
+#pragma once
+
+namespace {
+size_t countIrOpcode(const primec::IrFunction &function, primec::IrOpcode op) {
+  return static_cast<size_t>(std::count_if(function.instructions.begin(),
+                                           function.instructions.end(),
+                                           [op](const primec::IrInstruction &inst) { return inst.op == op; }));
+}
+
+const primec::IrOptimizationPassStats *findIrOptimizationPass(const primec::IrOptimizationReport &report,
+                                                              std::string_view name) {
+  for (const auto &pass : report.passes) {
+    if (pass.name == name) {
+      return &pass;
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+TEST_CASE("ir optimizer folds propagated constants and prunes the dead branch") {
+  primec::IrModule module;
+  module.entryIndex = 0;
+  primec::IrFunction mainFn;
+  mainFn.name = "/main";
+  mainFn.instructions = {
+      {primec::IrOpcode::PushI32, 6},
+      {primec::IrOpcode::StoreLocal, 0},
+      {primec::IrOpcode::LoadLocal, 0},
+      {primec::IrOpcode::StoreLocal, 1},
+      {primec::IrOpcode::LoadLocal, 1},
+      {primec::IrOpcode::PushI32, 7},
+      {primec::IrOpcode::MulI32, 0},
+      {primec::IrOpcode::StoreLocal, 2},
+      {primec::IrOpcode::LoadLocal, 2},
+      {primec::IrOpcode::PushI32, 40},
+      {primec::IrOpcode::CmpGtI32, 0},
+      {primec::IrOpcode::JumpIfZero, 14},
+      {primec::IrOpcode::LoadLocal, 2},
+      {primec::IrOpcode::ReturnI32, 0},
+      {primec::IrOpcode::PushI32, 0},
+      {primec::IrOpcode::ReturnI32, 0},
+  };
+  module.functions.push_back(mainFn);
+
+  primec::Vm vm;
+  std::string error;
+  uint64_t baselineResult = 0;
+  REQUIRE(vm.execute(module, baselineResult, error));
+  CHECK(baselineResult == 42u);
+
+  primec::IrModule singleRound = module;
+  primec::IrOptimizationReport singleRoundReport;
+  REQUIRE(primec::optimizeIrModule(singleRound, 1, singleRoundReport, error));
+  CHECK(singleRoundReport.rounds == 1u);
+
+  primec::IrOptimizationReport report;
+  REQUIRE(primec::optimizeIrModule(module, 2, report, error));
+  CHECK(error.empty());
+  CHECK(report.stoppedReason.empty());
+  REQUIRE(primec::validateIrModule(module, primec::IrValidationTarget::Vm, error));
+
+  const auto &optimized = module.functions[0].instructions;
+  REQUIRE(optimized.size() == 2u);
+  CHECK(optimized[0].op == primec::IrOpcode::PushI32);
+  CHECK(optimized[0].imm == 42u);
+  CHECK(optimized[1].op == primec::IrOpcode::ReturnI32);
+  CHECK(singleRoundReport.instructionsAfter > report.instructionsAfter);
+
+  CHECK(report.instructionsBefore == 16u);
+  CHECK(report.instructionsAfter == 2u);
+  REQUIRE(report.passes.size() == 5u);
+  size_t removedAcrossPasses = 0;
+  for (const auto &pass : report.passes) {
+    CHECK(pass.runs == report.rounds);
+    removedAcrossPasses += pass.instructionsRemoved;
+  }
+  CHECK(removedAcrossPasses == report.instructionsBefore - report.instructionsAfter);
+  const auto *folding = findIrOptimizationPass(report, "constant-folding");
+  const auto *unreachable = findIrOptimizationPass(report, "unreachable-block-removal");
+  REQUIRE(folding != nullptr);
+  REQUIRE(unreachable != nullptr);
+  CHECK(folding->rewrites >= 2u);
+  CHECK(unreachable->instructionsRemoved == 2u);
+
+  uint64_t optimizedResult = 0;
+  REQUIRE(vm.execute(module, optimizedResult, error));
+  CHECK(optimizedResult == baselineResult);
+}
+
+TEST_CASE("ir optimizer keeps loop-carried locals and remaps jump targets") {
+  primec::IrModule module;
+  module.entryIndex = 0;
+  primec::IrFunction mainFn;
+  mainFn.name = "/main";
+  mainFn.instructions = {
+      {primec::IrOpcode::PushI32, 0},
+      {primec::IrOpcode::StoreLocal, 0},
+      {primec::IrOpcode::PushI32, 0},
+      {primec::IrOpcode::StoreLocal, 1},
+      {primec::IrOpcode::LoadLocal, 0},
+      {primec::IrOpcode::PushI32, 5},
+      {primec::IrOpcode::CmpLtI32, 0},
+      {primec::IrOpcode::JumpIfZero, 19},
+      {primec::IrOpcode::LoadLocal, 1},
+      {primec::IrOpcode::LoadLocal, 0},
+      {primec::IrOpcode::AddI32, 0},
+      {primec::IrOpcode::StoreLocal, 1},
+      {primec::IrOpcode::LoadLocal, 0},
+      {primec::IrOpcode::PushI32, 1},
+      {primec::IrOpcode::AddI32, 0},
+      {primec::IrOpcode::StoreLocal, 0},
+      {primec::IrOpcode::Jump, 4},
+      {primec::IrOpcode::PushI32, 99},
+      {primec::IrOpcode::ReturnI32, 0},
+      {primec::IrOpcode::LoadLocal, 1},
+      {primec::IrOpcode::ReturnI32, 0},
+  };
+  module.functions.push_back(mainFn);
+
+  primec::Vm vm;
+  std::string error;
+  uint64_t baselineResult = 0;
+  REQUIRE(vm.execute(module, baselineResult, error));
+  CHECK(baselineResult == 10u);
+
+  primec::IrOptimizationReport report;
+  REQUIRE(primec::optimizeIrModule(module, 2, report, error));
+  REQUIRE(primec::validateIrModule(module, primec::IrValidationTarget::Vm, error));
+  const primec::IrFunction &optimized = module.functions[0];
+  CHECK(optimized.instructions.size() == 19u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::PushI32) == 4u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::LoadLocal) == 5u);
+  REQUIRE(countIrOpcode(optimized, primec::IrOpcode::JumpIfZero) == 1u);
+  for (const auto &inst : optimized.instructions) {
+    CHECK(inst.imm != 99u);
+    if (inst.op == primec::IrOpcode::JumpIfZero) {
+      CHECK(inst.imm == 17u);
+    }
+  }
+
+  uint64_t optimizedResult = 0;
+  REQUIRE(vm.execute(module, optimizedResult, error));
+  CHECK(optimizedResult == baselineResult);
+}
+
+TEST_CASE("ir optimizer removes dead stores and store-load round trips") {
+  primec::IrModule module;
+  module.entryIndex = 0;
+  primec::IrFunction mainFn;
+  mainFn.name = "/main";
+  mainFn.instructions = {
+      {primec::IrOpcode::PushI32, 3},
+      {primec::IrOpcode::StoreLocal, 0},
+      {primec::IrOpcode::PushArgc, 0},
+      {primec::IrOpcode::StoreLocal, 0},
+      {primec::IrOpcode::LoadLocal, 0},
+      {primec::IrOpcode::PushI32, 1},
+      {primec::IrOpcode::AddI32, 0},
+      {primec::IrOpcode::Dup, 0},
+      {primec::IrOpcode::StoreLocal, 2},
+      {primec::IrOpcode::LoadLocal, 3},
+      {primec::IrOpcode::StoreLocal, 3},
+      {primec::IrOpcode::StoreLocal, 1},
+      {primec::IrOpcode::LoadLocal, 1},
+      {primec::IrOpcode::ReturnI32, 0},
+  };
+  module.functions.push_back(mainFn);
+
+  primec::Vm vm;
+  std::string error;
+  uint64_t baselineResult = 0;
+  REQUIRE(vm.execute(module, baselineResult, error, 2));
+
+  primec::IrOptimizationReport report;
+  REQUIRE(primec::optimizeIrModule(module, 2, report, error));
+  REQUIRE(primec::validateIrModule(module, primec::IrValidationTarget::Vm, error));
+  const auto &optimized = module.functions[0].instructions;
+  REQUIRE(optimized.size() == 4u);
+  CHECK(optimized[0].op == primec::IrOpcode::PushArgc);
+  CHECK(optimized[1].op == primec::IrOpcode::PushI32);
+  CHECK(optimized[2].op == primec::IrOpcode::AddI32);
+  CHECK(optimized[3].op == primec::IrOpcode::ReturnI32);
+  const auto *deadStores = findIrOptimizationPass(report, "dead-store-elimination");
+  const auto *redundant = findIrOptimizationPass(report, "redundant-load-store-elimination");
+  REQUIRE(deadStores != nullptr);
+  REQUIRE(redundant != nullptr);
+  CHECK(deadStores->instructionsRemoved > 0u);
+  CHECK(redundant->instructionsRemoved > 0u);
+
+  uint64_t optimizedResult = 0;
+  REQUIRE(vm.execute(module, optimizedResult, error, 2));
+  CHECK(optimizedResult == baselineResult);
+}
+
+TEST_CASE("ir optimizer leaves pointer-reachable locals and unsafe folds alone") {
+  primec::IrModule module;
+  module.entryIndex = 0;
+  primec::IrFunction mainFn;
+  mainFn.name = "/main";
+  mainFn.instructions = {
+      {primec::IrOpcode::PushI32, 4},
+      {primec::IrOpcode::StoreLocal, 0},
+      {primec::IrOpcode::PushI32, 5},
+      {primec::IrOpcode::StoreLocal, 1},
+      {primec::IrOpcode::AddressOfLocal, 1},
+      {primec::IrOpcode::PushI32, 9},
+      {primec::IrOpcode::StoreIndirect, 0},
+      {primec::IrOpcode::Pop, 0},
+      {primec::IrOpcode::LoadLocal, 1},
+      {primec::IrOpcode::PushI64, 0},
+      {primec::IrOpcode::LoadIndirect, 0},
+      {primec::IrOpcode::AddI32, 0},
+      {primec::IrOpcode::PushI32, static_cast<uint64_t>(std::numeric_limits<int32_t>::max())},
+      {primec::IrOpcode::PushI32, 1},
+      {primec::IrOpcode::AddI32, 0},
+      {primec::IrOpcode::PushArgc, 0},
+      {primec::IrOpcode::JumpIfZero, 21},
+      {primec::IrOpcode::PushI32, 7},
+      {primec::IrOpcode::PushI32, 0},
+      {primec::IrOpcode::DivI32, 0},
+      {primec::IrOpcode::Pop, 0},
+      {primec::IrOpcode::Pop, 0},
+      {primec::IrOpcode::ReturnI32, 0},
+  };
+  module.functions.push_back(mainFn);
+
+  primec::Vm vm;
+  std::string error;
+  uint64_t baselineResult = 0;
+  REQUIRE(vm.execute(module, baselineResult, error));
+  CHECK(baselineResult == 13u);
+
+  primec::IrOptimizationReport report;
+  REQUIRE(primec::optimizeIrModule(module, 2, report, error));
+  REQUIRE(primec::validateIrModule(module, primec::IrValidationTarget::Vm, error));
+  const primec::IrFunction &optimized = module.functions[0];
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::AddressOfLocal) == 1u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::StoreLocal) == 2u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::LoadLocal) == 1u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::LoadIndirect) == 1u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::AddI32) == 2u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::DivI32) == 1u);
+  CHECK(countIrOpcode(optimized, primec::IrOpcode::JumpIfZero) == 1u);
+
+  uint64_t optimizedResult = 0;
+  REQUIRE(vm.execute(module, optimizedResult, error));
+  CHECK(optimizedResult == baselineResult);
+}
+
+TEST_CASE("ir optimizer level zero leaves the module untouched") {
+  primec::IrModule module;
+  module.entryIndex = 0;
+  primec::IrFunction mainFn;
+  mainFn.name = "/main";
+  mainFn.instructions = {
+      {primec::IrOpcode::PushI32, 2},
+      {primec::IrOpcode::PushI32, 3},
+      {primec::IrOpcode::AddI32, 0},
+      {primec::IrOpcode::ReturnI32, 0},
+  };
+  module.functions.push_back(mainFn);
+
+  std::string error;
+  primec::IrOptimizationReport report;
+  REQUIRE(primec::optimizeIrModule(module, 0, report, error));
+  CHECK(report.rounds == 0u);
+  CHECK(report.passes.empty());
+  CHECK(report.instructionsBefore == 4u);
+  CHECK(report.instructionsAfter == 4u);
+  CHECK(module.functions[0].instructions.size() == 4u);
+}
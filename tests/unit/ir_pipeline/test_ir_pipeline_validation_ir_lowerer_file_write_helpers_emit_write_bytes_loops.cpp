@@ -2,13 +2,11 @@
 
 TEST_SUITE_BEGIN("primestruct.ir.pipeline.validation");
 
-TEST_CASE("ir lowerer file write helpers emit write-bytes loops") {
+TEST_CASE("ir lowerer file write helpers emit byte-range opcodes") {
   std::vector<primec::IrInstruction> instructions;
   auto emitInstruction = [&](primec::IrOpcode op, uint64_t imm) {
     instructions.push_back({op, imm});
   };
-  auto getInstructionCount = [&]() { return instructions.size(); };
-  auto patchInstructionImm = [&](size_t index, int32_t imm) { instructions.at(index).imm = imm; };
 
   primec::Expr bytesExpr;
   bytesExpr.kind = primec::Expr::Kind::Name;
@@ -16,44 +14,55 @@ TEST_CASE("ir lowerer file write helpers emit write-bytes loops") {
 
   int nextLocal = 10;
   int emitExprCalls = 0;
-  CHECK(primec::ir_lowerer::emitFileWriteBytesLoop(
+  CHECK(primec::ir_lowerer::emitFileBytesRange(
       bytesExpr,
       3,
+      primec::IrOpcode::FileWriteBytes,
       [&](const primec::Expr &) {
         emitExprCalls++;
         emitInstruction(primec::IrOpcode::PushI64, 55);
         return true;
       },
       [&]() { return nextLocal++; },
-      emitInstruction,
-      getInstructionCount,
-      patchInstructionImm));
+      emitInstruction));
   CHECK(emitExprCalls == 1);
-  REQUIRE(instructions.size() == 34);
+  REQUIRE(instructions.size() == 9);
   CHECK(instructions[0].op == primec::IrOpcode::PushI64);
   CHECK(instructions[1].op == primec::IrOpcode::StoreLocal);
   CHECK(instructions[1].imm == 10);
-  CHECK(instructions[12].op == primec::IrOpcode::JumpIfZero);
-  CHECK(instructions[12].imm == 33);
-  CHECK(instructions[16].op == primec::IrOpcode::JumpIfZero);
-  CHECK(instructions[16].imm == 33);
-  CHECK(instructions[17].op == primec::IrOpcode::LoadLocal);
-  CHECK(instructions[17].imm == 3);
-  CHECK(instructions[32].op == primec::IrOpcode::Jump);
-  CHECK(instructions[32].imm == 9);
-  CHECK(instructions[33].op == primec::IrOpcode::LoadLocal);
-  CHECK(instructions[33].imm == 13);
+  CHECK(instructions[2].op == primec::IrOpcode::LoadLocal);
+  CHECK(instructions[2].imm == 3);
+  CHECK(instructions[4].op == primec::IrOpcode::PushI64);
+  CHECK(instructions[4].imm == primec::IrSlotBytes);
+  CHECK(instructions[7].op == primec::IrOpcode::LoadIndirect);
+  CHECK(instructions[8].op == primec::IrOpcode::FileWriteBytes);
+
+  instructions.clear();
+  nextLocal = 20;
+  CHECK(primec::ir_lowerer::emitFileBytesRange(
+      bytesExpr,
+      4,
+      primec::IrOpcode::FileReadBytes,
+      [&](const primec::Expr &) {
+        emitInstruction(primec::IrOpcode::LoadLocal, 7);
+        return true;
+      },
+      [&]() { return nextLocal++; },
+      emitInstruction));
+  REQUIRE(instructions.size() == 9);
+  CHECK(instructions[1].imm == 20);
+  CHECK(instructions[2].imm == 4);
+  CHECK(instructions[8].op == primec::IrOpcode::FileReadBytes);
 
   instructions.clear();
   nextLocal = 40;
-  CHECK_FALSE(primec::ir_lowerer::emitFileWriteBytesLoop(
+  CHECK_FALSE(primec::ir_lowerer::emitFileBytesRange(
       bytesExpr,
       7,
+      primec::IrOpcode::FileWriteBytes,
       [](const primec::Expr &) { return false; },
       [&]() { return nextLocal++; },
-      emitInstruction,
-      getInstructionCount,
-      patchInstructionImm));
+      emitInstruction));
   CHECK(instructions.empty());
 }
 
@@ -793,8 +793,6 @@ TEST_CASE("ir lowerer file write helpers emit write_bytes calls") {
   auto emitInstruction = [&](primec::IrOpcode op, uint64_t imm) {
     instructions.push_back({op, imm});
   };
-  auto getInstructionCount = [&]() { return instructions.size(); };
-  auto patchInstructionImm = [&](size_t index, int32_t imm) { instructions.at(index).imm = imm; };
 
   primec::Expr receiver;
   receiver.kind = primec::Expr::Kind::Name;
@@ -821,17 +819,14 @@ TEST_CASE("ir lowerer file write helpers emit write_bytes calls") {
       },
       [&]() { return nextLocal++; },
       emitInstruction,
-      getInstructionCount,
-      patchInstructionImm,
       error));
   CHECK(error.empty());
   CHECK(emitExprCalls == 1);
-  REQUIRE(instructions.size() == 34);
+  REQUIRE(instructions.size() == 9);
   CHECK(instructions[0].op == primec::IrOpcode::PushI64);
   CHECK(instructions[1].op == primec::IrOpcode::StoreLocal);
   CHECK(instructions[1].imm == 50);
-  CHECK(instructions[33].op == primec::IrOpcode::LoadLocal);
-  CHECK(instructions[33].imm == 53);
+  CHECK(instructions[8].op == primec::IrOpcode::FileWriteBytes);
 
   instructions.clear();
   error.clear();
@@ -843,8 +838,6 @@ TEST_CASE("ir lowerer file write helpers emit write_bytes calls") {
       [](const primec::Expr &) { return true; },
       [&]() { return 0; },
       emitInstruction,
-      getInstructionCount,
-      patchInstructionImm,
       error));
   CHECK(error == "write_bytes requires exactly one argument");
   CHECK(instructions.empty());
@@ -862,13 +855,129 @@ TEST_CASE("ir lowerer file write helpers emit write_bytes calls") {
       },
       [&]() { return nextLocal++; },
       emitInstruction,
-      getInstructionCount,
-      patchInstructionImm,
       error));
   CHECK(emitExprCalls == 1);
   CHECK(error.empty());
   CHECK(instructions.empty());
 }
 
+TEST_CASE("ir lowerer file write helpers emit read_bytes calls") {
+  std::vector<primec::IrInstruction> instructions;
+  auto emitInstruction = [&](primec::IrOpcode op, uint64_t imm) {
+    instructions.push_back({op, imm});
+  };
+
+  primec::ir_lowerer::LocalMap locals;
+  primec::ir_lowerer::LocalInfo bufferInfo;
+  bufferInfo.index = 9;
+  bufferInfo.kind = primec::ir_lowerer::LocalInfo::Kind::Array;
+  bufferInfo.isMutable = true;
+  locals.emplace("buffer", bufferInfo);
+
+  primec::Expr receiver;
+  receiver.kind = primec::Expr::Kind::Name;
+  receiver.name = "file";
+  primec::Expr bufferArg;
+  bufferArg.kind = primec::Expr::Kind::Name;
+  bufferArg.name = "buffer";
+
+  primec::Expr readBytesExpr;
+  readBytesExpr.kind = primec::Expr::Kind::Call;
+  readBytesExpr.name = "read_bytes";
+  readBytesExpr.args = {receiver, bufferArg};
+
+  int nextLocal = 30;
+  std::string error;
+  CHECK(primec::ir_lowerer::emitFileReadBytesCall(
+      readBytesExpr,
+      locals,
+      5,
+      [&](const primec::Expr &) {
+        emitInstruction(primec::IrOpcode::LoadLocal, 9);
+        return true;
+      },
+      [&]() { return nextLocal++; },
+      emitInstruction,
+      error));
+  CHECK(error.empty());
+  REQUIRE(instructions.size() == 9);
+  CHECK(instructions[1].imm == 30);
+  CHECK(instructions[2].imm == 5);
+  CHECK(instructions[8].op == primec::IrOpcode::FileReadBytes);
+
+  instructions.clear();
+  locals["buffer"].isMutable = false;
+  CHECK_FALSE(primec::ir_lowerer::emitFileReadBytesCall(
+      readBytesExpr,
+      locals,
+      5,
+      [](const primec::Expr &) { return true; },
+      [&]() { return nextLocal++; },
+      emitInstruction,
+      error));
+  CHECK(error == "read_bytes requires mutable array binding");
+  CHECK(instructions.empty());
+
+  error.clear();
+  locals["buffer"].isMutable = true;
+  locals["buffer"].kind = primec::ir_lowerer::LocalInfo::Kind::Value;
+  CHECK_FALSE(primec::ir_lowerer::emitFileReadBytesCall(
+      readBytesExpr,
+      locals,
+      5,
+      [](const primec::Expr &) { return true; },
+      [&]() { return nextLocal++; },
+      emitInstruction,
+      error));
+  CHECK(error == "read_bytes requires mutable array binding");
+  CHECK(instructions.empty());
+}
+
+TEST_CASE("ir lowerer file write helpers emit map_bytes calls") {
+  std::vector<primec::IrInstruction> instructions;
+  auto emitInstruction = [&](primec::IrOpcode op, uint64_t imm) {
+    instructions.push_back({op, imm});
+  };
+
+  primec::ir_lowerer::LocalMap locals;
+  primec::ir_lowerer::LocalInfo bufferInfo;
+  bufferInfo.index = 9;
+  bufferInfo.kind = primec::ir_lowerer::LocalInfo::Kind::Array;
+  bufferInfo.isMutable = true;
+  locals.emplace("buffer", bufferInfo);
+
+  primec::Expr receiver;
+  receiver.kind = primec::Expr::Kind::Name;
+  receiver.name = "file";
+  primec::Expr bufferArg;
+  bufferArg.kind = primec::Expr::Kind::Name;
+  bufferArg.name = "buffer";
+
+  primec::Expr mapBytesExpr;
+  mapBytesExpr.kind = primec::Expr::Kind::Call;
+  mapBytesExpr.name = "map_bytes";
+  mapBytesExpr.args = {receiver, bufferArg};
+
+  std::string error;
+  CHECK(primec::ir_lowerer::emitFileMapBytesCall(mapBytesExpr, locals, 5, emitInstruction, error));
+  CHECK(error.empty());
+  REQUIRE(instructions.size() == 2);
+  CHECK(instructions[0].op == primec::IrOpcode::LoadLocal);
+  CHECK(instructions[0].imm == 5);
+  CHECK(instructions[1].op == primec::IrOpcode::FileMapBytes);
+  CHECK(instructions[1].imm == 9);
+
+  instructions.clear();
+  locals["buffer"].isMutable = false;
+  CHECK_FALSE(primec::ir_lowerer::emitFileMapBytesCall(mapBytesExpr, locals, 5, emitInstruction, error));
+  CHECK(error == "map_bytes requires mutable array binding");
+  CHECK(instructions.empty());
+
+  error.clear();
+  mapBytesExpr.args = {receiver};
+  CHECK_FALSE(primec::ir_lowerer::emitFileMapBytesCall(mapBytesExpr, locals, 5, emitInstruction, error));
+  CHECK(error == "map_bytes requires exactly one argument");
+  CHECK(instructions.empty());
+}
 
 TEST_SUITE_END();
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -21,7 +22,7 @@ public:
   std::size_t maxCallDepth() const override { return 32; }
 
   bool resolveIndirectAddress(std::uint64_t address,
-                              std::vector<std::uint64_t> &locals,
+                              std::span<std::uint64_t> locals,
                               std::uint64_t *&slot,
                               std::string &error) override {
     const std::uint64_t slotIndex = address / slotBytes();
@@ -73,7 +74,7 @@ public:
   bool handleFileInstruction(const primec::IrModule &module,
                              const primec::IrInstruction &inst,
                              std::vector<std::uint64_t> &stack,
-                             std::vector<std::uint64_t> &locals,
+                             std::span<std::uint64_t> locals,
                              std::string &error) override {
     (void)module;
     (void)inst;
@@ -182,6 +183,44 @@ TEST_CASE("vm execution kernel keeps argv and local memory behind host boundary"
   CHECK(result == 7);
 }
 
+TEST_CASE("vm execution kernel gives each call its own local slot window") {
+  primec::IrFunction entry;
+  entry.name = "/main";
+  entry.instructions = {
+      inst(primec::IrOpcode::PushI32, 5),
+      inst(primec::IrOpcode::StoreLocal, 0),
+      inst(primec::IrOpcode::PushI32, 3),
+      inst(primec::IrOpcode::Call, 1),
+      inst(primec::IrOpcode::LoadLocal, 0),
+      inst(primec::IrOpcode::AddI32),
+      inst(primec::IrOpcode::ReturnI32),
+  };
+
+  primec::IrFunction callee;
+  callee.name = "/callee";
+  callee.instructions = {
+      inst(primec::IrOpcode::StoreLocal, 1),
+      inst(primec::IrOpcode::PushI32, 9),
+      inst(primec::IrOpcode::StoreLocal, 0),
+      inst(primec::IrOpcode::AddressOfLocal, 1),
+      inst(primec::IrOpcode::LoadIndirect),
+      inst(primec::IrOpcode::LoadLocal, 0),
+      inst(primec::IrOpcode::AddI32),
+      inst(primec::IrOpcode::ReturnI32),
+  };
+
+  primec::IrModule module;
+  module.entryIndex = 0;
+  module.functions = {entry, callee};
+
+  TestVmKernelHost host;
+  std::uint64_t result = 0;
+  std::string error;
+  CHECK(primec::vm_detail::executeVmKernel(module, host, result, error));
+  CHECK(result == 17);
+  CHECK(error.empty());
+}
+
 TEST_CASE("vm execution kernel exposes file opcode host boundary") {
   CHECK(primec::vm_detail::isVmKernelFileOpcode(primec::IrOpcode::FileFlush));
   CHECK_FALSE(primec::vm_detail::isVmKernelFileOpcode(primec::IrOpcode::PushI32));
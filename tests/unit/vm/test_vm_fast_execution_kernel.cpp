@@ -0,0 +1,256 @@
+#include "primec/VmExecutionKernel.h"
+#include "primec/VmFastExecutionKernel.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "third_party/doctest.h"
+
+TEST_SUITE_BEGIN("primestruct.vm.execution.fast_kernel");
+
+namespace {
+
+class FastTestVmKernelHost final : public primec::vm_detail::VmKernelHost {
+public:
+  std::uint64_t argumentCount() const override { return argCount; }
+  std::uint64_t slotBytes() const override { return primec::IrSlotBytes; }
+  std::size_t maxCallDepth() const override { return 32; }
+
+  bool resolveIndirectAddress(std::uint64_t address,
+                              std::span<std::uint64_t> locals,
+                              std::uint64_t *&slot,
+                              std::string &error) override {
+    const std::uint64_t slotIndex = address / slotBytes();
+    if (address % slotBytes() != 0 || slotIndex >= locals.size()) {
+      error = "test host invalid indirect address";
+      return false;
+    }
+    slot = &locals[static_cast<std::size_t>(slotIndex)];
+    return true;
+  }
+
+  bool allocateHeapSlots(std::uint64_t, std::uint64_t &, std::string &error) override {
+    error = "test host denies heap allocation";
+    return false;
+  }
+
+  bool freeHeapSlots(std::uint64_t, std::string &error) override {
+    error = "test host denies heap free";
+    return false;
+  }
+
+  bool reallocHeapSlots(std::uint64_t, std::uint64_t, std::uint64_t &, std::string &error) override {
+    error = "test host denies heap realloc";
+    return false;
+  }
+
+  bool handlePrintInstruction(const primec::IrModule &,
+                              const primec::IrInstruction &inst,
+                              std::vector<std::uint64_t> &stack,
+                              std::string &error) override {
+    if (inst.op != primec::IrOpcode::PrintI32 || stack.empty()) {
+      error = "test host denies print";
+      return false;
+    }
+    printed.push_back(stack.back());
+    stack.pop_back();
+    return true;
+  }
+
+  bool handleFileInstruction(const primec::IrModule &,
+                             const primec::IrInstruction &,
+                             std::vector<std::uint64_t> &,
+                             std::span<std::uint64_t>,
+                             std::string &error) override {
+    error = "test host denies file";
+    return false;
+  }
+
+  std::uint64_t argCount = 0;
+  std::vector<std::uint64_t> printed;
+};
+
+primec::IrInstruction inst(primec::IrOpcode op, std::uint64_t imm = 0) {
+  primec::IrInstruction instruction;
+  instruction.op = op;
+  instruction.imm = imm;
+  return instruction;
+}
+
+primec::IrModule makeModule(std::vector<primec::IrFunction> functions) {
+  primec::IrModule module;
+  module.entryIndex = 0;
+  module.functions = std::move(functions);
+  return module;
+}
+
+primec::IrFunction makeFunction(std::string name, std::vector<primec::IrInstruction> instructions) {
+  primec::IrFunction function;
+  function.name = std::move(name);
+  function.instructions = std::move(instructions);
+  return function;
+}
+
+primec::IrModule makeRecursiveFibModule(std::int32_t n) {
+  using primec::IrOpcode;
+  return makeModule({
+      makeFunction("/main",
+                   {
+                       inst(IrOpcode::PushI32, static_cast<std::uint64_t>(n)),
+                       inst(IrOpcode::Call, 1),
+                       inst(IrOpcode::Dup),
+                       inst(IrOpcode::PrintI32),
+                       inst(IrOpcode::ReturnI32),
+                   }),
+      makeFunction("/fib",
+                   {
+                       inst(IrOpcode::StoreLocal, 0),
+                       inst(IrOpcode::LoadLocal, 0),
+                       inst(IrOpcode::PushI32, 2),
+                       inst(IrOpcode::CmpLtI32),
+                       inst(IrOpcode::JumpIfZero, 7),
+                       inst(IrOpcode::LoadLocal, 0),
+                       inst(IrOpcode::ReturnI32),
+                       inst(IrOpcode::LoadLocal, 0),
+                       inst(IrOpcode::PushI32, 1),
+                       inst(IrOpcode::SubI32),
+                       inst(IrOpcode::Call, 1),
+                       inst(IrOpcode::LoadLocal, 0),
+                       inst(IrOpcode::PushI32, 2),
+                       inst(IrOpcode::SubI32),
+                       inst(IrOpcode::Call, 1),
+                       inst(IrOpcode::AddI32),
+                       inst(IrOpcode::ReturnI32),
+                   }),
+  });
+}
+
+struct EngineRun {
+  bool ok = false;
+  std::uint64_t result = 0;
+  std::string error;
+  std::vector<std::uint64_t> printed;
+};
+
+EngineRun runEngine(const primec::IrModule &module, bool fast, std::uint64_t argCount = 0) {
+  FastTestVmKernelHost host;
+  host.argCount = argCount;
+  EngineRun run;
+  run.ok = fast ? primec::vm_detail::executeVmFastKernel(module, host, run.result, run.error)
+                : primec::vm_detail::executeVmKernel(module, host, run.result, run.error);
+  run.printed = host.printed;
+  return run;
+}
+
+void checkEngineParity(const primec::IrModule &module, std::uint64_t argCount = 0) {
+  const EngineRun checked = runEngine(module, false, argCount);
+  const EngineRun fast = runEngine(module, true, argCount);
+  CHECK(fast.ok == checked.ok);
+  CHECK(fast.result == checked.result);
+  CHECK(fast.error == checked.error);
+  CHECK(fast.printed == checked.printed);
+}
+
+} // namespace
+
+TEST_CASE("vm fast kernel verifies recursive calls and matches checked kernel") {
+  const primec::IrModule module = makeRecursiveFibModule(15);
+  std::vector<primec::vm_detail::VmFastFunctionSignature> signatures;
+  std::string reason;
+  REQUIRE(primec::vm_detail::verifyVmFastKernelModule(module, signatures, reason));
+  CHECK(reason.empty());
+  REQUIRE(signatures.size() == 2);
+  CHECK(signatures[1].returns);
+  CHECK(signatures[1].minHeight == -1);
+  CHECK(signatures[1].netHeight == -1);
+
+  const EngineRun fast = runEngine(module, true);
+  CHECK(fast.ok);
+  CHECK(fast.result == 610);
+  CHECK(fast.printed == std::vector<std::uint64_t>{610});
+  checkEngineParity(module);
+}
+
+TEST_CASE("vm fast kernel folds argc and local addresses at decode time") {
+  using primec::IrOpcode;
+  const primec::IrModule module = makeModule({makeFunction("/main",
+                                                           {
+                                                               inst(IrOpcode::PushArgc),
+                                                               inst(IrOpcode::StoreLocal, 1),
+                                                               inst(IrOpcode::AddressOfLocal, 1),
+                                                               inst(IrOpcode::LoadIndirect),
+                                                               inst(IrOpcode::PushF64, 0x4000000000000000ull),
+                                                               inst(IrOpcode::ConvertF64ToI32),
+                                                               inst(IrOpcode::MulI32),
+                                                               inst(IrOpcode::ReturnI32),
+                                                           })});
+  const EngineRun fast = runEngine(module, true, 7);
+  CHECK(fast.ok);
+  CHECK(fast.result == 14);
+  checkEngineParity(module, 7);
+}
+
+TEST_CASE("vm fast kernel falls back to checked kernel when verification fails") {
+  using primec::IrOpcode;
+  const primec::IrModule underflow =
+      makeModule({makeFunction("/main", {inst(IrOpcode::AddI32), inst(IrOpcode::ReturnI32)})});
+  std::vector<primec::vm_detail::VmFastFunctionSignature> signatures;
+  std::string reason;
+  CHECK_FALSE(primec::vm_detail::verifyVmFastKernelModule(underflow, signatures, reason));
+  CHECK(reason.find("pops below") != std::string::npos);
+  checkEngineParity(underflow);
+
+  const primec::IrModule fallsOff =
+      makeModule({makeFunction("/main", {inst(IrOpcode::PushI32, 1), inst(IrOpcode::JumpIfZero, 2)})});
+  CHECK_FALSE(primec::vm_detail::verifyVmFastKernelModule(fallsOff, signatures, reason));
+  const EngineRun fast = runEngine(fallsOff, true);
+  CHECK_FALSE(fast.ok);
+  CHECK(fast.error == "missing return in IR");
+  checkEngineParity(fallsOff);
+}
+
+TEST_CASE("vm fast kernel keeps runtime diagnostics of checked kernel") {
+  using primec::IrOpcode;
+  const primec::IrModule divideByZero = makeModule({makeFunction("/main",
+                                                                 {
+                                                                     inst(IrOpcode::PushI32, 1),
+                                                                     inst(IrOpcode::PushI32, 0),
+                                                                     inst(IrOpcode::DivI32),
+                                                                     inst(IrOpcode::ReturnI32),
+                                                                 })});
+  const EngineRun divide = runEngine(divideByZero, true);
+  CHECK_FALSE(divide.ok);
+  CHECK(divide.error == "division by zero in IR");
+  checkEngineParity(divideByZero);
+
+  const primec::IrModule unboundedRecursion = makeModule({makeFunction("/main",
+                                                                       {
+                                                                           inst(IrOpcode::PushArgc),
+                                                                           inst(IrOpcode::JumpIfZero, 3),
+                                                                           inst(IrOpcode::ReturnVoid),
+                                                                           inst(IrOpcode::CallVoid, 0),
+                                                                           inst(IrOpcode::ReturnVoid),
+                                                                       })});
+  std::vector<primec::vm_detail::VmFastFunctionSignature> signatures;
+  std::string reason;
+  CHECK(primec::vm_detail::verifyVmFastKernelModule(unboundedRecursion, signatures, reason));
+  const EngineRun overflow = runEngine(unboundedRecursion, true);
+  CHECK_FALSE(overflow.ok);
+  CHECK(overflow.error == "VM call stack overflow");
+  checkEngineParity(unboundedRecursion);
+
+  const primec::IrModule deniedPrint = makeModule({makeFunction("/main",
+                                                                {
+                                                                    inst(IrOpcode::PushI64, 3),
+                                                                    inst(IrOpcode::PrintI64),
+                                                                    inst(IrOpcode::ReturnVoid),
+                                                                })});
+  const EngineRun print = runEngine(deniedPrint, true);
+  CHECK_FALSE(print.ok);
+  CHECK(print.error == "test host denies print");
+  checkEngineParity(deniedPrint);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,135 @@
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+#include "third_party/doctest.h"
+
+#include "primec/Ir.h"
+#include "primec/VmFileBuffers.h"
+#include "primec/testing/TestScratch.h"
+
+TEST_SUITE_BEGIN("primestruct.vm.file_buffers");
+
+namespace {
+std::filesystem::path vmFileBuffersPath(const std::string &relativePath) {
+  return primec::testing::testScratchPath("vm_file_buffers/" + relativePath);
+}
+
+std::string readFileText(const std::filesystem::path &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+} // namespace
+
+TEST_CASE("vm file buffers hold writes until flush or close") {
+  const std::filesystem::path path = vmFileBuffersPath("write.txt");
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  REQUIRE(fd >= 0);
+  primec::VmFileBuffers files;
+  files.track(fd, true);
+  CHECK(files.write(fd, "ab", 2) == 0u);
+  CHECK(readFileText(path).empty());
+  CHECK(files.flush(fd) == 0u);
+  CHECK(readFileText(path) == "ab");
+
+  const std::string large(primec::VmFileBuffers::BufferBytes + 3, 'x');
+  CHECK(files.write(fd, "c", 1) == 0u);
+  CHECK(files.write(fd, large.data(), large.size()) == 0u);
+  CHECK(readFileText(path) == "abc" + large);
+  CHECK(files.write(fd, "d", 1) == 0u);
+  CHECK(files.close(fd) == 0u);
+  CHECK(readFileText(path) == "abc" + large + "d");
+}
+
+TEST_CASE("vm file buffers read bytes in blocks and keep eof and error codes") {
+  const std::filesystem::path path = vmFileBuffersPath("read.txt");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "hi";
+  }
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  REQUIRE(fd >= 0);
+  primec::VmFileBuffers files;
+  files.track(fd, false);
+  uint8_t value = 0;
+  CHECK(files.readByte(fd, value) == 0u);
+  CHECK(value == 'h');
+  CHECK(files.readByte(fd, value) == 0u);
+  CHECK(value == 'i');
+  CHECK(files.readByte(fd, value) == primec::FileReadEofCode);
+  CHECK(files.close(fd) == 0u);
+
+  CHECK(files.readByte(fd, value) == static_cast<uint32_t>(EBADF));
+  CHECK(files.write(fd, "x", 1) == static_cast<uint32_t>(EBADF));
+  CHECK(files.close(fd) == static_cast<uint32_t>(EBADF));
+}
+
+TEST_CASE("vm file buffers read byte ranges across the buffer boundary") {
+  const std::filesystem::path path = vmFileBuffersPath("read_range.txt");
+  std::string expected;
+  for (size_t i = 0; i < primec::VmFileBuffers::BufferBytes * 2 + 5; ++i) {
+    expected.push_back(static_cast<char>('a' + (i % 26)));
+  }
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << expected;
+  }
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  REQUIRE(fd >= 0);
+  primec::VmFileBuffers files;
+  files.track(fd, false);
+  uint8_t first = 0;
+  CHECK(files.readByte(fd, first) == 0u);
+  CHECK(first == 'a');
+
+  std::string rest(expected.size() - 1, '\0');
+  size_t readCount = 0;
+  CHECK(files.read(fd, reinterpret_cast<uint8_t *>(rest.data()), rest.size(), readCount) == 0u);
+  CHECK(readCount == rest.size());
+  CHECK(rest == expected.substr(1));
+
+  uint8_t tail[4] = {};
+  CHECK(files.read(fd, tail, sizeof(tail), readCount) == primec::FileReadEofCode);
+  CHECK(readCount == 0u);
+  CHECK(files.close(fd) == 0u);
+}
+
+TEST_CASE("vm file buffers map files as read-only byte array views") {
+  const std::filesystem::path path = vmFileBuffersPath("map.txt");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "map";
+  }
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  REQUIRE(fd >= 0);
+  primec::VmFileBuffers files;
+  files.track(fd, false);
+  uint64_t address = 0;
+  CHECK(files.map(fd, primec::IrSlotBytes, address) == 0u);
+  CHECK(primec::VmFileBuffers::isMappedAddress(address));
+  uint64_t value = 0;
+  CHECK(files.loadMapped(address, primec::IrSlotBytes, value));
+  CHECK(value == 3u);
+  CHECK(files.loadMapped(address + 2 * primec::IrSlotBytes, primec::IrSlotBytes, value));
+  CHECK(value == static_cast<uint64_t>('a'));
+  CHECK_FALSE(files.loadMapped(address + 4 * primec::IrSlotBytes, primec::IrSlotBytes, value));
+  const uint8_t *bytes = files.mappedBytes(address + primec::IrSlotBytes, primec::IrSlotBytes, 3);
+  REQUIRE(bytes != nullptr);
+  CHECK(std::string(reinterpret_cast<const char *>(bytes), 3) == "map");
+  CHECK(files.mappedBytes(address + primec::IrSlotBytes, primec::IrSlotBytes, 4) == nullptr);
+  CHECK(files.mappedBytes(address, primec::IrSlotBytes, 1) == nullptr);
+  CHECK(files.close(fd) == 0u);
+  CHECK(files.loadMapped(address + primec::IrSlotBytes, primec::IrSlotBytes, value));
+  CHECK(value == static_cast<uint64_t>('m'));
+
+  files.clear();
+  CHECK_FALSE(files.loadMapped(address, primec::IrSlotBytes, value));
+  CHECK(files.map(fd, primec::IrSlotBytes, address) == static_cast<uint32_t>(EBADF));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,114 @@
+#include "primec/VmHeap.h"
+
+#include <cstdint>
+#include <string>
+
+#include "third_party/doctest.h"
+
+TEST_SUITE_BEGIN("primestruct.vm.heap");
+
+namespace {
+
+constexpr std::uint64_t kSlotBytes = 16;
+
+std::uint64_t allocateOrFail(primec::VmHeap &heap, std::uint64_t slotCount) {
+  std::uint64_t address = 0;
+  std::string error;
+  REQUIRE(heap.allocate(slotCount, kSlotBytes, address, error));
+  CHECK(error.empty());
+  return address;
+}
+
+} // namespace
+
+TEST_CASE("vm heap reuses freed size-class blocks") {
+  primec::VmHeap heap;
+  const std::uint64_t first = allocateOrFail(heap, 3);
+  const std::uint64_t second = allocateOrFail(heap, 4);
+  CHECK((first & primec::VmHeap::AddressTag) != 0);
+  CHECK(second != first);
+  const std::size_t reservedAfterFirstPage = heap.reservedSlots();
+  CHECK(reservedAfterFirstPage == primec::VmHeap::PageSlots);
+
+  std::string error;
+  *heap.resolve(first, kSlotBytes) = 42;
+  REQUIRE(heap.free(first, kSlotBytes, error));
+  CHECK(heap.resolve(first, kSlotBytes) == nullptr);
+  CHECK_FALSE(heap.free(first, kSlotBytes, error));
+  CHECK(error == "invalid heap free address in IR: " + std::to_string(first));
+
+  const std::uint64_t reused = allocateOrFail(heap, 4);
+  CHECK(reused == first);
+  CHECK(*heap.resolve(reused, kSlotBytes) == 0);
+  CHECK(heap.reservedSlots() == reservedAfterFirstPage);
+  CHECK(heap.stats().allocationCount == 3);
+  CHECK(heap.stats().reusedAllocationCount == 1);
+  CHECK(heap.stats().reuseRate() == doctest::Approx(1.0 / 3.0));
+}
+
+TEST_CASE("vm heap bounds checks against the requested slot count") {
+  primec::VmHeap heap;
+  const std::uint64_t small = allocateOrFail(heap, 3);
+  CHECK(heap.resolve(small + 2 * kSlotBytes, kSlotBytes) != nullptr);
+  CHECK(heap.resolve(small + 3 * kSlotBytes, kSlotBytes) == nullptr);
+
+  const std::uint64_t large = allocateOrFail(heap, primec::VmHeap::PageSlots + 5);
+  CHECK(heap.resolve(large + (primec::VmHeap::PageSlots + 4) * kSlotBytes, kSlotBytes) != nullptr);
+  CHECK(heap.resolve(large + (primec::VmHeap::PageSlots + 5) * kSlotBytes, kSlotBytes) == nullptr);
+  CHECK(heap.resolve(primec::VmHeap::AddressTag + heap.reservedSlots() * kSlotBytes, kSlotBytes) == nullptr);
+
+  std::string error;
+  CHECK_FALSE(heap.free(large + kSlotBytes, kSlotBytes, error));
+  CHECK(error == "invalid heap free address in IR: " + std::to_string(large + kSlotBytes));
+}
+
+TEST_CASE("vm heap coalesces freed large runs") {
+  primec::VmHeap heap;
+  const std::uint64_t pin = allocateOrFail(heap, 1);
+  const std::uint64_t left = allocateOrFail(heap, primec::VmHeap::PageSlots);
+  const std::uint64_t right = allocateOrFail(heap, primec::VmHeap::PageSlots * 2);
+  const std::uint64_t top = allocateOrFail(heap, 100);
+  const std::size_t reserved = heap.reservedSlots();
+
+  std::string error;
+  REQUIRE(heap.free(left, kSlotBytes, error));
+  REQUIRE(heap.free(right, kSlotBytes, error));
+  const std::uint64_t merged = allocateOrFail(heap, primec::VmHeap::PageSlots * 3);
+  CHECK(merged == left);
+  CHECK(heap.reservedSlots() == reserved);
+  CHECK(heap.stats().reusedAllocationCount == 1);
+
+  REQUIRE(heap.free(merged, kSlotBytes, error));
+  REQUIRE(heap.free(top, kSlotBytes, error));
+  REQUIRE(heap.free(pin, kSlotBytes, error));
+  CHECK(heap.stats().liveBytes == 0);
+  CHECK(heap.stats().peakBytes == (101 + primec::VmHeap::PageSlots * 3) * kSlotBytes);
+}
+
+TEST_CASE("vm heap reallocates in place within block capacity") {
+  primec::VmHeap heap;
+  const std::uint64_t address = allocateOrFail(heap, 5);
+  *heap.resolve(address, kSlotBytes) = 7;
+
+  std::string error;
+  std::uint64_t grown = 0;
+  REQUIRE(heap.reallocate(address, 8, kSlotBytes, grown, error));
+  CHECK(grown == address);
+  CHECK(*heap.resolve(grown, kSlotBytes) == 7);
+  CHECK(*heap.resolve(grown + 7 * kSlotBytes, kSlotBytes) == 0);
+
+  std::uint64_t moved = 0;
+  REQUIRE(heap.reallocate(grown, 9, kSlotBytes, moved, error));
+  CHECK(moved != grown);
+  CHECK(*heap.resolve(moved, kSlotBytes) == 7);
+  CHECK(heap.resolve(grown, kSlotBytes) == nullptr);
+  CHECK(heap.stats().liveBytes == 9 * kSlotBytes);
+
+  std::uint64_t released = 1;
+  REQUIRE(heap.reallocate(moved, 0, kSlotBytes, released, error));
+  CHECK(released == 0);
+  CHECK_FALSE(heap.reallocate(moved, 4, kSlotBytes, released, error));
+  CHECK(error == "invalid heap realloc address in IR: " + std::to_string(moved));
+}
+
+TEST_SUITE_END();